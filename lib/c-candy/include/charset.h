@@ -0,0 +1,129 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/charset.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef CHARSET_H
+
+#define CHARSET_H
+
+#include <constants.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* definition of CHARSET object (one bit per byte value) */
+typedef struct {
+	unsigned int bits[8];
+} CHARSET;
+
+/* tests whether a character is a member of a set (cs must be a valid pointer) */
+#define CHARSET_HAS(cs, c)				(((cs)->bits[(unsigned char)(c) >> 5] >> ((unsigned char)(c) & 31)) & 1)
+
+/* predefined character sets */
+extern const CHARSET CHARSET_WHITESPACE;
+extern const CHARSET CHARSET_DIGITS;
+extern const CHARSET CHARSET_ALPHA;
+extern const CHARSET CHARSET_ALPHANUMERIC;
+extern const CHARSET CHARSET_UPPER;
+extern const CHARSET CHARSET_LOWER;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * charset_dump() -	Frees memory allocated for a character set
+ * @cs:				the character set to free
+ */
+void charset_dump(CHARSET *cs);
+
+/*
+ * charset() -	Creates a character set from the characters of a C-style string
+ * @chars:		the member characters
+ *
+ * Returns a pointer to a new CHARSET object
+ */
+CHARSET* charset(const char *chars);
+
+/*
+ * charset_range() -	Creates a character set from an inclusive range of characters
+ * @first:				the first member
+ * @last:				the last member
+ *
+ * Returns a pointer to a new CHARSET object
+ */
+CHARSET* charset_range(unsigned char first, unsigned char last);
+
+/*
+ * charset_init() -	Initializes a caller-allocated (e.g. stack) character set without allocating
+ * @cs:				the character set to initialize
+ * @chars:			the member characters (may be NULL for an empty set)
+ */
+void charset_init(CHARSET *cs, const char *chars);
+
+/*
+ * charset_clear() -	Removes all members from a character set
+ * @cs:					the character set
+ */
+void charset_clear(CHARSET *cs);
+
+/*
+ * charset_add() -	Adds the characters of a C-style string to a set
+ * @cs:				the character set (modified in-place)
+ * @chars:			the characters to add
+ */
+void charset_add(CHARSET *cs, const char *chars);
+
+/*
+ * charset_add_range() -	Adds an inclusive range of characters to a set
+ * @cs:						the character set (modified in-place)
+ * @first:					the first character to add
+ * @last:					the last character to add
+ */
+void charset_add_range(CHARSET *cs, unsigned char first, unsigned char last);
+
+/*
+ * charset_union() -	Adds all members of another set to a set
+ * @cs:					the character set (modified in-place)
+ * @other:				the set whose members to add
+ */
+void charset_union(CHARSET *cs, const CHARSET *other);
+
+/*
+ * charset_invert() -	Replaces a set with its complement
+ * @cs:					the character set (modified in-place)
+ */
+void charset_invert(CHARSET *cs);
+
+/*
+ * charset_has() -	Checks if a character is a member of a set
+ * @cs:				the character set
+ * @c:				the character to test
+ *
+ * Returns TRUE if the character is in the set
+ */
+BOOL charset_has(const CHARSET *cs, char c);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
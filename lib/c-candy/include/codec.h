@@ -0,0 +1,226 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/codec.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef CODEC_H
+
+#define CODEC_H
+
+#include <constants.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * str_base64_encode() -	Encodes binary data as base64
+ * @data:					the bytes to encode
+ * @length:					the number of bytes
+ * @url_safe:				TRUE for the URL and filename safe alphabet ('-' and '_', no padding),
+ *							FALSE for the standard alphabet ('+' and '/', padded with '=')
+ *
+ * Returns a pointer to a new STRING object holding the encoded text
+ */
+STRING* str_base64_encode(const void *data, unsigned int length, BOOL url_safe);
+
+/*
+ * str_base64_encode_append() -	Encodes binary data as base64 at the end of an existing string
+ * @sobj:						the string to append to (modified in-place)
+ * @data:						the bytes to encode
+ * @length:						the number of bytes
+ * @url_safe:					TRUE for the URL and filename safe alphabet
+ *
+ * Returns TRUE if successful
+ */
+BOOL str_base64_encode_append(STRING *sobj, const void *data, unsigned int length, BOOL url_safe);
+
+/*
+ * str_base64_decode() -	Decodes base64 text (padding is optional)
+ * @sobj:					the text to decode
+ * @url_safe:				TRUE if the text uses the URL and filename safe alphabet
+ *
+ * Returns a pointer to a new STRING object holding the decoded bytes, or NULL if the text is not valid base64
+ */
+STRING* str_base64_decode(const STRING *sobj, BOOL url_safe);
+
+/*
+ * str_base64_decode_append() -	Decodes base64 text at the end of an existing string
+ * @sobj:						the string to append to (modified in-place)
+ * @text:						the text to decode
+ * @url_safe:					TRUE if the text uses the URL and filename safe alphabet
+ *
+ * Returns TRUE if successful; on invalid input FALSE is returned and @sobj is left unchanged
+ */
+BOOL str_base64_decode_append(STRING *sobj, const STRING *text, BOOL url_safe);
+
+/*
+ * str_hex_encode() -	Encodes binary data as hexadecimal digits
+ * @data:				the bytes to encode
+ * @length:				the number of bytes
+ * @upper:				TRUE to use uppercase digits
+ *
+ * Returns a pointer to a new STRING object holding the encoded text
+ */
+STRING* str_hex_encode(const void *data, unsigned int length, BOOL upper);
+
+/*
+ * str_hex_encode_append() -	Encodes binary data as hexadecimal digits at the end of an existing string
+ * @sobj:						the string to append to (modified in-place)
+ * @data:						the bytes to encode
+ * @length:						the number of bytes
+ * @upper:						TRUE to use uppercase digits
+ *
+ * Returns TRUE if successful
+ */
+BOOL str_hex_encode_append(STRING *sobj, const void *data, unsigned int length, BOOL upper);
+
+/*
+ * str_hex_decode() -	Decodes hexadecimal text (either case)
+ * @sobj:				the text to decode
+ *
+ * Returns a pointer to a new STRING object holding the decoded bytes, or NULL if the text is not valid
+ */
+STRING* str_hex_decode(const STRING *sobj);
+
+/*
+ * str_hex_decode_append() -	Decodes hexadecimal text at the end of an existing string
+ * @sobj:						the string to append to (modified in-place)
+ * @text:						the text to decode
+ *
+ * Returns TRUE if successful; on invalid input FALSE is returned and @sobj is left unchanged
+ */
+BOOL str_hex_decode_append(STRING *sobj, const STRING *text);
+
+/*
+ * str_json_escape() -	Escapes text as a JSON string body: control characters, '"' and '\' are escaped; other bytes, including UTF-8 sequences, are copied as they are
+ * @sobj:				the text to escape
+ *
+ * Returns a pointer to a new STRING object holding the escaped text
+ */
+STRING* str_json_escape(const STRING *sobj);
+
+/*
+ * str_json_escape_append() -	Escapes text as a JSON string body at the end of an existing string
+ * @sobj:						the string to append to (modified in-place)
+ * @text:						the text to escape
+ *
+ * Returns TRUE if successful
+ */
+BOOL str_json_escape_append(STRING *sobj, const STRING *text);
+
+/*
+ * str_json_unescape() -	Resolves the escape sequences of a JSON string body
+ * @sobj:					the text to unescape
+ *
+ * Returns a pointer to a new STRING object holding the unescaped text, or NULL if an escape sequence is invalid
+ */
+STRING* str_json_unescape(const STRING *sobj);
+
+/*
+ * str_json_unescape_append() -	Resolves the escape sequences of a JSON string body at the end of an existing string
+ * @sobj:							the string to append to (modified in-place)
+ * @text:							the text to unescape
+ *
+ * Returns TRUE if successful; on invalid input FALSE is returned and @sobj is left unchanged
+ */
+BOOL str_json_unescape_append(STRING *sobj, const STRING *text);
+
+/*
+ * str_c_escape() -	Escapes text as a C string literal body: control characters, bytes from 0x7f upwards, '"' and '\' are escaped; unnamed bytes become three-digit octal escapes
+ * @sobj:				the text to escape
+ *
+ * Returns a pointer to a new STRING object holding the escaped text
+ */
+STRING* str_c_escape(const STRING *sobj);
+
+/*
+ * str_c_escape_append() -	Escapes text as a C string literal body at the end of an existing string
+ * @sobj:						the string to append to (modified in-place)
+ * @text:						the text to escape
+ *
+ * Returns TRUE if successful
+ */
+BOOL str_c_escape_append(STRING *sobj, const STRING *text);
+
+/*
+ * str_c_unescape() -	Resolves the escape sequences of a C string literal body
+ * @sobj:					the text to unescape
+ *
+ * Returns a pointer to a new STRING object holding the unescaped text, or NULL if an escape sequence is invalid
+ */
+STRING* str_c_unescape(const STRING *sobj);
+
+/*
+ * str_c_unescape_append() -	Resolves the escape sequences of a C string literal body at the end of an existing string
+ * @sobj:							the string to append to (modified in-place)
+ * @text:							the text to unescape
+ *
+ * Returns TRUE if successful; on invalid input FALSE is returned and @sobj is left unchanged
+ */
+BOOL str_c_unescape_append(STRING *sobj, const STRING *text);
+
+/*
+ * str_url_encode() -	Percent-encodes text; every byte except A-Z, a-z, 0-9 and '-', '_', '.', '~' becomes %XX
+ * @sobj:				the text to encode
+ * @form:				TRUE to encode spaces as '+' (application/x-www-form-urlencoded)
+ *
+ * Returns a pointer to a new STRING object holding the encoded text
+ */
+STRING* str_url_encode(const STRING *sobj, BOOL form);
+
+/*
+ * str_url_encode_append() -	Percent-encodes text at the end of an existing string
+ * @sobj:						the string to append to (modified in-place)
+ * @text:						the text to encode
+ * @form:						TRUE to encode spaces as '+'
+ *
+ * Returns TRUE if successful
+ */
+BOOL str_url_encode_append(STRING *sobj, const STRING *text, BOOL form);
+
+/*
+ * str_url_decode() -	Decodes percent-encoded text
+ * @sobj:				the text to decode
+ * @form:				TRUE to decode '+' as a space
+ *
+ * Returns a pointer to a new STRING object holding the decoded text, or NULL if a '%' is not followed by two hex digits
+ */
+STRING* str_url_decode(const STRING *sobj, BOOL form);
+
+/*
+ * str_url_decode_append() -	Decodes percent-encoded text at the end of an existing string
+ * @sobj:						the string to append to (modified in-place)
+ * @text:						the text to decode
+ * @form:						TRUE to decode '+' as a space
+ *
+ * Returns TRUE if successful; on invalid input FALSE is returned and @sobj is left unchanged
+ */
+BOOL str_url_decode_append(STRING *sobj, const STRING *text, BOOL form);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
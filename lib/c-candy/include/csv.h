@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/csv.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef CSV_H
+
+#define CSV_H
+
+#include <stddef.h>
+#include <constants.h>
+#include <str.h>
+#include <list.h>
+#include <strarray.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define CSV_DEFAULT_SEPARATOR				','
+#define CSV_DEFAULT_QUOTE					'"'
+#define CSV_BLOCK_SIZE						64
+
+/* definition of a field within a record */
+typedef struct {
+	STRING_VIEW value;
+	BOOL quoted;
+} CSV_FIELD;
+
+/* definition of CSV_READER object */
+typedef struct {
+	const char *data;
+	size_t length;
+	size_t position;
+	char separator;
+	char quote;
+	size_t block;
+	size_t next_block;
+	unsigned long long structural;
+	unsigned long long in_quote;
+	unsigned long long record_number;
+} CSV_READER;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * csv_dump() -	Frees memory allocated for the reader (the input buffer is not freed)
+ * @r:			the reader to free
+ */
+void csv_dump(CSV_READER *r);
+
+/*
+ * csv_reader() -	Creates a record tokenizer over a character buffer
+ * @data:			the buffer to tokenize (must outlive the reader and every field returned)
+ * @length:			the number of bytes in the buffer
+ * @separator:		the field separator (e.g. CSV_DEFAULT_SEPARATOR or '\t')
+ * @quote:			the quote character (e.g. CSV_DEFAULT_QUOTE)
+ *
+ * Returns a pointer to a new CSV_READER object
+ */
+CSV_READER* csv_reader(const char *data, size_t length, char separator, char quote);
+
+/*
+ * csv_reader_str() -	Creates a record tokenizer over a string
+ * @sobj:				the string to tokenize (must outlive the reader and every field returned)
+ * @separator:			the field separator
+ * @quote:				the quote character
+ *
+ * Returns a pointer to a new CSV_READER object
+ */
+CSV_READER* csv_reader_str(const STRING *sobj, char separator, char quote);
+
+/*
+ * csv_next_record() -	Tokenizes the next record into views over the input buffer
+ * @r:					the reader
+ * @fields:				array to receive the fields of the record
+ * @max_fields:			the number of entries available in @fields
+ * @field_count:		receives the number of fields in the record (may exceed @max_fields, in which
+ *						case only the first @max_fields are stored)
+ *
+ * Quoted fields are returned without their surrounding quotes but with any doubled quotes still in
+ * place; use csv_field_copy() or csv_field_string() to obtain the unescaped value. A blank line
+ * yields a record with no fields.
+ *
+ * Returns TRUE if a record was read; FALSE at end of input
+ */
+BOOL csv_next_record(CSV_READER *r, CSV_FIELD *fields, unsigned int max_fields, unsigned int *field_count);
+
+/*
+ * csv_next_record_list() -	Reads the next record and appends its fields to a list
+ * @r:						the reader
+ * @list:					a TYPE_OBJECT list to which a new unescaped STRING is appended per field
+ *
+ * The appended strings are owned by the caller. On failure the reader is not advanced and the list is left unchanged.
+ *
+ * Returns TRUE if a record was read; FALSE at end of input or on failure
+ */
+BOOL csv_next_record_list(CSV_READER *r, LIST *list);
+
+/*
+ * csv_next_record_array() -	Reads the next record and appends its unescaped fields to a string array
+ * @r:							the reader
+ * @arr:						the array to append to
+ * @field_count:				receives the number of fields appended (may be NULL)
+ *
+ * On failure the reader is not advanced and the array is left unchanged.
+ *
+ * Returns TRUE if a record was read; FALSE at end of input or on failure
+ */
+BOOL csv_next_record_array(CSV_READER *r, STRING_ARRAY *arr, unsigned int *field_count);
+
+/*
+ * csv_field_copy() -	Copies the unescaped value of a field into a caller-owned string, reusing its buffer
+ * @r:					the reader the field came from
+ * @field:				the field to copy
+ * @out:				the string to overwrite
+ *
+ * Returns TRUE if successful
+ */
+BOOL csv_field_copy(const CSV_READER *r, const CSV_FIELD *field, STRING *out);
+
+/*
+ * csv_field_string() -	Returns the unescaped value of a field as a new string
+ * @r:					the reader the field came from
+ * @field:				the field to convert
+ *
+ * Returns a pointer to a new STRING object
+ */
+STRING* csv_field_string(const CSV_READER *r, const CSV_FIELD *field);
+
+/*
+ * csv_record_number() -	Returns the number of records read so far
+ * @r:						the reader
+ *
+ * Returns the count of records returned by the reader
+ */
+unsigned long long csv_record_number(const CSV_READER *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/lineindex.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef LINEINDEX_H
+
+#define LINEINDEX_H
+
+#include <constants.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* definition of LINE_INDEX object (the starting offset of every line of a string) */
+typedef struct {
+	const STRING *text;
+	unsigned int *starts;
+	unsigned int count;
+	unsigned int capacity;
+	unsigned int indexed;
+} LINE_INDEX;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * lidx_dump() -	Frees memory allocated for the line index (the indexed string is not freed)
+ * @idx:			the line index to free
+ */
+void lidx_dump(LINE_INDEX *idx);
+
+/*
+ * line_index() -	Builds the line index of a string in one pass
+ * @text:			the string to index (must outlive the index)
+ *
+ * Returns a pointer to a new LINE_INDEX object
+ */
+LINE_INDEX* line_index(const STRING *text);
+
+/*
+ * lidx_update() -	Brings the index up to date after the string has changed
+ * @idx:			the line index
+ *
+ * Only the characters appended since the last update are scanned; if the string got shorter the index is rebuilt.
+ * Returns TRUE if successful
+ */
+BOOL lidx_update(LINE_INDEX *idx);
+
+/*
+ * lidx_line_count() -	Returns the number of lines (a trailing newline does not start another line)
+ * @idx:				the line index
+ *
+ * Returns the number of lines, 0 for an empty string
+ */
+unsigned int lidx_line_count(const LINE_INDEX *idx);
+
+/*
+ * lidx_line_start() -	Returns the offset at which a line starts, in constant time
+ * @idx:				the line index
+ * @line:				the line number (starting from 0)
+ *
+ * Returns the offset of the first character of the line, or -1 if there is no such line
+ */
+int lidx_line_start(const LINE_INDEX *idx, unsigned int line);
+
+/*
+ * lidx_line_at() -	Finds the line containing a character, by binary search
+ * @idx:			the line index
+ * @offset:			the offset of the character (a newline belongs to the line it ends)
+ *
+ * Returns the line number (starting from 0), or -1 if the offset is out of range
+ */
+int lidx_line_at(const LINE_INDEX *idx, unsigned int offset);
+
+/*
+ * lidx_line() -	Returns a view of a line without copying it
+ * @idx:			the line index
+ * @line:			the line number (starting from 0)
+ *
+ * Returns a view of the line without its "\n" or "\r\n" terminator ({NULL, 0} if there is no such line);
+ * the view is invalidated when the string is modified
+ */
+STRING_VIEW lidx_line(const LINE_INDEX *idx, unsigned int line);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -0,0 +1,133 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/linereader.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef LINEREADER_H
+
+#define LINEREADER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <constants.h>
+#include <str.h>
+#include <strarray.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define LR_DEFAULT_BUFFER_SIZE				65536
+
+/* definition of LINE_READER object */
+typedef struct {
+	int fd;
+	FILE *fp;
+	char *buffer;
+	size_t capacity;
+	size_t start;
+	size_t end;
+	unsigned long long line_number;
+	BOOL eof;
+	BOOL error;
+} LINE_READER;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * lr_dump() -	Frees memory allocated for the line reader (the underlying file is not closed)
+ * @lr:			the line reader to free
+ */
+void lr_dump(LINE_READER *lr);
+
+/*
+ * line_reader() -	Creates a line reader over an open file descriptor
+ * @fd:				the file descriptor to read from
+ * @buffer_size:	size of the internal read buffer in bytes (0 for LR_DEFAULT_BUFFER_SIZE)
+ *
+ * Returns a pointer to a new LINE_READER object
+ */
+LINE_READER* line_reader(int fd, size_t buffer_size);
+
+/*
+ * line_reader_file() -	Creates a line reader over an open FILE stream
+ * @fp:					the stream to read from
+ * @buffer_size:		size of the internal read buffer in bytes (0 for LR_DEFAULT_BUFFER_SIZE)
+ *
+ * Returns a pointer to a new LINE_READER object
+ */
+LINE_READER* line_reader_file(FILE *fp, size_t buffer_size);
+
+/*
+ * lr_read_line() -	Reads the next line into a caller-owned string, reusing its buffer
+ * @lr:				the line reader
+ * @line:			the string to overwrite with the line (without the trailing LF or CRLF)
+ *
+ * Lines longer than the internal buffer are assembled directly in @line.
+ *
+ * Returns TRUE if a line was read; FALSE at end of input or on error
+ */
+BOOL lr_read_line(LINE_READER *lr, STRING *line);
+
+/*
+ * lr_read_lines() -	Reads up to a number of lines, appending them to a string array
+ * @lr:					the line reader
+ * @arr:				the array to append the lines to (without their trailing LF or CRLF)
+ * @max_lines:			the maximum number of lines to read
+ *
+ * Every line is copied straight from the internal buffer into the array; the buffer is grown to hold a line
+ * longer than itself. A line is consumed only once it has been appended, so on failure it is read again by
+ * the next call.
+ *
+ * Returns the number of lines read (0 at end of input), or -1 on a read or allocation failure
+ */
+int lr_read_lines(LINE_READER *lr, STRING_ARRAY *arr, unsigned int max_lines);
+
+/*
+ * lr_line_number() -	Returns the number of lines read so far
+ * @lr:					the line reader
+ *
+ * Returns the 1-based number of the last line read (0 if none)
+ */
+unsigned long long lr_line_number(const LINE_READER *lr);
+
+/*
+ * lr_is_at_eof() -	Checks if all input has been consumed
+ * @lr:				the line reader
+ *
+ * Returns TRUE if there are no more lines to read
+ */
+BOOL lr_is_at_eof(const LINE_READER *lr);
+
+/*
+ * lr_has_error() -	Checks if a read error occurred
+ * @lr:				the line reader
+ *
+ * Returns TRUE if the underlying read failed
+ */
+BOOL lr_has_error(const LINE_READER *lr);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -38,12 +38,13 @@ extern "C" {
 #define LIST_CAPACITY_DECREASE_LOAD_FACTOR		0.25
 #define LIST_CAPACITY_DECREASE_FACTOR			0.5
 
-/* definition of LIST */
+/* definition of LIST (data holds the object pointers of a TYPE_OBJECT list, else the values themselves, item_size bytes each) */
 typedef struct {
 	ITEM_TYPE type;
 	void **data;
 	int length;
 	int capacity;
+	unsigned int item_size;
 } LIST;
 
 /* <------------------ function declarations -------------------> */
@@ -51,7 +52,7 @@ typedef struct {
 /* frees memory allocated for the list */
 void list_dump(LIST *list);
 
-/* returns a new copy of a list */
+/* returns a new copy of a list (deep_copy is ignored: values are copied and objects are shared) */
 LIST* list_copy(const LIST *list, BOOL deep_copy);
 
 /* creates a new empty list */
@@ -108,7 +109,7 @@ ITEM* list_get(const LIST *list, int index);
 /* sets an item at the specified index */
 BOOL list_set(const LIST *list, int index, ...);
 
-/* returns a portion of a list as another list */
+/* returns a portion of a list as another list (deep_copy is ignored: values are copied and objects are shared) */
 LIST* list_get_sublist(const LIST *list, int start, int end, BOOL deep_copy);
 
 /* returns the elements of the list as an array */
@@ -0,0 +1,256 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/segiterator.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef SEGITERATOR_H
+
+#define SEGITERATOR_H
+
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <striterator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* definition of SEG_ITERATOR object (iterates over a sequence of borrowed segments as one string; positions count
+ * from the start of the first segment ever appended, and segment i covers positions starts[i] to starts[i + 1]) */
+typedef struct {
+	STRING_VIEW *segments;
+	long long *starts;
+	unsigned int count;
+	unsigned int capacity;
+	long long marker;
+	unsigned int segment;
+} SEG_ITERATOR;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * segi_dump() -	Frees memory allocated for the iterator (the segments themselves are not freed)
+ * @si:				the iterator object to free
+ */
+void segi_dump(SEG_ITERATOR *si);
+
+/*
+ * seg_iterator() -	Creates an iterator with no segments
+ *
+ * Returns an iterator
+ */
+SEG_ITERATOR* seg_iterator();
+
+/*
+ * segi_append() -	Appends a string as the next segment (the string is not copied and must outlive its use)
+ * @si:				the iterator object
+ * @sobj:			the string
+ *
+ * Returns TRUE if successful
+ */
+BOOL segi_append(SEG_ITERATOR *si, const STRING *sobj);
+
+/*
+ * segi_append_view() -	Appends a view as the next segment (the data is not copied and must outlive its use)
+ * @si:					the iterator object
+ * @view:				the view
+ *
+ * Returns TRUE if successful
+ */
+BOOL segi_append_view(SEG_ITERATOR *si, STRING_VIEW view);
+
+/*
+ * segi_discard_before() -	Forgets the leading segments which end at or before a position (and before the marker)
+ * @si:						the iterator object
+ * @position:				the position
+ *
+ * Positions of the remaining segments do not change. Returns the number of segments discarded, which the
+ * caller may now free
+ */
+unsigned int segi_discard_before(SEG_ITERATOR *si, long long position);
+
+/*
+ * segi_length() -	Returns the position just past the last segment
+ * @si:				the iterator object
+ *
+ * Returns the end position (the total length, unless segments were discarded)
+ */
+long long segi_length(const SEG_ITERATOR *si);
+
+/*
+ * segi_this() -	Returns the character at the current marker position
+ * @si:				the iterator object
+ *
+ * Returns the character at the current marker position (-1 at the end)
+ */
+char segi_this(const SEG_ITERATOR *si);
+
+/*
+ * segi_next() -	Returns the character to the right of the current marker position
+ * @si:				the iterator object
+ *
+ * Returns the character to the right of the current marker position (-1 if there is none)
+ */
+char segi_next(const SEG_ITERATOR *si);
+
+/*
+ * segi_prev() -	Returns the character to the left of the current marker position
+ * @si:				the iterator object
+ *
+ * Returns the character to the left of the current marker position (-1 if there is none)
+ */
+char segi_prev(const SEG_ITERATOR *si);
+
+/*
+ * segi_pos() -	Returns the current marker position
+ * @si:			the iterator object
+ *
+ * Returns the current marker position, or STRI_EOS at the end
+ */
+long long segi_pos(const SEG_ITERATOR *si);
+
+/*
+ * segi_move() -	Shifts the marker a certain number of characters to the left/right, across segments
+ * @si:				the iterator object
+ * @num_chars:		the number of characters to move (negative: left, positive: right)
+ *
+ * Returns TRUE if the move was successful
+ */
+BOOL segi_move(SEG_ITERATOR *si, long long num_chars);
+
+/*
+ * segi_move_next() -	Shifts the marker one character to the right
+ * @si:					the iterator object
+ *
+ * Returns TRUE if the move was successful
+ */
+BOOL segi_move_next(SEG_ITERATOR *si);
+
+/*
+ * segi_move_prev() -	Shifts the marker one character to the left
+ * @si:					the iterator object
+ *
+ * Returns TRUE if the move was successful
+ */
+BOOL segi_move_prev(SEG_ITERATOR *si);
+
+/*
+ * segi_move_to() -	Moves the marker to a position
+ * @si:				the iterator object
+ * @position:		the position (clamped to the segments held)
+ *
+ * Returns TRUE if the move was successful
+ */
+BOOL segi_move_to(SEG_ITERATOR *si, long long position);
+
+/*
+ * segi_reset() -	Brings the marker back to the beginning of the first segment held
+ * @si:				the iterator object
+ *
+ * Returns TRUE if the move was successful
+ */
+BOOL segi_reset(SEG_ITERATOR *si);
+
+/*
+ * segi_move_eos() -	Shifts the marker to the end of the last segment
+ * @si:					the iterator object
+ *
+ * Returns TRUE if the move was successful
+ */
+BOOL segi_move_eos(SEG_ITERATOR *si);
+
+/*
+ * segi_is_at_eos() -	Checks if the marker is at the end of the last segment
+ * @si:					the iterator object
+ *
+ * Returns TRUE if the marker is at the end else returns FALSE
+ */
+BOOL segi_is_at_eos(const SEG_ITERATOR *si);
+
+/*
+ * segi_move_until() -	Shifts the marker till one of the given characters is found
+ * @si:					the iterator object
+ * @chars:				the list of characters among which to find (stop at)
+ * @step:				the number of characters to move the marker at a time during each check
+ *
+ * Returns the marker position after the shift
+ */
+long long segi_move_until(SEG_ITERATOR *si, const char *chars, int step);
+
+/*
+ * segi_move_while() -	Shifts the marker until a character not among the given characters is found
+ * @si:					the iterator object
+ * @chars:				the list of characters to skip over
+ * @step:				the number of characters to move the marker at a time during each check
+ *
+ * Returns the marker position after the shift
+ */
+long long segi_move_while(SEG_ITERATOR *si, const char *chars, int step);
+
+/*
+ * segi_move_until_charset() -	Shifts the marker until a character belonging to a set is found
+ * @si:							the iterator object
+ * @cs:							the set of characters to stop at
+ * @step:						the number of characters to move the marker at a time during each check
+ *
+ * Returns the marker position after the shift
+ */
+long long segi_move_until_charset(SEG_ITERATOR *si, const CHARSET *cs, int step);
+
+/*
+ * segi_move_while_charset() -	Shifts the marker until a character not belonging to a set is found
+ * @si:							the iterator object
+ * @cs:							the set of characters to skip over
+ * @step:						the number of characters to move the marker at a time during each check
+ *
+ * Returns the marker position after the shift
+ */
+long long segi_move_while_charset(SEG_ITERATOR *si, const CHARSET *cs, int step);
+
+/*
+ * segi_span() -	Returns the characters between two positions as one view
+ * @si:				the iterator object
+ * @start:			the first position of the span
+ * @end:			the position after the span
+ * @scratch:		caller-owned string to assemble the span in if it straddles segments (may be NULL)
+ *
+ * A span within one segment is returned as a view of that segment, without copying; only a span straddling
+ * segments is copied, into @scratch. Returns a view, with NULL data if the span is out of range or straddles
+ * segments while @scratch is NULL
+ */
+STRING_VIEW segi_span(const SEG_ITERATOR *si, long long start, long long end, STRING *scratch);
+
+/*
+ * segi_substring() -	Returns the characters between two positions as a new string
+ * @si:					the iterator object
+ * @start:				the first position
+ * @end:				the position after the last character
+ *
+ * Returns a pointer to a new STRING object
+ */
+STRING* segi_substring(const SEG_ITERATOR *si, long long start, long long end);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
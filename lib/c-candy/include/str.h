@@ -25,6 +25,8 @@
 #define STR_H
 
 #include <constants.h>
+#include <charset.h>
+#include <list.h>
 
 /* other constants */
 #define STR_SIZE 						sizeof(STRING)
@@ -37,8 +39,15 @@ extern "C" {
 typedef struct {
 	char *data;
 	unsigned int length;
+	unsigned int capacity;
 } STRING;
 
+/* definition of STRING_VIEW object (a read-only slice of a buffer owned by someone else) */
+typedef struct {
+	const char *data;
+	unsigned int length;
+} STRING_VIEW;
+
 /* <------------------------------ function declarations --------------------------------> */
 
 /*
@@ -77,6 +86,22 @@ STRING* string(const char *s);
  */
 STRING* str_copy(const STRING *s);
 
+/*
+ * str_view() -	Returns a view over the characters of a string without copying them
+ * @sobj:		the string to view
+ *
+ * Returns a STRING_VIEW which is valid as long as the string is not modified or freed
+ */
+STRING_VIEW str_view(const STRING *sobj);
+
+/*
+ * str_from_view() -	Creates a STRING object from a view
+ * @view:				the view to copy
+ *
+ * Returns a pointer to a new STRING object
+ */
+STRING* str_from_view(STRING_VIEW view);
+
 /*
  * str_len() - 	Computes the length of a string
  * @sobj: 		string object whose length is to be returned
@@ -85,6 +110,15 @@ STRING* str_copy(const STRING *s);
  */
 unsigned int str_len(const STRING* sobj);
 
+/*
+ * str_reserve() -	Ensures that a string can hold a given number of characters without reallocating
+ * @sobj:			the string object to grow (modified in-place)
+ * @capacity:		the number of characters (excluding the terminating null) to make room for
+ *
+ * Returns TRUE if successful; the contents and length of the string are left unchanged
+ */
+BOOL str_reserve(STRING *sobj, unsigned int capacity);
+
 /*
  * cstr() - Converts STRING object to a C-style string constant
  * @sobj: 	the string object to convert
@@ -111,6 +145,43 @@ BOOL str_is_char_in(const STRING *sobj, char c);
  */
 BOOL str_append(STRING *sobj, const STRING *suffix);
 
+/*
+ * str_join() -		Joins a list of strings, placing a separator between consecutive items
+ * @list:			a TYPE_OBJECT list of STRING objects (NULL items count as empty strings)
+ * @separator:		the string to place between items, or NULL for none
+ *
+ * Returns a new string, allocated once at its final length
+ */
+STRING* str_join(const LIST *list, const STRING *separator);
+
+/*
+ * str_join_array() -	Joins an array of strings, placing a separator between consecutive items
+ * @items:				the strings to join (NULL items count as empty strings)
+ * @count:				the number of items
+ * @separator:			the string to place between items, or NULL for none
+ *
+ * Returns a new string, allocated once at its final length
+ */
+STRING* str_join_array(const STRING **items, unsigned int count, const STRING *separator);
+
+/*
+ * str_concat_n() -	Concatenates a number of strings
+ * @count:			the number of strings that follow
+ * ...				the STRING objects to concatenate (NULL counts as an empty string)
+ *
+ * Returns a new string, allocated once at its final length
+ */
+STRING* str_concat_n(int count, ...);
+
+/*
+ * str_repeat() -	Repeats a string a number of times
+ * @sobj:			the string to repeat
+ * @times:			the number of copies
+ *
+ * Returns a new string, allocated once at its final length
+ */
+STRING* str_repeat(const STRING *sobj, unsigned int times);
+
 /*
  * str_insert() - 	Inserts a string into the given string at the specified index
  * @sobj: 			the string to insert into (modified in-place)
@@ -214,6 +285,33 @@ STRING* str_lstrip(const STRING *sobj);
  */
 STRING* str_rstrip(const STRING *sobj);
 
+/*
+ * str_strip_chars() -	Removes any leading and trailing characters belonging to a set
+ * @sobj:				the string to strip
+ * @cs:					the set of characters to remove
+ *
+ * Returns the stripped string
+ */
+STRING* str_strip_chars(const STRING *sobj, const CHARSET *cs);
+
+/*
+ * str_lstrip_chars() -	Removes any leading characters belonging to a set
+ * @sobj:				the string to strip
+ * @cs:					the set of characters to remove
+ *
+ * Returns the stripped string
+ */
+STRING* str_lstrip_chars(const STRING *sobj, const CHARSET *cs);
+
+/*
+ * str_rstrip_chars() -	Removes any trailing characters belonging to a set
+ * @sobj:				the string to strip
+ * @cs:					the set of characters to remove
+ *
+ * Returns the stripped string
+ */
+STRING* str_rstrip_chars(const STRING *sobj, const CHARSET *cs);
+
 /*
  * str_char_at() -	Returns the character at a given index
  * @sobj: 			the string to extract from
@@ -351,6 +449,15 @@ BOOL str_is_decimal(const STRING *sobj);
  */
 BOOL str_is_whitespace(const STRING *sobj);
 
+/*
+ * str_is_in_charset() -	Checks if a string contains only characters belonging to a set
+ * @sobj:					the string to check
+ * @cs:						the set of allowed characters
+ *
+ * Returns TRUE if every character of the string is in the set
+ */
+BOOL str_is_in_charset(const STRING *sobj, const CHARSET *cs);
+
 /*
  * is_upper() - Checks if a string contains no lowercase characters
  * @sobj: 		the string to check
@@ -414,6 +521,17 @@ STRING** str_split(const STRING *sobj, const char *delimiter, int max_split, int
  */
 STRING** str_split_whitespace(const STRING *sobj, int max_split, int *split_count);
 
+/*
+ * str_split_chars() -	Splits a string at every run of characters belonging to a set
+ * @sobj:				the string to split
+ * @delimiters:			the set of delimiter characters
+ * @max_split:			the maximum number of parts to return, use -1 to get all parts
+ * @split_count:		pointer to an integer where the actual number of parts is stored
+ *
+ * Returns the non-empty sub strings after splitting
+ */
+STRING** str_split_chars(const STRING *sobj, const CHARSET *delimiters, int max_split, int *split_count);
+
 /* 
  * zfill() -	Pads a string with zeroes on the left
  * @sobj: 		the string to pad
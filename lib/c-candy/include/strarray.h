@@ -0,0 +1,169 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strarray.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRARRAY_H
+
+#define STRARRAY_H
+
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* definition of STRING_ARRAY object (all elements in one buffer, each followed by a '\0'; element i starts at
+ * offsets[i] and offsets[count] is the number of bytes used) */
+typedef struct {
+	char *data;
+	unsigned int capacity;
+	unsigned int *offsets;
+	unsigned int count;
+	unsigned int offset_capacity;
+} STRING_ARRAY;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * sa_dump() -	Frees memory allocated for a string array and all its elements
+ * @arr:		the array to free
+ */
+void sa_dump(STRING_ARRAY *arr);
+
+/*
+ * string_array() -	Creates an empty string array
+ * @count_hint:		the number of elements to make room for
+ * @bytes_hint:		the total length of the elements to make room for
+ *
+ * Returns a pointer to a new STRING_ARRAY object
+ */
+STRING_ARRAY* string_array(unsigned int count_hint, unsigned int bytes_hint);
+
+/*
+ * sa_clear() -	Removes all elements, keeping the memory for reuse
+ * @arr:		the array
+ */
+void sa_clear(STRING_ARRAY *arr);
+
+/*
+ * sa_count() -	Returns the number of elements in a string array
+ * @arr:		the array
+ *
+ * Returns the number of elements
+ */
+unsigned int sa_count(const STRING_ARRAY *arr);
+
+/*
+ * sa_get() -	Returns a view of an element
+ * @arr:		the array
+ * @index:		the index of the element
+ *
+ * The view is '\0'-terminated and valid until the array is next modified. Returns an empty view with NULL
+ * data if the index is out of range
+ */
+STRING_VIEW sa_get(const STRING_ARRAY *arr, unsigned int index);
+
+/*
+ * sa_string() -	Returns a copy of an element as a new string
+ * @arr:			the array
+ * @index:			the index of the element
+ *
+ * Returns a pointer to a new STRING object
+ */
+STRING* sa_string(const STRING_ARRAY *arr, unsigned int index);
+
+/*
+ * sa_append_chars() -	Appends a range of characters as a new element
+ * @arr:				the array
+ * @data:				the characters (may lie within the array itself)
+ * @length:				the number of characters
+ *
+ * Returns TRUE if successful
+ */
+BOOL sa_append_chars(STRING_ARRAY *arr, const char *data, unsigned int length);
+
+/*
+ * sa_append() -	Appends a copy of a string as a new element
+ * @arr:			the array
+ * @sobj:			the string
+ *
+ * Returns TRUE if successful
+ */
+BOOL sa_append(STRING_ARRAY *arr, const STRING *sobj);
+
+/*
+ * sa_append_view() -	Appends a copy of a string view as a new element
+ * @arr:				the array
+ * @view:				the view
+ *
+ * Returns TRUE if successful
+ */
+BOOL sa_append_view(STRING_ARRAY *arr, STRING_VIEW view);
+
+/*
+ * sa_push() -	Appends a new element of a given length, to be filled in by the caller
+ * @arr:		the array
+ * @length:		the length of the element
+ *
+ * Returns a pointer to the characters of the element (valid until the array is next modified), or NULL on failure
+ */
+char* sa_push(STRING_ARRAY *arr, unsigned int length);
+
+/*
+ * sa_truncate_last() -	Shortens the last element
+ * @arr:				the array
+ * @length:				the new length, not more than the current one
+ *
+ * Returns TRUE if successful
+ */
+BOOL sa_truncate_last(STRING_ARRAY *arr, unsigned int length);
+
+/*
+ * str_split_array() -	Splits a string at every occurrence of a delimiter, appending the parts to a string array
+ * @sobj:				the string to split
+ * @delimiter:			the delimiter
+ * @max_split:			the maximum number of parts to append, use -1 to append all parts
+ * @arr:				the array to append to
+ *
+ * Empty parts are skipped, as in str_split(). Returns the number of parts appended, or -1 on failure
+ */
+int str_split_array(const STRING *sobj, const char *delimiter, int max_split, STRING_ARRAY *arr);
+
+/*
+ * str_split_chars_array() -	Splits a string at every run of characters belonging to a set, appending the parts
+ *								to a string array
+ * @sobj:						the string to split
+ * @delimiters:					the set of delimiter characters
+ * @max_split:					the maximum number of parts to append, use -1 to append all parts
+ * @arr:						the array to append to
+ *
+ * Returns the number of parts appended, or -1 on failure
+ */
+int str_split_chars_array(const STRING *sobj, const CHARSET *delimiters, int max_split, STRING_ARRAY *arr);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
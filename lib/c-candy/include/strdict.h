@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strdict.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRDICT_H
+
+#define STRDICT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <constants.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define SD_MAGIC					"CCSDICT1"
+#define SD_HEADER_SIZE				32
+#define SD_DEFAULT_BLOCK_SIZE		16
+
+/*
+ * File layout (all integers little-endian):
+ *	header:	magic (8 bytes), key count (u32), keys per block (u32), block count (u32), reserved (u32),
+ *			offset of the block index (u64)
+ *	blocks:	the first key of a block as varint length + bytes; every other key as varint length shared with
+ *			the previous key + varint suffix length + suffix bytes
+ *	index:	the file offset of every block (u64 each)
+ */
+
+/* definition of STR_DICT_BUILDER object (writes a dictionary file from keys given in ascending order) */
+typedef struct {
+	FILE *fp;
+	STRING *previous;
+	unsigned long long *offsets;
+	unsigned int block_count;
+	unsigned int block_capacity;
+	unsigned long long position;
+	unsigned int count;
+	unsigned int block_size;
+	BOOL error;
+} STR_DICT_BUILDER;
+
+/* definition of STR_DICT object (a dictionary file mapped into memory) */
+typedef struct {
+	const unsigned char *map;
+	size_t size;
+	const unsigned char *index;
+	unsigned int count;
+	unsigned int block_size;
+	unsigned int block_count;
+} STR_DICT;
+
+/* definition of STR_DICT_CURSOR object (position in a dictionary for reading keys in order; may live on the stack) */
+typedef struct {
+	const STR_DICT *dict;
+	unsigned int ordinal;
+	unsigned int start;
+	size_t offset;
+} STR_DICT_CURSOR;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * sdb_dump() -	Frees memory allocated for a dictionary builder (closing its file if sdb_finish() was not called)
+ * @sdb:		the builder to free
+ */
+void sdb_dump(STR_DICT_BUILDER *sdb);
+
+/*
+ * str_dict_builder() -	Creates a builder writing a new dictionary file
+ * @path:				the path of the file (created or truncated)
+ * @block_size:			the number of keys per block (0 for SD_DEFAULT_BLOCK_SIZE); larger blocks make the file
+ *						smaller and lookups slower
+ *
+ * Returns a pointer to a new STR_DICT_BUILDER object
+ */
+STR_DICT_BUILDER* str_dict_builder(const char *path, unsigned int block_size);
+
+/*
+ * sdb_add() -	Appends a key to the dictionary
+ * @sdb:		the builder
+ * @key:		the key, which must be greater than the previous one (byte-wise comparison)
+ *
+ * Returns TRUE if successful, FALSE if the key is out of order or cannot be written
+ */
+BOOL sdb_add(STR_DICT_BUILDER *sdb, const STRING *key);
+
+/*
+ * sdb_finish() -	Writes the block index and header and closes the file
+ * @sdb:			the builder (still to be freed with sdb_dump())
+ *
+ * Returns TRUE if the whole file was written successfully
+ */
+BOOL sdb_finish(STR_DICT_BUILDER *sdb);
+
+/*
+ * sd_dump() -	Unmaps a dictionary and frees memory allocated for it
+ * @sd:			the dictionary to free
+ */
+void sd_dump(STR_DICT *sd);
+
+/*
+ * str_dict_open() -	Maps a dictionary file into memory
+ * @path:				the path of the file
+ *
+ * Only the header is read; pages of the file are loaded by the system as lookups touch them.
+ * Returns a pointer to a new STR_DICT object, or NULL if the file cannot be mapped or is not a dictionary
+ */
+STR_DICT* str_dict_open(const char *path);
+
+/*
+ * sd_count() -	Returns the number of keys in a dictionary
+ * @sd:			the dictionary
+ *
+ * Returns the number of keys
+ */
+unsigned int sd_count(const STR_DICT *sd);
+
+/*
+ * sd_find() -	Looks up a key
+ * @sd:			the dictionary
+ * @key:		the key
+ *
+ * Returns the ordinal (position in sorted order) of the key, or -1 if not present
+ */
+int sd_find(const STR_DICT *sd, const STRING *key);
+
+/*
+ * sd_lower_bound() -	Finds the first key not less than a given string
+ * @sd:					the dictionary
+ * @key:				the string
+ *
+ * Returns the ordinal of that key (the key count if there is none), or -1 on failure
+ */
+int sd_lower_bound(const STR_DICT *sd, const STRING *key);
+
+/*
+ * sd_prefix_range() -	Finds the keys starting with a prefix
+ * @sd:					the dictionary
+ * @prefix:				the prefix
+ * @first:				receives the ordinal of the first such key
+ * @last:				receives the ordinal after the last such key (equal to *first if there are none)
+ *
+ * Returns TRUE if successful
+ */
+BOOL sd_prefix_range(const STR_DICT *sd, const STRING *prefix, unsigned int *first, unsigned int *last);
+
+/*
+ * sd_get() -	Decodes the key at an ordinal into a caller-owned string, reusing its buffer
+ * @sd:			the dictionary
+ * @ordinal:	the ordinal of the key
+ * @key:		the string which receives the key
+ *
+ * Returns TRUE if successful, FALSE if the ordinal is out of range
+ */
+BOOL sd_get(const STR_DICT *sd, unsigned int ordinal, STRING *key);
+
+/*
+ * sd_cursor() -	Positions a cursor so that the next key read is the one at an ordinal
+ * @sd:				the dictionary
+ * @ordinal:		the ordinal of the first key to read
+ * @cursor:			the cursor to initialize
+ */
+void sd_cursor(const STR_DICT *sd, unsigned int ordinal, STR_DICT_CURSOR *cursor);
+
+/*
+ * sd_next() -	Reads the next key of a cursor into a caller-owned string
+ * @cursor:		the cursor
+ * @key:		the string which receives the key; pass the same string on every call, since each key is
+ *				decoded from the previous one
+ *
+ * Returns TRUE if a key was read, FALSE at the end of the dictionary
+ */
+BOOL sd_next(STR_DICT_CURSOR *cursor, STRING *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strdiff.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRDIFF_H
+
+#define STRDIFF_H
+
+#include <constants.h>
+#include <list.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define DIFF_EQUAL			0
+#define DIFF_DELETE			1
+#define DIFF_INSERT			2
+
+/* definition of one edit (a run of units kept, deleted from the first sequence or inserted from the second) */
+typedef struct {
+	int op;
+	unsigned int a_start;
+	unsigned int b_start;
+	unsigned int length;
+} DIFF_EDIT;
+
+/* definition of DIFF_SCRIPT object */
+typedef struct {
+	DIFF_EDIT *edits;
+	unsigned int count;
+	unsigned int capacity;
+} DIFF_SCRIPT;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * diff_dump() -	Frees memory allocated for an edit script
+ * @script:			the script to free
+ */
+void diff_dump(DIFF_SCRIPT *script);
+
+/*
+ * str_diff() -	Computes a shortest edit script turning one string into another, character by character
+ * @a:			the old string
+ * @b:			the new string
+ *
+ * Edits are in order and cover both strings; positions and lengths count characters. Between two equal runs
+ * there is at most one deletion followed by at most one insertion. Returns a pointer to a new DIFF_SCRIPT object
+ */
+DIFF_SCRIPT* str_diff(const STRING *a, const STRING *b);
+
+/*
+ * str_diff_lines() -	Computes a shortest edit script turning one text into another, line by line
+ * @a:					the old text
+ * @b:					the new text
+ *
+ * Lines are split at '\n' (which is part of the line) without copying; positions and lengths count lines.
+ * Returns a pointer to a new DIFF_SCRIPT object
+ */
+DIFF_SCRIPT* str_diff_lines(const STRING *a, const STRING *b);
+
+/*
+ * str_diff_list() -	Computes a shortest edit script turning one list of strings into another
+ * @a:					the old list (of STRING objects)
+ * @b:					the new list (of STRING objects)
+ *
+ * Positions and lengths count list items. Returns a pointer to a new DIFF_SCRIPT object
+ */
+DIFF_SCRIPT* str_diff_list(const LIST *a, const LIST *b);
+
+/*
+ * diff_distance() -	Returns the number of units deleted and inserted by an edit script
+ * @script:				the script
+ *
+ * Returns the edit distance (insertions and deletions only), or -1 if the script is NULL
+ */
+int diff_distance(const DIFF_SCRIPT *script);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
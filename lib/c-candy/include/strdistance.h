@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strdistance.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRDISTANCE_H
+
+#define STRDISTANCE_H
+
+#include <constants.h>
+#include <str.h>
+#include <list.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * str_edit_distance() -	Computes the Levenshtein distance between two strings
+ * @sobj1:					the first string
+ * @sobj2:					the second string
+ *
+ * Returns the minimum number of single-character insertions, deletions and substitutions needed to
+ * turn one string into the other, or -1 on failure
+ */
+int str_edit_distance(const STRING *sobj1, const STRING *sobj2);
+
+/*
+ * str_edit_distance_bounded() -	Computes the Levenshtein distance if it does not exceed a threshold
+ * @sobj1:							the first string
+ * @sobj2:							the second string
+ * @max_distance:					the largest distance of interest
+ *
+ * Stops as soon as the distance is known to exceed @max_distance.
+ *
+ * Returns the distance, or -1 if it is greater than @max_distance
+ */
+int str_edit_distance_bounded(const STRING *sobj1, const STRING *sobj2, int max_distance);
+
+/*
+ * str_best_match() -	Finds the string in a list which is closest to a query
+ * @query:				the string to match
+ * @candidates:			a TYPE_OBJECT list of STRING objects
+ * @max_distance:		the largest distance to accept, use -1 for no limit
+ * @distance:			pointer to an integer where the distance of the best match is stored (may be NULL)
+ *
+ * Returns the index of the first candidate with the smallest distance, or -1 if none is within @max_distance
+ */
+int str_best_match(const STRING *query, const LIST *candidates, int max_distance, int *distance);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -0,0 +1,218 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/streamiterator.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STREAMITERATOR_H
+
+#define STREAMITERATOR_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <striterator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define STMI_DEFAULT_WINDOW_SIZE			262144
+#define STMI_MIN_WINDOW_SIZE				4096
+#define STMI_LOOKBEHIND						256
+
+/* definition of STREAM_ITERATOR object (buffer[0] holds the character at position base) */
+typedef struct {
+	int fd;
+	char *buffer;
+	size_t capacity;
+	size_t read_size;
+	size_t end;
+	long long base;
+	long long marker;
+	long long mark;				/* -1 if there is no mark */
+	BOOL eof;
+	BOOL error;
+	BOOL read_ahead;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	BOOL requested;				/* a read into buffer[end] is wanted or in progress */
+	BOOL stop;
+	long ready;					/* the result of the last read ahead, not yet absorbed */
+} STREAM_ITERATOR;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * stmi_dump() -	Frees memory allocated for the iterator (the file descriptor is not closed)
+ * @si:				the iterator object to free
+ *
+ * A read ahead in progress is waited for.
+ */
+void stmi_dump(STREAM_ITERATOR *si);
+
+/*
+ * stream_iterator() -	Creates an iterator over the characters read from a file descriptor
+ * @fd:					the file descriptor to read from
+ * @window_size:		size of the window kept in memory in bytes (0 for STMI_DEFAULT_WINDOW_SIZE,
+ *						at least STMI_MIN_WINDOW_SIZE)
+ * @read_ahead:			TRUE to read the next chunk on a background thread while the current one is parsed
+ *
+ * Returns a pointer to a new STREAM_ITERATOR object
+ */
+STREAM_ITERATOR* stream_iterator(int fd, size_t window_size, BOOL read_ahead);
+
+/*
+ * stmi_this() -	Returns the character at the current marker position
+ * @si:				the iterator object
+ *
+ * Returns the character at the marker, -1 at the end of the input
+ */
+char stmi_this(STREAM_ITERATOR *si);
+
+/*
+ * stmi_next() -	Returns the character to the right of the current marker position
+ * @si:				the iterator object
+ *
+ * Returns the character to the right of the marker, -1 if there is none
+ */
+char stmi_next(STREAM_ITERATOR *si);
+
+/*
+ * stmi_prev() -	Returns the character to the left of the current marker position
+ * @si:				the iterator object
+ *
+ * Returns the character to the left of the marker, -1 if there is none or it has left the window
+ * (the STMI_LOOKBEHIND characters before the furthest position the marker has reached are always kept)
+ */
+char stmi_prev(const STREAM_ITERATOR *si);
+
+/*
+ * stmi_pos() -	Returns the current marker position
+ * @si:			the iterator object
+ *
+ * Returns the number of characters before the marker, STRI_EOS at the end of the input
+ */
+long long stmi_pos(STREAM_ITERATOR *si);
+
+/*
+ * stmi_move() -	Shifts the marker a number of characters to the left/right
+ * @si:				the iterator object
+ * @num_chars:		the number of characters to move (negative: left, at most back to the start of the window)
+ *
+ * Returns TRUE if the move was successful
+ */
+BOOL stmi_move(STREAM_ITERATOR *si, long long num_chars);
+
+/*
+ * stmi_move_next() -	Shifts the marker one character to the right
+ * @si:					the iterator object
+ *
+ * Returns TRUE if the move was successful
+ */
+BOOL stmi_move_next(STREAM_ITERATOR *si);
+
+/*
+ * stmi_move_prev() -	Shifts the marker one character to the left
+ * @si:					the iterator object
+ *
+ * Returns TRUE if the move was successful
+ */
+BOOL stmi_move_prev(STREAM_ITERATOR *si);
+
+/*
+ * stmi_move_until() -	Shifts the marker right until one of the given characters is found
+ * @si:					the iterator object
+ * @chars:				the list of characters to stop at
+ *
+ * Returns the marker position after the shift
+ */
+long long stmi_move_until(STREAM_ITERATOR *si, const char *chars);
+
+/*
+ * stmi_move_while() -	Shifts the marker right until a character not among the given characters is found
+ * @si:					the iterator object
+ * @chars:				the list of characters to skip over
+ *
+ * Returns the marker position after the shift
+ */
+long long stmi_move_while(STREAM_ITERATOR *si, const char *chars);
+
+/*
+ * stmi_move_until_charset() -	Shifts the marker right until a character belonging to a set is found
+ * @si:							the iterator object
+ * @cs:							the set of characters to stop at
+ *
+ * Returns the marker position after the shift
+ */
+long long stmi_move_until_charset(STREAM_ITERATOR *si, const CHARSET *cs);
+
+/*
+ * stmi_move_while_charset() -	Shifts the marker right until a character not belonging to a set is found
+ * @si:							the iterator object
+ * @cs:							the set of characters to skip over
+ *
+ * Returns the marker position after the shift
+ */
+long long stmi_move_while_charset(STREAM_ITERATOR *si, const CHARSET *cs);
+
+/*
+ * stmi_is_at_eos() -	Checks if the marker is at the end of the input
+ * @si:					the iterator object
+ *
+ * Returns TRUE if the marker is at the end else returns FALSE
+ */
+BOOL stmi_is_at_eos(STREAM_ITERATOR *si);
+
+/*
+ * stmi_mark() -	Sets the mark at the current marker position, keeping the characters from there in the window
+ * @si:				the iterator object
+ *
+ * Returns TRUE if successful
+ */
+BOOL stmi_mark(STREAM_ITERATOR *si);
+
+/*
+ * stmi_extract() -	Returns the characters between the mark and the marker
+ * @si:				the iterator object
+ *
+ * A span of up to half the window is always kept; a longer one may have been dropped.
+ * Returns a view into the window (valid until the marker next moves), {NULL, 0} if there is no mark
+ * or the span was dropped
+ */
+STRING_VIEW stmi_extract(const STREAM_ITERATOR *si);
+
+/*
+ * stmi_has_error() -	Checks if reading from the file descriptor failed
+ * @si:					the iterator object
+ *
+ * Returns TRUE if a read failed
+ */
+BOOL stmi_has_error(const STREAM_ITERATOR *si);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -0,0 +1,140 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strfreq.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRFREQ_H
+
+#define STRFREQ_H
+
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define WC_BLOCK_SIZE			65536
+
+/* definition of one entry of a word count table (word is NULL for an empty slot) */
+typedef struct {
+	char *word;
+	unsigned int length;
+	unsigned long long hash;
+	unsigned long long count;
+} WORD_COUNT;
+
+/* definition of WORD_COUNTS object (open-addressing hash table; words are stored in blocks that never move) */
+typedef struct {
+	WORD_COUNT *entries;
+	unsigned int capacity;
+	unsigned int count;
+	unsigned long long total;
+	char **blocks;
+	unsigned int block_count;
+	unsigned int block_capacity;
+	unsigned int block_used;
+} WORD_COUNTS;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * str_byte_histogram() -	Counts the occurrences of every byte value in a string
+ * @sobj:					the string
+ * @counts:					array of 256 counters which the counts are added to (clear it first for a fresh count)
+ *
+ * Returns TRUE if successful
+ */
+BOOL str_byte_histogram(const STRING *sobj, unsigned long long *counts);
+
+/*
+ * wc_dump() -	Frees memory allocated for a word count table
+ * @wc:			the table to free
+ */
+void wc_dump(WORD_COUNTS *wc);
+
+/*
+ * word_counts() -	Creates an empty word count table
+ *
+ * Returns a pointer to a new WORD_COUNTS object
+ */
+WORD_COUNTS* word_counts();
+
+/*
+ * wc_add() -	Adds to the count of a word
+ * @wc:			the table
+ * @word:		the characters of the word (copied into the table)
+ * @length:		the length of the word
+ * @count:		the amount to add
+ *
+ * Returns TRUE if successful
+ */
+BOOL wc_add(WORD_COUNTS *wc, const char *word, unsigned int length, unsigned long long count);
+
+/*
+ * wc_add_string() -	Counts the words of a string
+ * @wc:					the table
+ * @sobj:				the string
+ * @word_chars:			the characters words are made of; any other character separates words
+ *						(letters and digits if NULL)
+ *
+ * Returns TRUE if successful
+ */
+BOOL wc_add_string(WORD_COUNTS *wc, const STRING *sobj, const CHARSET *word_chars);
+
+/*
+ * wc_get() -	Returns the count of a word
+ * @wc:			the table
+ * @word:		the word
+ *
+ * Returns the count (0 if the word was never added)
+ */
+unsigned long long wc_get(const WORD_COUNTS *wc, const STRING *word);
+
+/*
+ * wc_merge() -	Adds the counts of one table to another
+ * @wc:			the table to add to
+ * @other:		the table to add
+ *
+ * Returns TRUE if successful
+ */
+BOOL wc_merge(WORD_COUNTS *wc, const WORD_COUNTS *other);
+
+/*
+ * str_word_counts() -	Counts the words of several strings, splitting the work across threads
+ * @texts:				array of strings
+ * @count:				the number of strings
+ * @word_chars:			the characters words are made of (letters and digits if NULL)
+ * @threads:			the number of threads (0 or 1 counts in the calling thread)
+ *
+ * The total text is cut into one shard per thread at word boundaries, so a single large string is split too;
+ * each thread counts into its own table and the tables are merged at the end. Returns a pointer to a new
+ * WORD_COUNTS object
+ */
+WORD_COUNTS* str_word_counts(const STRING **texts, unsigned int count, const CHARSET *word_chars, unsigned int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strglob.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRGLOB_H
+
+#define STRGLOB_H
+
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define GLOB_ATOM_LITERAL			-1
+#define GLOB_ATOM_ANY				-2
+
+/* definition of one segment of a pattern (the fixed-length run of atoms between two '*') */
+typedef struct {
+	unsigned int start;
+	unsigned int length;
+	BOOL literal;
+} GLOB_SEGMENT;
+
+/* definition of STR_GLOB object (a compiled pattern) */
+typedef struct {
+	char *literals;
+	int *atoms;
+	unsigned int atom_count;
+	GLOB_SEGMENT *segments;
+	unsigned int segment_count;
+	CHARSET *sets;
+	unsigned int set_count;
+} STR_GLOB;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * str_glob_match() -	Checks if a whole string matches a shell-style wildcard pattern
+ * @sobj:				the string
+ * @pattern:			the pattern: '*' matches any run of characters (including '/'), '?' any one character,
+ *						'[...]' one character of a set (ranges like 'a-z' allowed, '!' or '^' first negates it),
+ *						and '\' makes the next character literal
+ *
+ * Only the most recent '*' is ever retried, so no pattern takes more than O(string length * pattern length).
+ * Returns TRUE if the string matches
+ */
+BOOL str_glob_match(const STRING *sobj, const STRING *pattern);
+
+/*
+ * glob_dump() -	Frees memory allocated for a compiled pattern
+ * @glob:			the pattern to free
+ */
+void glob_dump(STR_GLOB *glob);
+
+/*
+ * str_glob() -	Compiles a wildcard pattern (same syntax as str_glob_match()) for repeated matching
+ * @pattern:	the pattern
+ *
+ * Returns a pointer to a new STR_GLOB object
+ */
+STR_GLOB* str_glob(const STRING *pattern);
+
+/*
+ * glob_match() -	Checks if a whole string matches a compiled pattern
+ * @glob:			the compiled pattern
+ * @sobj:			the string
+ *
+ * Returns TRUE if the string matches
+ */
+BOOL glob_match(const STR_GLOB *glob, const STRING *sobj);
+
+/*
+ * glob_match_view() -	Checks if a string view matches a compiled pattern
+ * @glob:				the compiled pattern
+ * @view:				the view
+ *
+ * Returns TRUE if the view matches
+ */
+BOOL glob_match_view(const STR_GLOB *glob, STRING_VIEW view);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
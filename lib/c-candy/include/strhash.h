@@ -0,0 +1,148 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strhash.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRHASH_H
+
+#define STRHASH_H
+
+#include <constants.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations (the same polynomial hash as str_hash()) */
+#define STRPH_BASE						31
+#define STRPH_MODULUS					1000000009U
+
+/* definition of STR_PREFIX_HASH object (prefix hashes and powers of the base over a string) */
+typedef struct {
+	const STRING *text;
+	unsigned int *prefix;
+	unsigned int *power;
+	unsigned int *inverse;
+	unsigned int length;
+} STR_PREFIX_HASH;
+
+/* definition of a window which repeats an earlier window of the same text */
+typedef struct {
+	unsigned int position;
+	unsigned int first;
+} STR_WINDOW_MATCH;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * strph_dump() -	Frees memory allocated for the prefix hashes (the hashed string is not freed)
+ * @ph:				the prefix hashes to free
+ */
+void strph_dump(STR_PREFIX_HASH *ph);
+
+/*
+ * strph() -	Precomputes the prefix hashes of a string in linear time
+ * @text:		the string to hash (must outlive the object and must not be modified)
+ *
+ * Returns a pointer to a new STR_PREFIX_HASH object
+ */
+STR_PREFIX_HASH* strph(const STRING *text);
+
+/*
+ * strph_hash() -	Computes the hash of a substring in constant time
+ * @ph:				the prefix hashes
+ * @start:			the starting index of the substring
+ * @end:			the ending index of the substring (exclusive)
+ *
+ * Returns the same value as str_hash() of the substring, or 0 if the range is invalid
+ */
+unsigned long long strph_hash(const STR_PREFIX_HASH *ph, unsigned int start, unsigned int end);
+
+/*
+ * strph_equals() -	Checks if two substrings of the hashed text are equal, without copying them
+ * @ph:				the prefix hashes
+ * @i:				the starting index of the first substring
+ * @j:				the starting index of the second substring
+ * @length:			the length of both substrings
+ *
+ * Returns TRUE if the substrings are equal; differing hashes reject in constant time, equal ones are confirmed byte by byte
+ */
+BOOL strph_equals(const STR_PREFIX_HASH *ph, unsigned int i, unsigned int j, unsigned int length);
+
+/*
+ * strph_common_prefix() -	Computes the length of the common prefix of two suffixes of the hashed text
+ * @ph:						the prefix hashes
+ * @i:						the starting index of the first suffix
+ * @j:						the starting index of the second suffix
+ *
+ * Returns the length found by binary search over substring hashes, in O(log n)
+ */
+unsigned int strph_common_prefix(const STR_PREFIX_HASH *ph, unsigned int i, unsigned int j);
+
+/*
+ * strph_compare() -	Compares two substrings of the hashed text lexicographically, without copying them
+ * @ph:					the prefix hashes
+ * @i:					the starting index of the first substring
+ * @j:					the starting index of the second substring
+ * @length:				the length of both substrings
+ *
+ * Returns 0 if the substrings are equal, a negative value if the first is smaller, or a positive value if it is larger
+ */
+int strph_compare(const STR_PREFIX_HASH *ph, unsigned int i, unsigned int j, unsigned int length);
+
+/*
+ * strph_find() -	Finds the first occurrence of a string in the hashed text at or after a position (Rabin-Karp)
+ * @ph:				the prefix hashes
+ * @match:			the string to look for
+ * @start:			the position to start searching from
+ *
+ * Returns the index of the first occurrence, or -1 if it is not found
+ */
+int strph_find(const STR_PREFIX_HASH *ph, const STRING *match, unsigned int start);
+
+/*
+ * strph_find_any() -	Finds the first occurrence of any of several strings, of any lengths, in the hashed text
+ * @ph:					the prefix hashes
+ * @matches:			the strings to look for
+ * @count:				the number of strings
+ * @which:				pointer to an integer where the index (in @matches) of the string found is stored (may be NULL)
+ *
+ * Returns the smallest index at which any of the strings occurs (ties go to the string listed first), or -1 if none is found
+ */
+int strph_find_any(const STR_PREFIX_HASH *ph, const STRING **matches, unsigned int count, int *which);
+
+/*
+ * strph_duplicate_windows() -	Finds every window of a fixed length which repeats an earlier window of the hashed text
+ * @ph:							the prefix hashes
+ * @window:						the length of the windows
+ * @matches:					pointer which receives a new array of the repeated windows in ascending order of position,
+ *								each paired with the position of the first window with the same contents (NULL if none)
+ *
+ * Returns the number of repeated windows, or -1 on failure
+ */
+int strph_duplicate_windows(const STR_PREFIX_HASH *ph, unsigned int window, STR_WINDOW_MATCH **matches);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
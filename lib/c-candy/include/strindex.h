@@ -0,0 +1,123 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strindex.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRINDEX_H
+
+#define STRINDEX_H
+
+#include <stdio.h>
+#include <constants.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define STRIDX_FILE_MAGIC				"CCSTRIDX"
+#define STRIDX_FILE_VERSION				1
+
+/* definition of STR_INDEX object (suffix array and LCP array over a string) */
+typedef struct {
+	const STRING *text;
+	unsigned int *sa;
+	unsigned int *lcp;
+	unsigned int length;
+} STR_INDEX;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * stridx_dump() -	Frees memory allocated for the index (the indexed string is not freed)
+ * @idx:			the index to free
+ */
+void stridx_dump(STR_INDEX *idx);
+
+/*
+ * stridx() -	Builds a suffix array and LCP array over a string in linear time
+ * @text:		the string to index (must outlive the index and must not be modified)
+ *
+ * Returns a pointer to a new STR_INDEX object
+ */
+STR_INDEX* stridx(const STRING *text);
+
+/*
+ * stridx_count() -	Counts the occurrences (including overlapping ones) of a string in the indexed text
+ * @idx:			the index
+ * @match:			the string to look for
+ *
+ * Returns the number of occurrences, or -1 on failure
+ */
+int stridx_count(const STR_INDEX *idx, const STRING *match);
+
+/*
+ * stridx_find() -	Finds the first occurrence of a string in the indexed text
+ * @idx:			the index
+ * @match:			the string to look for
+ *
+ * Returns the smallest index at which the string occurs, or -1 if it is not found
+ */
+int stridx_find(const STR_INDEX *idx, const STRING *match);
+
+/*
+ * stridx_find_all() -	Finds all occurrences (including overlapping ones) of a string in the indexed text
+ * @idx:				the index
+ * @match:				the string to look for
+ * @indices:			pointer which receives a new array of the positions in ascending order (NULL if none)
+ *
+ * Returns the number of occurrences, or -1 on failure
+ */
+int stridx_find_all(const STR_INDEX *idx, const STRING *match, unsigned int **indices);
+
+/*
+ * stridx_longest_repeat() -	Finds the longest substring which occurs at least twice in the indexed text
+ * @idx:						the index
+ * @position:					pointer to an integer where a position of the substring is stored (may be NULL)
+ *
+ * Returns the length of the longest repeated substring (0 if no character repeats)
+ */
+unsigned int stridx_longest_repeat(const STR_INDEX *idx, unsigned int *position);
+
+/*
+ * stridx_save() -	Writes the index to a stream so that it can be reloaded without being rebuilt
+ * @idx:			the index
+ * @fp:				the stream to write to
+ *
+ * Returns TRUE if successful
+ */
+BOOL stridx_save(const STR_INDEX *idx, FILE *fp);
+
+/*
+ * stridx_load() -	Reads an index written by stridx_save()
+ * @text:			the string the index was built over
+ * @fp:				the stream to read from
+ *
+ * Returns a pointer to a new STR_INDEX object, or NULL if the stream does not hold an index of @text
+ */
+STR_INDEX* stridx_load(const STRING *text, FILE *fp);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
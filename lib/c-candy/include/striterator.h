@@ -25,6 +25,8 @@
 #define STRITERATOR_H
 
 #include <constants.h>
+#include <charset.h>
+#include <str.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,16 +35,27 @@ extern "C" {
 #define STRI_BOS				 0
 #define STRI_EOS				-1
 
+#define STRI_FORWARD			 1
+#define STRI_BACKWARD			-1
+
 /* definition of STRING_ITERATOR object */
 typedef struct {
-	STRING *data;
+	STRING *data;			/* copy owned by the iterator, NULL when borrowing */
 	int marker;
+	const char *chars;		/* the characters iterated over */
+	int length;
 } STRING_ITERATOR;
 
+/* definition of STRI_SPAN object (the characters in [start, end) consumed by a scan) */
+typedef struct {
+	int start;
+	int end;
+} STRI_SPAN;
+
 /* <------------------------------ function declarations --------------------------------> */
 
 /*
- * stri_dump() -	Frees memory allocated for the iterator
+ * stri_dump() -	Frees memory allocated for the iterator (only for iterators returned by stri() and stri_cs())
  * @s:				the iterator object to free
  */
 void stri_dump(STRING_ITERATOR *s);
@@ -63,6 +76,34 @@ STRING_ITERATOR* stri_cs(const char *s);
  */
 STRING_ITERATOR* stri(const STRING *s);
 
+/*
+ * stri_init() -	Initializes an iterator borrowing the characters of a C-Candy String object
+ * @s:				the iterator object to initialize (may be on the stack)
+ * @src:			the string to iterate over, which must outlive the iterator
+ *
+ * Returns TRUE if successful
+ */
+BOOL stri_init(STRING_ITERATOR *s, const STRING *src);
+
+/*
+ * stri_init_view() -	Initializes an iterator borrowing the characters of a view
+ * @s:					the iterator object to initialize (may be on the stack)
+ * @view:				the view to iterate over, whose buffer must outlive the iterator
+ *
+ * Returns TRUE if successful
+ */
+BOOL stri_init_view(STRING_ITERATOR *s, STRING_VIEW view);
+
+/*
+ * stri_init_chars() -	Initializes an iterator borrowing a character buffer
+ * @s:					the iterator object to initialize (may be on the stack)
+ * @chars:				the characters to iterate over, which must outlive the iterator
+ * @length:				the number of characters
+ *
+ * Returns TRUE if successful
+ */
+BOOL stri_init_chars(STRING_ITERATOR *s, const char *chars, unsigned int length);
+
 /*
  * stri_this() -	Returns the character at the current marker position
  * @s:				the iterator object
@@ -173,6 +214,57 @@ int stri_move_until(STRING_ITERATOR *s, const char *chars, int step);
  */
 int stri_move_while(STRING_ITERATOR *s, const char *chars, int step);
 
+/*
+ * stri_move_until_charset() -	Shifts the marker until a character belonging to a set is found
+ * @s:							the iterator object
+ * @cs:							the set of characters to stop at
+ * @step:						the number of characters to move the marker at a time during each check
+ *
+ * Returns the marker position after the shift
+ */
+int stri_move_until_charset(STRING_ITERATOR *s, const CHARSET *cs, int step);
+
+/*
+ * stri_move_while_charset() -	Shifts the marker until a character not belonging to a set is found
+ * @s:							the iterator object
+ * @cs:							the set of characters to skip over
+ * @step:						the number of characters to move the marker at a time during each check
+ *
+ * Returns the marker position after the shift
+ */
+int stri_move_while_charset(STRING_ITERATOR *s, const CHARSET *cs, int step);
+
+/*
+ * stri_scan_while() -	Moves the marker over a run of characters belonging to a set, using SIMD where available
+ * @s:					the iterator object
+ * @cs:					the set of characters to skip over
+ * @direction:			STRI_FORWARD to consume characters from the marker onwards, or STRI_BACKWARD to
+ *						consume the characters before the marker
+ *
+ * Returns the span of characters consumed, {-1, -1} on error
+ */
+STRI_SPAN stri_scan_while(STRING_ITERATOR *s, const CHARSET *cs, int direction);
+
+/*
+ * stri_scan_until() -	Moves the marker over a run of characters not belonging to a set, using SIMD where available
+ * @s:					the iterator object
+ * @cs:					the set of characters to stop at
+ * @direction:			STRI_FORWARD to consume characters from the marker onwards, or STRI_BACKWARD to
+ *						consume the characters before the marker
+ *
+ * Returns the span of characters consumed, {-1, -1} on error
+ */
+STRI_SPAN stri_scan_until(STRING_ITERATOR *s, const CHARSET *cs, int direction);
+
+/*
+ * stri_span_view() -	Returns the characters of a span as a view into the iterated characters
+ * @s:					the iterator object
+ * @span:				the span, as returned by stri_scan_while() or stri_scan_until()
+ *
+ * Returns a view of the span, {NULL, 0} if the span is invalid
+ */
+STRING_VIEW stri_span_view(const STRING_ITERATOR *s, STRI_SPAN span);
+
 /*
  * stri_is_at_eos() -	Checks if the marker is at the end of the string
  * @s:					the iterator object
@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strlexer.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRLEXER_H
+
+#define STRLEXER_H
+
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <striterator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define LEXER_ERROR					-1
+#define LEXER_SKIP					-2
+#define LEXER_MAX_STATES			65536
+
+/* definition of a node of the NFA the rules are compiled into */
+typedef struct {
+	CHARSET set;			/* characters consumed by a character node */
+	BOOL is_char;
+	int out1;				/* next node (-1 if none) */
+	int out2;				/* second next node of an epsilon node (-1 if none) */
+	int rule;				/* rule accepted on reaching this node (-1 if none) */
+} LEX_NFA_NODE;
+
+/* definition of LEXER_BUILDER object (the token rules of a lexer being defined) */
+typedef struct {
+	LEX_NFA_NODE *nodes;
+	unsigned int node_count;
+	unsigned int node_capacity;
+	int *starts;			/* the first node of every rule */
+	int *types;				/* the token type of every rule */
+	unsigned int rule_count;
+	unsigned int rule_capacity;
+} LEXER_BUILDER;
+
+/* definition of LEXER object (a compiled DFA; state 0 is dead and state 1 is the start) */
+typedef struct {
+	unsigned char classes[256];		/* the equivalence class of every byte */
+	unsigned int class_count;
+	unsigned int *next;				/* next[state * class_count + class] */
+	int *accept;					/* token type accepted in every state, LEXER_ERROR if none */
+	unsigned int state_count;
+} LEXER;
+
+/* definition of LEX_TOKEN object (a token type and the characters in [start, end) it covers) */
+typedef struct {
+	int type;
+	int start;
+	int end;
+} LEX_TOKEN;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * lb_dump() -	Frees memory allocated for a lexer builder
+ * @lb:			the builder to free
+ */
+void lb_dump(LEXER_BUILDER *lb);
+
+/*
+ * lexer_builder() -	Creates a lexer builder with no rules
+ *
+ * Returns a pointer to a new LEXER_BUILDER object
+ */
+LEXER_BUILDER* lexer_builder();
+
+/*
+ * lb_add_literal() -	Adds a rule matching a fixed string
+ * @lb:					the builder
+ * @literal:			the characters to match
+ * @type:				the token type (>= 0), or LEXER_SKIP to drop matches
+ *
+ * Returns TRUE if successful
+ */
+BOOL lb_add_literal(LEXER_BUILDER *lb, const char *literal, int type);
+
+/*
+ * lb_add_charset() -	Adds a rule matching one character of a set, or a run of them
+ * @lb:					the builder
+ * @cs:					the set of characters
+ * @repeat:				TRUE to match a run of one or more characters
+ * @type:				the token type (>= 0), or LEXER_SKIP to drop matches
+ *
+ * Returns TRUE if successful
+ */
+BOOL lb_add_charset(LEXER_BUILDER *lb, const CHARSET *cs, BOOL repeat, int type);
+
+/*
+ * lb_add_regex() -	Adds a rule matching a simple regular expression
+ * @lb:				the builder
+ * @pattern:		the expression: literal characters, '.' (any character but newline), '[...]' sets (ranges like
+ *					'a-z' allowed, '^' first negates it), the classes \d \w \s and their negations \D \W \S,
+ *					the escapes \n \r \t, '(...)' groups, '|' alternation and the postfix operators '*', '+' and '?';
+ *					'\' makes any other character literal
+ * @type:			the token type (>= 0), or LEXER_SKIP to drop matches
+ *
+ * Returns TRUE if successful, FALSE if the expression is malformed
+ */
+BOOL lb_add_regex(LEXER_BUILDER *lb, const char *pattern, int type);
+
+/*
+ * lb_compile() -	Compiles the rules of a builder into a lexer
+ * @lb:				the builder (which can be freed or extended afterwards)
+ *
+ * At every position the longest match wins, and among equally long matches the rule added first.
+ * Returns a pointer to a new LEXER object, NULL if the DFA would exceed LEXER_MAX_STATES states
+ */
+LEXER* lb_compile(const LEXER_BUILDER *lb);
+
+/*
+ * lexer_dump() -	Frees memory allocated for a lexer
+ * @lex:			the lexer to free
+ */
+void lexer_dump(LEXER *lex);
+
+/*
+ * lexer_next() -	Reads the next token at the marker of an iterator and moves the marker past it
+ * @lex:			the lexer
+ * @s:				the iterator (see stri_init_view() to lex a view)
+ * @token:			where to store the token; a character no rule matches becomes a one-character
+ *					token of type LEXER_ERROR, and matches of LEXER_SKIP rules are dropped
+ *
+ * Returns TRUE if a token was read, FALSE at the end of the string
+ */
+BOOL lexer_next(const LEXER *lex, STRING_ITERATOR *s, LEX_TOKEN *token);
+
+/*
+ * lexer_run() -	Reads tokens at the marker of an iterator into a buffer, moving the marker past them
+ * @lex:			the lexer
+ * @s:				the iterator (see stri_init_view() to lex a view)
+ * @tokens:			the buffer
+ * @capacity:		the number of tokens the buffer can hold
+ *
+ * Returns the number of tokens read; fewer than capacity means the end of the string was reached
+ */
+unsigned int lexer_run(const LEXER *lex, STRING_ITERATOR *s, LEX_TOKEN *tokens, unsigned int capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -0,0 +1,195 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strpipeline.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRPIPELINE_H
+
+#define STRPIPELINE_H
+
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations (kinds of pipeline stages) */
+#define STRP_STAGE_MAP					0
+#define STRP_STAGE_LSTRIP				1
+#define STRP_STAGE_RSTRIP				2
+#define STRP_STAGE_COLLAPSE				3
+#define STRP_STAGE_EXPAND_TABS			4
+
+/* definition of a pipeline stage; consecutive byte-to-byte stages are fused into one MAP stage */
+typedef struct {
+	int kind;
+	short map[256];
+	CHARSET set;
+	char replacement;
+	unsigned int tab_size;
+} STR_PIPELINE_STAGE;
+
+/* definition of STR_PIPELINE object */
+typedef struct {
+	STR_PIPELINE_STAGE *stages;
+	unsigned int count;
+	unsigned int capacity;
+} STR_PIPELINE;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * strp_dump() -	Frees memory allocated for the pipeline
+ * @pipe:			the pipeline to free
+ */
+void strp_dump(STR_PIPELINE *pipe);
+
+/*
+ * str_pipeline() -	Creates an empty pipeline (which copies its input unchanged)
+ *
+ * Returns a pointer to a new STR_PIPELINE object
+ */
+STR_PIPELINE* str_pipeline();
+
+/*
+ * strp_strip() -	Adds a stage removing characters from both ends
+ * @pipe:			the pipeline
+ * @cs:				the characters to remove, or NULL for whitespace
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_strip(STR_PIPELINE *pipe, const CHARSET *cs);
+
+/*
+ * strp_lstrip() -	Adds a stage removing characters from the start
+ * @pipe:			the pipeline
+ * @cs:				the characters to remove, or NULL for whitespace
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_lstrip(STR_PIPELINE *pipe, const CHARSET *cs);
+
+/*
+ * strp_rstrip() -	Adds a stage removing characters from the end
+ * @pipe:			the pipeline
+ * @cs:				the characters to remove, or NULL for whitespace
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_rstrip(STR_PIPELINE *pipe, const CHARSET *cs);
+
+/*
+ * strp_to_lower() -	Adds a stage converting uppercase letters to lowercase
+ * @pipe:				the pipeline
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_to_lower(STR_PIPELINE *pipe);
+
+/*
+ * strp_to_upper() -	Adds a stage converting lowercase letters to uppercase
+ * @pipe:				the pipeline
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_to_upper(STR_PIPELINE *pipe);
+
+/*
+ * strp_swap_case() -	Adds a stage swapping the case of letters
+ * @pipe:				the pipeline
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_swap_case(STR_PIPELINE *pipe);
+
+/*
+ * strp_replace_char() -	Adds a stage replacing every occurrence of one character with another
+ * @pipe:					the pipeline
+ * @find:					the character to replace
+ * @replace_with:			the character to put in its place
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_replace_char(STR_PIPELINE *pipe, char find, char replace_with);
+
+/*
+ * strp_keep() -	Adds a stage dropping every character which is not in a set
+ * @pipe:			the pipeline
+ * @cs:				the characters to keep
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_keep(STR_PIPELINE *pipe, const CHARSET *cs);
+
+/*
+ * strp_remove() -	Adds a stage dropping every character in a set
+ * @pipe:			the pipeline
+ * @cs:				the characters to drop
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_remove(STR_PIPELINE *pipe, const CHARSET *cs);
+
+/*
+ * strp_expand_tabs() -	Adds a stage replacing every tab with spaces, like str_expand_tabs()
+ * @pipe:				the pipeline
+ * @tab_size:			the number of spaces per tab
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_expand_tabs(STR_PIPELINE *pipe, unsigned int tab_size);
+
+/*
+ * strp_collapse() -	Adds a stage replacing every run of characters from a set with a single character
+ * @pipe:				the pipeline
+ * @cs:					the characters forming runs, or NULL for whitespace
+ * @replacement:		the character each run is replaced with
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_collapse(STR_PIPELINE *pipe, const CHARSET *cs, char replacement);
+
+/*
+ * strp_run() -	Runs a string through the pipeline in a single pass
+ * @pipe:		the pipeline
+ * @sobj:		the string to transform
+ *
+ * Returns a pointer to a new STRING object holding the result
+ */
+STRING* strp_run(const STR_PIPELINE *pipe, const STRING *sobj);
+
+/*
+ * strp_run_append() -	Runs a string through the pipeline, appending the result to an existing string
+ * @pipe:				the pipeline
+ * @out:				the string to append to (modified in-place; must not be @sobj)
+ * @sobj:				the string to transform
+ *
+ * Returns TRUE if successful
+ */
+BOOL strp_run_append(const STR_PIPELINE *pipe, STRING *out, const STRING *sobj);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strsketch.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRSKETCH_H
+
+#define STRSKETCH_H
+
+#include <constants.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* definition of MINHASH object (the minimum of each of several hash functions over the shingles of a string) */
+typedef struct {
+	unsigned long long *values;
+	unsigned int size;
+} MINHASH;
+
+/* definition of the buckets of one LSH band (chained hash table over the band keys of the sketches added) */
+typedef struct {
+	unsigned long long *keys;
+	unsigned int *ids;
+	unsigned int *next;
+	unsigned int *heads;
+	unsigned int mask;
+} LSH_BAND;
+
+/* definition of LSH_INDEX object */
+typedef struct {
+	LSH_BAND *bands;
+	unsigned int band_count;
+	unsigned int rows;
+	unsigned int count;
+	unsigned int capacity;
+} LSH_INDEX;
+
+/* definition of a pair of ids sharing at least one band (first < second) */
+typedef struct {
+	unsigned int first;
+	unsigned int second;
+} LSH_PAIR;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * str_shingle_hashes() -	Computes a 64-bit hash of every shingle (overlapping run of characters or words) of a string
+ * @sobj:					the string
+ * @shingle_size:			the number of characters (or words) per shingle
+ * @words:					TRUE for shingles of whitespace-separated words, FALSE for shingles of characters
+ * @hashes:					pointer which receives a new array of the hashes, in order (NULL if there are none)
+ *
+ * A string shorter than one shingle forms a single shingle. Returns the number of shingles, or -1 on failure
+ */
+int str_shingle_hashes(const STRING *sobj, unsigned int shingle_size, BOOL words, unsigned long long **hashes);
+
+/*
+ * minhash_dump() -	Frees memory allocated for a MinHash sketch
+ * @mh:				the sketch to free
+ */
+void minhash_dump(MINHASH *mh);
+
+/*
+ * minhash() -		Computes the MinHash sketch of the shingles of a string
+ * @sobj:			the string
+ * @size:			the number of hash functions (sketches are only comparable if they have the same size)
+ * @shingle_size:	the number of characters (or words) per shingle
+ * @words:			TRUE for shingles of words, FALSE for shingles of characters
+ *
+ * Returns a pointer to a new MINHASH object
+ */
+MINHASH* minhash(const STRING *sobj, unsigned int size, unsigned int shingle_size, BOOL words);
+
+/*
+ * minhash_similarity() -	Estimates the Jaccard similarity of the shingle sets of two strings from their sketches
+ * @mh1:					the first sketch
+ * @mh2:					the second sketch
+ *
+ * Returns the fraction of equal sketch values (0.0 to 1.0), or -1.0 if the sketches have different sizes
+ */
+double minhash_similarity(const MINHASH *mh1, const MINHASH *mh2);
+
+/*
+ * str_simhash() -	Computes the 64-bit SimHash fingerprint of the shingles of a string
+ * @sobj:			the string
+ * @shingle_size:	the number of characters (or words) per shingle
+ * @words:			TRUE for shingles of words, FALSE for shingles of characters
+ *
+ * Returns the fingerprint; similar strings have fingerprints differing in few bits
+ */
+unsigned long long str_simhash(const STRING *sobj, unsigned int shingle_size, BOOL words);
+
+/*
+ * simhash_distance() -	Returns the number of bits in which two SimHash fingerprints differ
+ * @h1:					the first fingerprint
+ * @h2:					the second fingerprint
+ *
+ * Returns the Hamming distance (0 to 64)
+ */
+int simhash_distance(unsigned long long h1, unsigned long long h2);
+
+/*
+ * lsh_dump() -	Frees memory allocated for an LSH index
+ * @lsh:		the index to free
+ */
+void lsh_dump(LSH_INDEX *lsh);
+
+/*
+ * lsh_index() -	Creates an empty LSH banding index over MinHash sketches
+ * @bands:			the number of bands
+ * @rows:			the number of sketch values per band (sketches added must have at least bands * rows values)
+ *
+ * Two sketches become candidates if all values of at least one band agree; with Jaccard similarity s this
+ * happens with probability 1 - (1 - s^rows)^bands. Returns a pointer to a new LSH_INDEX object
+ */
+LSH_INDEX* lsh_index(unsigned int bands, unsigned int rows);
+
+/*
+ * lsh_add() -	Adds a sketch to the index
+ * @lsh:		the index
+ * @mh:			the sketch (it is not kept by the index)
+ * @id:			the id to report the sketch by
+ *
+ * Returns TRUE if successful
+ */
+BOOL lsh_add(LSH_INDEX *lsh, const MINHASH *mh, unsigned int id);
+
+/*
+ * lsh_query() -	Finds the ids of the sketches sharing at least one band with a sketch
+ * @lsh:			the index
+ * @mh:				the sketch to look up
+ * @ids:			pointer which receives a new array of the ids in ascending order (NULL if none)
+ *
+ * Returns the number of ids, or -1 on failure
+ */
+int lsh_query(const LSH_INDEX *lsh, const MINHASH *mh, unsigned int **ids);
+
+/*
+ * lsh_candidate_pairs() -	Finds every pair of sketches in the index sharing at least one band
+ * @lsh:					the index
+ * @pairs:					pointer which receives a new array of the pairs, sorted and without repeats (NULL if none)
+ *
+ * Returns the number of pairs, or -1 on failure
+ */
+int lsh_candidate_pairs(const LSH_INDEX *lsh, LSH_PAIR **pairs);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
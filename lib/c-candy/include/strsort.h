@@ -0,0 +1,63 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strsort.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRSORT_H
+
+#define STRSORT_H
+
+#include <constants.h>
+#include <str.h>
+#include <list.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * str_sort() -		Sorts an array of strings in-place in lexicographic (byte) order
+ * @items:			the array of string objects (NULL entries sort as empty strings)
+ * @count:			the number of strings in the array
+ * @reverse:		TRUE to sort in descending order
+ * @ignore_case:	TRUE to sort in unsigned byte order with ASCII letters folded to uppercase
+ *
+ * Returns TRUE if successful
+ */
+BOOL str_sort(STRING **items, unsigned int count, BOOL reverse, BOOL ignore_case);
+
+/*
+ * str_sort_list() -	Sorts a list of strings in-place in lexicographic (byte) order
+ * @list:				a TYPE_OBJECT list of STRING objects
+ * @reverse:			TRUE to sort in descending order
+ * @ignore_case:		TRUE to sort in unsigned byte order with ASCII letters folded to uppercase
+ *
+ * Returns TRUE if successful
+ */
+BOOL str_sort_list(LIST *list, BOOL reverse, BOOL ignore_case);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
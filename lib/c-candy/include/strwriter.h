@@ -0,0 +1,129 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/include/strwriter.h
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* start of include guard */
+#ifndef STRWRITER_H
+
+#define STRWRITER_H
+
+#include <stddef.h>
+#include <sys/uio.h>
+#include <constants.h>
+#include <str.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* constant declarations */
+#define STRW_DEFAULT_BUFFER_SIZE			65536
+#define STRW_COPY_THRESHOLD					512
+#define STRW_MAX_IOV						1024
+
+/* definition of STR_WRITER object */
+typedef struct {
+	int fd;
+	struct iovec *iov;
+	unsigned int iov_count;
+	char *buffer;
+	size_t capacity;
+	size_t used;
+	size_t copy_threshold;
+	unsigned long long bytes_written;
+	unsigned long long syscalls;
+	BOOL error;
+} STR_WRITER;
+
+/* <------------------------------ function declarations --------------------------------> */
+
+/*
+ * strw_dump() -	Flushes the writer and frees memory allocated for it (the file descriptor is not closed)
+ * @sw:				the writer to free
+ *
+ * Call strw_flush() first to find out whether the last write succeeded
+ */
+void strw_dump(STR_WRITER *sw);
+
+/*
+ * str_writer() -	Creates a writer which batches strings into writev() calls on a file descriptor
+ * @fd:				the file descriptor to write to
+ * @buffer_size:	size of the buffer small strings are copied into (0 for no buffer, in which case every string is
+ *					written from where it lies; STRW_DEFAULT_BUFFER_SIZE is a good choice otherwise)
+ *
+ * Strings shorter than STRW_COPY_THRESHOLD are copied into the buffer, adjacent copies forming a single
+ * block; longer strings (and all strings without a buffer) are not copied, so they must stay unchanged until
+ * the next flush. Returns a pointer to a new STR_WRITER object
+ */
+STR_WRITER* str_writer(int fd, size_t buffer_size);
+
+/*
+ * strw_write() -	Queues a string for writing
+ * @sw:				the writer
+ * @sobj:			the string
+ *
+ * Returns TRUE if successful
+ */
+BOOL strw_write(STR_WRITER *sw, const STRING *sobj);
+
+/*
+ * strw_write_view() -	Queues a string view for writing
+ * @sw:					the writer
+ * @view:				the view
+ *
+ * Returns TRUE if successful
+ */
+BOOL strw_write_view(STR_WRITER *sw, STRING_VIEW view);
+
+/*
+ * strw_write_chars() -	Queues a range of characters for writing
+ * @sw:					the writer
+ * @data:				the characters
+ * @length:				the number of characters
+ *
+ * Returns TRUE if successful
+ */
+BOOL strw_write_chars(STR_WRITER *sw, const char *data, size_t length);
+
+/*
+ * strw_write_all() -	Queues several strings for writing, with an optional separator after each
+ * @sw:					the writer
+ * @items:				array of strings (NULL items are skipped)
+ * @count:				the number of strings
+ * @terminator:			string written after every item, e.g. a newline (nothing if NULL)
+ *
+ * Returns TRUE if successful
+ */
+BOOL strw_write_all(STR_WRITER *sw, const STRING **items, unsigned int count, const STRING *terminator);
+
+/*
+ * strw_flush() -	Writes out everything queued, resuming after partial writes
+ * @sw:				the writer
+ *
+ * Returns TRUE if successful; on failure the queued data is dropped and the error flag is set
+ */
+BOOL strw_flush(STR_WRITER *sw);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of include guard */
+#endif
@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/charset.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <constants.h>
+#include <charset.h>
+
+/* <------------------ public constant definitions ------------------> */
+
+/* " \t\n\r\v\f" */
+const CHARSET CHARSET_WHITESPACE	= { { 0x00003E00, 0x00000001, 0, 0, 0, 0, 0, 0 } };
+
+/* '0' to '9' */
+const CHARSET CHARSET_DIGITS		= { { 0, 0x03FF0000, 0, 0, 0, 0, 0, 0 } };
+
+/* 'A' to 'Z' and 'a' to 'z' */
+const CHARSET CHARSET_ALPHA			= { { 0, 0, 0x07FFFFFE, 0x07FFFFFE, 0, 0, 0, 0 } };
+
+/* '0' to '9', 'A' to 'Z' and 'a' to 'z' */
+const CHARSET CHARSET_ALPHANUMERIC	= { { 0, 0x03FF0000, 0x07FFFFFE, 0x07FFFFFE, 0, 0, 0, 0 } };
+
+/* 'A' to 'Z' */
+const CHARSET CHARSET_UPPER			= { { 0, 0, 0x07FFFFFE, 0, 0, 0, 0, 0 } };
+
+/* 'a' to 'z' */
+const CHARSET CHARSET_LOWER			= { { 0, 0, 0, 0x07FFFFFE, 0, 0, 0, 0 } };
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for a character set */
+void charset_dump(CHARSET *cs)
+{
+	free(cs);
+}
+
+/* creates a character set from the characters of a C-style string */
+CHARSET* charset(const char *chars)
+{
+	CHARSET *cs;
+
+	cs = (CHARSET*)malloc(sizeof(CHARSET));
+	if(cs == NULL) return NULL;
+
+	charset_init(cs, chars);
+	return cs;
+}
+
+/* creates a character set from an inclusive range of characters */
+CHARSET* charset_range(unsigned char first, unsigned char last)
+{
+	CHARSET *cs;
+
+	cs = (CHARSET*)malloc(sizeof(CHARSET));
+	if(cs == NULL) return NULL;
+
+	charset_clear(cs);
+	charset_add_range(cs, first, last);
+	return cs;
+}
+
+/* initializes a caller-allocated character set */
+void charset_init(CHARSET *cs, const char *chars)
+{
+	if(cs == NULL) return;
+	charset_clear(cs);
+	charset_add(cs, chars);
+}
+
+/* removes all members from a character set */
+void charset_clear(CHARSET *cs)
+{
+	if(cs != NULL) memset(cs->bits, 0, sizeof(cs->bits));
+}
+
+/* adds the characters of a C-style string to a set */
+void charset_add(CHARSET *cs, const char *chars)
+{
+	const unsigned char *p;
+
+	if(cs == NULL || chars == NULL) return;
+	for(p = (const unsigned char*)chars; *p != '\0'; ++p)
+		cs->bits[*p >> 5] |= 1U << (*p & 31);
+}
+
+/* adds an inclusive range of characters to a set */
+void charset_add_range(CHARSET *cs, unsigned char first, unsigned char last)
+{
+	unsigned int c;
+
+	if(cs == NULL) return;
+	for(c = first; c <= last; ++c)
+		cs->bits[c >> 5] |= 1U << (c & 31);
+}
+
+/* adds all members of another set to a set */
+void charset_union(CHARSET *cs, const CHARSET *other)
+{
+	int i;
+
+	if(cs == NULL || other == NULL) return;
+	for(i = 0; i < 8; ++i) cs->bits[i] |= other->bits[i];
+}
+
+/* replaces a set with its complement */
+void charset_invert(CHARSET *cs)
+{
+	int i;
+
+	if(cs == NULL) return;
+	for(i = 0; i < 8; ++i) cs->bits[i] = ~cs->bits[i];
+}
+
+/* checks if a character is a member of a set */
+BOOL charset_has(const CHARSET *cs, char c)
+{
+	if(cs == NULL) return FALSE;
+	return CHARSET_HAS(cs, c) ? TRUE : FALSE;
+}
@@ -0,0 +1,1261 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/codec.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <constants.h>
+#include <str.h>
+#include <codec.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CODEC_X86
+#include <immintrin.h>
+#endif
+
+/* <------------------ private constant declarations -----------------> */
+#define SIMD_NONE				0
+#define SIMD_SSE2				1
+#define SIMD_SSSE3				2
+#define SIMD_AVX2				3
+
+#define ESCAPE_JSON				0
+#define ESCAPE_C				1
+#define ESCAPE_URL				2
+#define ESCAPE_FORM				3
+
+static const char BASE64_STANDARD[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char BASE64_URL[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+static const char HEX_LOWER[] = "0123456789abcdef";
+static const char HEX_UPPER[] = "0123456789ABCDEF";
+
+/* value of every byte in the standard base64 alphabet, -1 if it is not part of it */
+static const signed char BASE64_STANDARD_VALUES[256] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+	-1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+	-1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/* value of every byte in the URL and filename safe base64 alphabet, -1 if it is not part of it */
+static const signed char BASE64_URL_VALUES[256] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+	-1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,
+	-1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+static int simd_level = -1;
+
+/* <------------------ private function declarations -----------------> */
+static int get_simd_level();
+static int hex_value(unsigned char c);
+static void base64_encode(const unsigned char *src, unsigned int n, char *dst, BOOL url_safe);
+static BOOL base64_decode(const char *src, unsigned int n, unsigned char *dst, BOOL url_safe);
+static void hex_encode(const unsigned char *src, unsigned int n, char *dst, BOOL upper);
+static BOOL hex_decode(const char *src, unsigned int n, unsigned char *dst);
+static unsigned int base64_decoded_length(const STRING *text, unsigned int *chars);
+static unsigned int find_special(int scheme, const unsigned char *s, unsigned int n);
+static unsigned int find_either(const char *s, unsigned int n, char a, char b);
+static BOOL is_special(int scheme, unsigned char c);
+static unsigned int escaped_length(int scheme, unsigned char c);
+static char* escape_byte(int scheme, unsigned char c, char *dst);
+static BOOL escape_append(STRING *sobj, const STRING *text, int scheme);
+static BOOL unescape_append(STRING *sobj, const STRING *text, int scheme);
+static char* put_utf8(unsigned long code, char *dst);
+static long read_hex(const char *s, unsigned int n);
+static const char* unescape_json(const char *src, const char *end, char **dst);
+static const char* unescape_c(const char *src, const char *end, char **dst);
+
+#ifdef CODEC_X86
+static unsigned int base64_encode_ssse3(const unsigned char *src, unsigned int n, char *dst, BOOL url_safe);
+static unsigned int base64_encode_avx2(const unsigned char *src, unsigned int n, char *dst, BOOL url_safe);
+static unsigned int base64_decode_ssse3(const char *src, unsigned int n, unsigned char *dst, BOOL url_safe);
+static unsigned int base64_decode_avx2(const char *src, unsigned int n, unsigned char *dst, BOOL url_safe);
+static unsigned int hex_encode_ssse3(const unsigned char *src, unsigned int n, char *dst, BOOL upper);
+static unsigned int hex_encode_avx2(const unsigned char *src, unsigned int n, char *dst, BOOL upper);
+static unsigned int hex_decode_ssse3(const char *src, unsigned int n, unsigned char *dst);
+static unsigned int hex_decode_avx2(const char *src, unsigned int n, unsigned char *dst);
+static unsigned int find_special_sse2(int scheme, const unsigned char *s, unsigned int n);
+static unsigned int find_either_sse2(const char *s, unsigned int n, char a, char b);
+static unsigned int find_special_avx2(int scheme, const unsigned char *s, unsigned int n);
+#endif
+
+/* <------------------ private function definitions ------------------> */
+
+/* detects (once) the widest instruction set the kernels can use on this CPU */
+static int get_simd_level()
+{
+	if(simd_level < 0) {
+#ifdef CODEC_X86
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx2"))
+			simd_level = SIMD_AVX2;
+		else if(__builtin_cpu_supports("ssse3"))
+			simd_level = SIMD_SSSE3;
+		else if(__builtin_cpu_supports("sse2"))
+			simd_level = SIMD_SSE2;
+		else
+			simd_level = SIMD_NONE;
+#else
+		simd_level = SIMD_NONE;
+#endif
+	}
+	return simd_level;
+}
+
+/* returns the value of a hexadecimal digit, or -1 */
+static int hex_value(unsigned char c)
+{
+	if(c >= '0' && c <= '9') return c - '0';
+	if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+#ifdef CODEC_X86
+
+/* maps 6-bit values to base64 characters (Mula's pshufb lookup) */
+__attribute__((target("ssse3")))
+static __m128i base64_chars_ssse3(__m128i indices, BOOL url_safe)
+{
+	__m128i result, less, shift_lut;
+
+	shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, (url_safe ? '-' : '+') - 62, (url_safe ? '_' : '/') - 63, 'A', 0, 0);
+
+	/* 0..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12, and then 0..25 -> 13 */
+	result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+	result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+
+	return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, result), indices);
+}
+
+/* encodes 12 bytes at a time; reads 16 bytes per step */
+__attribute__((target("ssse3")))
+static unsigned int base64_encode_ssse3(const unsigned char *src, unsigned int n, char *dst, BOOL url_safe)
+{
+	__m128i in, t0, t1, t2, t3;
+	unsigned int i;
+
+	for(i = 0; n - i >= 16; i += 12, dst += 16)
+	{
+		in = _mm_loadu_si128((const __m128i*)(src + i));
+
+		/* spread every 3 bytes over 4 lanes and extract the four 6-bit fields */
+		in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+		t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+		t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+		t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+
+		_mm_storeu_si128((__m128i*)dst, base64_chars_ssse3(_mm_or_si128(t1, t3), url_safe));
+	}
+	return i;
+}
+
+/* maps 6-bit values to base64 characters, 32 at a time */
+__attribute__((target("avx2")))
+static __m256i base64_chars_avx2(__m256i indices, BOOL url_safe)
+{
+	__m256i result, less, shift_lut;
+
+	shift_lut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, (url_safe ? '-' : '+') - 62, (url_safe ? '_' : '/') - 63, 'A', 0, 0,
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, (url_safe ? '-' : '+') - 62, (url_safe ? '_' : '/') - 63, 'A', 0, 0);
+
+	result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+	less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+	result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+
+	return _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, result), indices);
+}
+
+/* encodes 24 bytes at a time, one 12-byte group per 128-bit lane; reads 28 bytes per step */
+__attribute__((target("avx2")))
+static unsigned int base64_encode_avx2(const unsigned char *src, unsigned int n, char *dst, BOOL url_safe)
+{
+	__m256i in, t0, t1, t2, t3;
+	unsigned int i;
+
+	for(i = 0; n - i >= 28; i += 24, dst += 32)
+	{
+		in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(src + i))),
+			_mm_loadu_si128((const __m128i*)(src + i + 12)), 1);
+
+		in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+			10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+		t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+		t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+		t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+
+		_mm256_storeu_si256((__m256i*)dst, base64_chars_avx2(_mm256_or_si256(t1, t3), url_safe));
+	}
+	return i;
+}
+
+/*
+ * decodes 16 characters at a time into 12 bytes, stopping at the first block with an invalid character;
+ * each step stores 16 bytes, so at least 8 characters are always left for the caller to decode after it
+ */
+__attribute__((target("ssse3")))
+static unsigned int base64_decode_ssse3(const char *src, unsigned int n, unsigned char *dst, BOOL url_safe)
+{
+	__m128i in, upper, lower, digit, c62, c63, values, valid;
+	unsigned int i;
+
+	for(i = 0; n - i >= 24; i += 16, dst += 12)
+	{
+		in = _mm_loadu_si128((const __m128i*)(src + i));
+
+		/* bytes of 0x80 and above compare as negative and fall outside every range */
+		upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), in));
+		lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), in));
+		digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), in));
+		c62 = _mm_cmpeq_epi8(in, _mm_set1_epi8(url_safe ? '-' : '+'));
+		c63 = _mm_cmpeq_epi8(in, _mm_set1_epi8(url_safe ? '_' : '/'));
+
+		valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(c62, c63)));
+		if(_mm_movemask_epi8(valid) != 0xFFFF) break;
+
+		values = _mm_and_si128(upper, _mm_sub_epi8(in, _mm_set1_epi8(65)));
+		values = _mm_or_si128(values, _mm_and_si128(lower, _mm_sub_epi8(in, _mm_set1_epi8(71))));
+		values = _mm_or_si128(values, _mm_and_si128(digit, _mm_add_epi8(in, _mm_set1_epi8(4))));
+		values = _mm_or_si128(values, _mm_and_si128(c62, _mm_set1_epi8(62)));
+		values = _mm_or_si128(values, _mm_and_si128(c63, _mm_set1_epi8(63)));
+
+		/* merge four 6-bit values into 24 bits and gather the three bytes of every lane */
+		values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+		values = _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+		values = _mm_shuffle_epi8(values, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+		_mm_storeu_si128((__m128i*)dst, values);
+	}
+	return i;
+}
+
+/* decodes 32 characters at a time into 24 bytes, with the same guarantees as base64_decode_ssse3() */
+__attribute__((target("avx2")))
+static unsigned int base64_decode_avx2(const char *src, unsigned int n, unsigned char *dst, BOOL url_safe)
+{
+	__m256i in, upper, lower, digit, c62, c63, values, valid;
+	unsigned int i;
+
+	for(i = 0; n - i >= 40; i += 32, dst += 24)
+	{
+		in = _mm256_loadu_si256((const __m256i*)(src + i));
+
+		upper = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), in));
+		lower = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), in));
+		digit = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), in));
+		c62 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(url_safe ? '-' : '+'));
+		c63 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(url_safe ? '_' : '/'));
+
+		valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(c62, c63)));
+		if((unsigned int)_mm256_movemask_epi8(valid) != 0xFFFFFFFFU) break;
+
+		values = _mm256_and_si256(upper, _mm256_sub_epi8(in, _mm256_set1_epi8(65)));
+		values = _mm256_or_si256(values, _mm256_and_si256(lower, _mm256_sub_epi8(in, _mm256_set1_epi8(71))));
+		values = _mm256_or_si256(values, _mm256_and_si256(digit, _mm256_add_epi8(in, _mm256_set1_epi8(4))));
+		values = _mm256_or_si256(values, _mm256_and_si256(c62, _mm256_set1_epi8(62)));
+		values = _mm256_or_si256(values, _mm256_and_si256(c63, _mm256_set1_epi8(63)));
+
+		values = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		values = _mm256_madd_epi16(values, _mm256_set1_epi32(0x00011000));
+		values = _mm256_shuffle_epi8(values, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+		/* each lane holds 12 bytes */
+		_mm_storeu_si128((__m128i*)dst, _mm256_castsi256_si128(values));
+		_mm_storeu_si128((__m128i*)(dst + 12), _mm256_extracti128_si256(values, 1));
+	}
+	return i;
+}
+
+/* encodes 16 bytes at a time into 32 hexadecimal digits */
+__attribute__((target("ssse3")))
+static unsigned int hex_encode_ssse3(const unsigned char *src, unsigned int n, char *dst, BOOL upper)
+{
+	__m128i in, lut, mask, hi, lo;
+	unsigned int i;
+
+	lut = _mm_loadu_si128((const __m128i*)(upper ? HEX_UPPER : HEX_LOWER));
+	mask = _mm_set1_epi8(0x0f);
+
+	for(i = 0; n - i >= 16; i += 16, dst += 32)
+	{
+		in = _mm_loadu_si128((const __m128i*)(src + i));
+		hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+		lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+
+		_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+	return i;
+}
+
+/* encodes 32 bytes at a time into 64 hexadecimal digits */
+__attribute__((target("avx2")))
+static unsigned int hex_encode_avx2(const unsigned char *src, unsigned int n, char *dst, BOOL upper)
+{
+	__m256i in, lut, mask, hi, lo, a, b;
+	unsigned int i;
+
+	lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(upper ? HEX_UPPER : HEX_LOWER)));
+	mask = _mm256_set1_epi8(0x0f);
+
+	for(i = 0; n - i >= 32; i += 32, dst += 64)
+	{
+		in = _mm256_loadu_si256((const __m256i*)(src + i));
+		hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+		lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, mask));
+
+		/* unpacking works within lanes, so the halves are put back in order afterwards */
+		a = _mm256_unpacklo_epi8(hi, lo);
+		b = _mm256_unpackhi_epi8(hi, lo);
+		_mm256_storeu_si256((__m256i*)dst, _mm256_permute2x128_si256(a, b, 0x20));
+		_mm256_storeu_si256((__m256i*)(dst + 32), _mm256_permute2x128_si256(a, b, 0x31));
+	}
+	return i;
+}
+
+/* decodes 16 hexadecimal digits at a time into 8 bytes, stopping at the first block with an invalid digit */
+__attribute__((target("ssse3")))
+static unsigned int hex_decode_ssse3(const char *src, unsigned int n, unsigned char *dst)
+{
+	__m128i in, digit, upper, lower, values;
+	unsigned int i;
+
+	for(i = 0; n - i >= 16; i += 16, dst += 8)
+	{
+		in = _mm_loadu_si128((const __m128i*)(src + i));
+
+		digit = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), in));
+		upper = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('F' + 1), in));
+		lower = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), in));
+		if(_mm_movemask_epi8(_mm_or_si128(digit, _mm_or_si128(upper, lower))) != 0xFFFF) break;
+
+		values = _mm_and_si128(digit, _mm_sub_epi8(in, _mm_set1_epi8('0')));
+		values = _mm_or_si128(values, _mm_and_si128(upper, _mm_sub_epi8(in, _mm_set1_epi8('A' - 10))));
+		values = _mm_or_si128(values, _mm_and_si128(lower, _mm_sub_epi8(in, _mm_set1_epi8('a' - 10))));
+
+		/* high nibble * 16 + low nibble for every pair */
+		values = _mm_maddubs_epi16(values, _mm_set1_epi16(0x0110));
+		_mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(values, values));
+	}
+	return i;
+}
+
+/* decodes 32 hexadecimal digits at a time into 16 bytes */
+__attribute__((target("avx2")))
+static unsigned int hex_decode_avx2(const char *src, unsigned int n, unsigned char *dst)
+{
+	__m256i in, digit, upper, lower, values;
+	unsigned int i;
+
+	for(i = 0; n - i >= 32; i += 32, dst += 16)
+	{
+		in = _mm256_loadu_si256((const __m256i*)(src + i));
+
+		digit = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), in));
+		upper = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('F' + 1), in));
+		lower = _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), in));
+		if((unsigned int)_mm256_movemask_epi8(_mm256_or_si256(digit, _mm256_or_si256(upper, lower))) != 0xFFFFFFFFU) break;
+
+		values = _mm256_and_si256(digit, _mm256_sub_epi8(in, _mm256_set1_epi8('0')));
+		values = _mm256_or_si256(values, _mm256_and_si256(upper, _mm256_sub_epi8(in, _mm256_set1_epi8('A' - 10))));
+		values = _mm256_or_si256(values, _mm256_and_si256(lower, _mm256_sub_epi8(in, _mm256_set1_epi8('a' - 10))));
+
+		values = _mm256_maddubs_epi16(values, _mm256_set1_epi16(0x0110));
+		_mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1)));
+	}
+	return i;
+}
+
+#endif
+
+/* encodes n bytes into 4 * ceil(n / 3) characters (fewer without padding) */
+static void base64_encode(const unsigned char *src, unsigned int n, char *dst, BOOL url_safe)
+{
+	const char *alphabet;
+	unsigned int i;
+	unsigned long v;
+
+	i = 0;
+#ifdef CODEC_X86
+	if(get_simd_level() == SIMD_AVX2) i = base64_encode_avx2(src, n, dst, url_safe);
+	if(get_simd_level() >= SIMD_SSSE3) i += base64_encode_ssse3(src + i, n - i, dst + i / 3 * 4, url_safe);
+#endif
+
+	alphabet = (url_safe ? BASE64_URL : BASE64_STANDARD);
+	dst += i / 3 * 4;
+	for(; n - i >= 3; i += 3, dst += 4)
+	{
+		v = ((unsigned long)src[i] << 16) | ((unsigned long)src[i + 1] << 8) | src[i + 2];
+		dst[0] = alphabet[(v >> 18) & 63];
+		dst[1] = alphabet[(v >> 12) & 63];
+		dst[2] = alphabet[(v >> 6) & 63];
+		dst[3] = alphabet[v & 63];
+	}
+
+	if(n - i == 1) {
+		v = (unsigned long)src[i] << 16;
+		*dst++ = alphabet[(v >> 18) & 63];
+		*dst++ = alphabet[(v >> 12) & 63];
+		if(!url_safe) { *dst++ = '='; *dst++ = '='; }
+	} else if(n - i == 2) {
+		v = ((unsigned long)src[i] << 16) | ((unsigned long)src[i + 1] << 8);
+		*dst++ = alphabet[(v >> 18) & 63];
+		*dst++ = alphabet[(v >> 12) & 63];
+		*dst++ = alphabet[(v >> 6) & 63];
+		if(!url_safe) *dst++ = '=';
+	}
+}
+
+/* decodes n characters (without padding, n % 4 != 1) */
+static BOOL base64_decode(const char *src, unsigned int n, unsigned char *dst, BOOL url_safe)
+{
+	const signed char *values;
+	unsigned int i;
+	int a, b, c, d;
+
+	i = 0;
+#ifdef CODEC_X86
+	if(get_simd_level() == SIMD_AVX2) i = base64_decode_avx2(src, n, dst, url_safe);
+	if(get_simd_level() >= SIMD_SSSE3) i += base64_decode_ssse3(src + i, n - i, dst + i / 4 * 3, url_safe);
+#endif
+
+	values = (url_safe ? BASE64_URL_VALUES : BASE64_STANDARD_VALUES);
+	dst += i / 4 * 3;
+	for(; n - i >= 4; i += 4, dst += 3)
+	{
+		a = values[(unsigned char)src[i]];
+		b = values[(unsigned char)src[i + 1]];
+		c = values[(unsigned char)src[i + 2]];
+		d = values[(unsigned char)src[i + 3]];
+		if((a | b | c | d) < 0) return FALSE;
+
+		dst[0] = (unsigned char)((a << 2) | (b >> 4));
+		dst[1] = (unsigned char)((b << 4) | (c >> 2));
+		dst[2] = (unsigned char)((c << 6) | d);
+	}
+
+	if(n - i >= 2) {
+		a = values[(unsigned char)src[i]];
+		b = values[(unsigned char)src[i + 1]];
+		c = (n - i == 3 ? values[(unsigned char)src[i + 2]] : 0);
+		if((a | b | c) < 0) return FALSE;
+
+		dst[0] = (unsigned char)((a << 2) | (b >> 4));
+		if(n - i == 3) dst[1] = (unsigned char)((b << 4) | (c >> 2));
+	}
+	return TRUE;
+}
+
+/* encodes n bytes into 2 * n hexadecimal digits */
+static void hex_encode(const unsigned char *src, unsigned int n, char *dst, BOOL upper)
+{
+	const char *digits;
+	unsigned int i;
+
+	i = 0;
+#ifdef CODEC_X86
+	if(get_simd_level() == SIMD_AVX2) i = hex_encode_avx2(src, n, dst, upper);
+	if(get_simd_level() >= SIMD_SSSE3) i += hex_encode_ssse3(src + i, n - i, dst + 2 * i, upper);
+#endif
+
+	digits = (upper ? HEX_UPPER : HEX_LOWER);
+	for(; i < n; ++i)
+	{
+		dst[2 * i] = digits[src[i] >> 4];
+		dst[2 * i + 1] = digits[src[i] & 15];
+	}
+}
+
+/* decodes n (even) hexadecimal digits */
+static BOOL hex_decode(const char *src, unsigned int n, unsigned char *dst)
+{
+	unsigned int i;
+	int hi, lo;
+
+	i = 0;
+#ifdef CODEC_X86
+	if(get_simd_level() == SIMD_AVX2) i = hex_decode_avx2(src, n, dst);
+	if(get_simd_level() >= SIMD_SSSE3) i += hex_decode_ssse3(src + i, n - i, dst + i / 2);
+#endif
+
+	for(; i < n; i += 2)
+	{
+		hi = hex_value((unsigned char)src[i]);
+		lo = hex_value((unsigned char)src[i + 1]);
+		if((hi | lo) < 0) return FALSE;
+		dst[i / 2] = (unsigned char)((hi << 4) | lo);
+	}
+	return TRUE;
+}
+
+/* computes the number of bytes a base64 text decodes to, and the number of characters excluding padding */
+static unsigned int base64_decoded_length(const STRING *text, unsigned int *chars)
+{
+	unsigned int n;
+
+	n = text->length;
+	if(n > 0 && text->data[n - 1] == '=') --n;
+	if(n > 0 && text->data[n - 1] == '=') --n;
+
+	*chars = n;
+	return n / 4 * 3 + (n % 4 == 3 ? 2 : (n % 4 == 2 ? 1 : 0));
+}
+
+#ifdef CODEC_X86
+
+/* marks the bytes of a 16-byte block which have to be escaped under the given scheme */
+__attribute__((target("sse2")))
+static __inline__ __m128i special_mask_sse2(int scheme, __m128i x)
+{
+	__m128i m, t;
+
+	if(scheme == ESCAPE_URL || scheme == ESCAPE_FORM) {
+		/* unreserved characters: A-Z a-z 0-9 - _ . ~ (a byte is in [lo, lo + len) if min(x - lo, len - 1) == x - lo) */
+		t = _mm_sub_epi8(x, _mm_set1_epi8('A'));
+		m = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(25)), t);
+		t = _mm_sub_epi8(x, _mm_set1_epi8('a'));
+		m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(25)), t));
+		t = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+		m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(9)), t));
+		m = _mm_or_si128(m, _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('-')), _mm_cmpeq_epi8(x, _mm_set1_epi8('_'))));
+		m = _mm_or_si128(m, _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('.')), _mm_cmpeq_epi8(x, _mm_set1_epi8('~'))));
+		return _mm_xor_si128(m, _mm_set1_epi8(-1));
+	}
+
+	/* control characters, quotes and backslashes; C literals also escape everything from DEL upwards */
+	m = _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(0x1f)), x);
+	m = _mm_or_si128(m, _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('"')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\\'))));
+	if(scheme == ESCAPE_C) m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_max_epu8(x, _mm_set1_epi8(0x7f)), x));
+	return m;
+}
+
+/* returns the offset of the first byte to escape within the 16-byte blocks of s, or the number of bytes scanned */
+__attribute__((target("sse2")))
+static unsigned int find_special_sse2(int scheme, const unsigned char *s, unsigned int n)
+{
+	unsigned int i, mask;
+
+	for(i = 0; n - i >= 16; i += 16)
+	{
+		mask = (unsigned int)_mm_movemask_epi8(special_mask_sse2(scheme, _mm_loadu_si128((const __m128i*)(s + i))));
+		if(mask != 0) return i + __builtin_ctz(mask);
+	}
+	return i;
+}
+
+/* returns the offset of the first of two bytes within the 16-byte blocks of s, or the number of bytes scanned */
+__attribute__((target("sse2")))
+static unsigned int find_either_sse2(const char *s, unsigned int n, char a, char b)
+{
+	__m128i x;
+	unsigned int i, mask;
+
+	for(i = 0; n - i >= 16; i += 16)
+	{
+		x = _mm_loadu_si128((const __m128i*)(s + i));
+		mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(a)), _mm_cmpeq_epi8(x, _mm_set1_epi8(b))));
+		if(mask != 0) return i + __builtin_ctz(mask);
+	}
+	return i;
+}
+
+/* marks the bytes of a 32-byte block which have to be escaped under the given scheme */
+__attribute__((target("avx2")))
+static __inline__ __m256i special_mask_avx2(int scheme, __m256i x)
+{
+	__m256i m, t;
+
+	if(scheme == ESCAPE_URL || scheme == ESCAPE_FORM) {
+		t = _mm256_sub_epi8(x, _mm256_set1_epi8('A'));
+		m = _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(25)), t);
+		t = _mm256_sub_epi8(x, _mm256_set1_epi8('a'));
+		m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(25)), t));
+		t = _mm256_sub_epi8(x, _mm256_set1_epi8('0'));
+		m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(9)), t));
+		m = _mm256_or_si256(m, _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('-')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'))));
+		m = _mm256_or_si256(m, _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('.')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('~'))));
+		return _mm256_xor_si256(m, _mm256_set1_epi8(-1));
+	}
+
+	m = _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(0x1f)), x);
+	m = _mm256_or_si256(m, _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\'))));
+	if(scheme == ESCAPE_C) m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_max_epu8(x, _mm256_set1_epi8(0x7f)), x));
+	return m;
+}
+
+/* returns the offset of the first byte to escape within the 32-byte blocks of s, or the number of bytes scanned */
+__attribute__((target("avx2")))
+static unsigned int find_special_avx2(int scheme, const unsigned char *s, unsigned int n)
+{
+	unsigned int i, mask;
+
+	for(i = 0; n - i >= 32; i += 32)
+	{
+		mask = (unsigned int)_mm256_movemask_epi8(special_mask_avx2(scheme, _mm256_loadu_si256((const __m256i*)(s + i))));
+		if(mask != 0) return i + __builtin_ctz(mask);
+	}
+	return i;
+}
+
+#endif
+
+/* checks if a byte has to be escaped under the given scheme */
+static BOOL is_special(int scheme, unsigned char c)
+{
+	switch(scheme)
+	{
+		case ESCAPE_JSON:
+			return(c < 0x20 || c == '"' || c == '\\' ? TRUE : FALSE);
+
+		case ESCAPE_C:
+			return(c < 0x20 || c >= 0x7f || c == '"' || c == '\\' ? TRUE : FALSE);
+
+		default:
+			if((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) return FALSE;
+			return(c == '-' || c == '_' || c == '.' || c == '~' ? FALSE : TRUE);
+	}
+}
+
+/* returns the offset of the first byte that has to be escaped, or n if there is none */
+static unsigned int find_special(int scheme, const unsigned char *s, unsigned int n)
+{
+	unsigned int i;
+
+	i = 0;
+#ifdef CODEC_X86
+	if(get_simd_level() == SIMD_AVX2) {
+		i = find_special_avx2(scheme, s, n);
+		if(n - i >= 32) return i;
+	}
+	if(get_simd_level() >= SIMD_SSE2) {
+		i += find_special_sse2(scheme, s + i, n - i);
+		if(n - i >= 16) return i;
+	}
+#endif
+
+	for(; i < n; ++i)
+		if(is_special(scheme, s[i])) return i;
+
+	return n;
+}
+
+/* returns the offset of the first occurrence of either of two bytes, or n if there is none */
+static unsigned int find_either(const char *s, unsigned int n, char a, char b)
+{
+	const char *p;
+	unsigned int i;
+
+	if(a == b) {
+		p = (const char*)memchr(s, a, n);
+		return(p == NULL ? n : (unsigned int)(p - s));
+	}
+
+	i = 0;
+#ifdef CODEC_X86
+	if(get_simd_level() >= SIMD_SSE2) {
+		i = find_either_sse2(s, n, a, b);
+		if(n - i >= 16) return i;
+	}
+#endif
+
+	for(; i < n; ++i)
+		if(s[i] == a || s[i] == b) return i;
+
+	return n;
+}
+
+/* returns the number of characters a byte that has to be escaped is replaced with */
+static unsigned int escaped_length(int scheme, unsigned char c)
+{
+	switch(scheme)
+	{
+		case ESCAPE_JSON:
+			if(c == '"' || c == '\\' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t') return 2;
+			return 6;
+
+		case ESCAPE_C:
+			if(c == '"' || c == '\\' || (c >= '\a' && c <= '\r')) return 2;
+			return 4;
+
+		default:
+			return(scheme == ESCAPE_FORM && c == ' ' ? 1 : 3);
+	}
+}
+
+/* writes the escape sequence of a byte and returns the position after it */
+static char* escape_byte(int scheme, unsigned char c, char *dst)
+{
+	static const char C_NAMED[] = "abtnvfr";
+
+	switch(scheme)
+	{
+		case ESCAPE_JSON:
+			*dst++ = '\\';
+			switch(c)
+			{
+				case '"':	*dst++ = '"'; break;
+				case '\\':	*dst++ = '\\'; break;
+				case '\b':	*dst++ = 'b'; break;
+				case '\f':	*dst++ = 'f'; break;
+				case '\n':	*dst++ = 'n'; break;
+				case '\r':	*dst++ = 'r'; break;
+				case '\t':	*dst++ = 't'; break;
+				default:
+					*dst++ = 'u';
+					*dst++ = '0';
+					*dst++ = '0';
+					*dst++ = HEX_LOWER[c >> 4];
+					*dst++ = HEX_LOWER[c & 15];
+			}
+			return dst;
+
+		case ESCAPE_C:
+			*dst++ = '\\';
+			if(c == '"' || c == '\\') {
+				*dst++ = c;
+			} else if(c >= '\a' && c <= '\r') {
+				*dst++ = C_NAMED[c - '\a'];
+			} else {
+				/* always three octal digits, so a following digit cannot extend the sequence */
+				*dst++ = '0' + (c >> 6);
+				*dst++ = '0' + ((c >> 3) & 7);
+				*dst++ = '0' + (c & 7);
+			}
+			return dst;
+
+		default:
+			if(scheme == ESCAPE_FORM && c == ' ') {
+				*dst++ = '+';
+			} else {
+				*dst++ = '%';
+				*dst++ = HEX_UPPER[c >> 4];
+				*dst++ = HEX_UPPER[c & 15];
+			}
+			return dst;
+	}
+}
+
+/* escapes text at the end of a string: one pass to size the output, one to copy clean runs and write escapes */
+static BOOL escape_append(STRING *sobj, const STRING *text, int scheme)
+{
+	const unsigned char *src;
+	unsigned int n, i, j, extra;
+	char *dst;
+
+	if(sobj == NULL || text == NULL) return FALSE;
+
+	src = (const unsigned char*)text->data;
+	n = text->length;
+
+	extra = 0;
+	for(i = 0; i < n; ++i)
+	{
+		i += find_special(scheme, src + i, n - i);
+		if(i >= n) break;
+		if(extra > UINT_MAX - 5) return FALSE;
+		extra += escaped_length(scheme, src[i]) - 1;
+	}
+
+	if(extra > UINT_MAX - 1 - n || n + extra > UINT_MAX - 1 - sobj->length) return FALSE;
+	if(!str_reserve(sobj, sobj->length + n + extra)) return FALSE;
+
+	dst = sobj->data + sobj->length;
+	for(i = 0; i < n; i = j + 1)
+	{
+		j = i + find_special(scheme, src + i, n - i);
+		memcpy(dst, src + i, j - i);
+		dst += j - i;
+		if(j >= n) break;
+		dst = escape_byte(scheme, src[j], dst);
+	}
+
+	sobj->length += n + extra;
+	sobj->data[sobj->length] = '\0';
+	return TRUE;
+}
+
+/* writes a code point as UTF-8 and returns the position after it */
+static char* put_utf8(unsigned long code, char *dst)
+{
+	if(code < 0x80) {
+		*dst++ = (char)code;
+	} else if(code < 0x800) {
+		*dst++ = (char)(0xc0 | (code >> 6));
+		*dst++ = (char)(0x80 | (code & 0x3f));
+	} else if(code < 0x10000) {
+		*dst++ = (char)(0xe0 | (code >> 12));
+		*dst++ = (char)(0x80 | ((code >> 6) & 0x3f));
+		*dst++ = (char)(0x80 | (code & 0x3f));
+	} else {
+		*dst++ = (char)(0xf0 | (code >> 18));
+		*dst++ = (char)(0x80 | ((code >> 12) & 0x3f));
+		*dst++ = (char)(0x80 | ((code >> 6) & 0x3f));
+		*dst++ = (char)(0x80 | (code & 0x3f));
+	}
+	return dst;
+}
+
+/* reads exactly n hexadecimal digits, returns -1 if any of them is invalid */
+static long read_hex(const char *s, unsigned int n)
+{
+	long value;
+	int digit;
+
+	value = 0;
+	while(n-- > 0)
+	{
+		digit = hex_value((unsigned char)*s++);
+		if(digit < 0) return -1;
+		value = (value << 4) | digit;
+	}
+	return value;
+}
+
+/* decodes the JSON escape sequence after a backslash, returns the position after it or NULL if invalid */
+static const char* unescape_json(const char *src, const char *end, char **dst)
+{
+	long code, low;
+
+	if(src >= end) return NULL;
+
+	switch(*src)
+	{
+		case '"':	*(*dst)++ = '"'; return src + 1;
+		case '\\':	*(*dst)++ = '\\'; return src + 1;
+		case '/':	*(*dst)++ = '/'; return src + 1;
+		case 'b':	*(*dst)++ = '\b'; return src + 1;
+		case 'f':	*(*dst)++ = '\f'; return src + 1;
+		case 'n':	*(*dst)++ = '\n'; return src + 1;
+		case 'r':	*(*dst)++ = '\r'; return src + 1;
+		case 't':	*(*dst)++ = '\t'; return src + 1;
+		case 'u':	break;
+		default:	return NULL;
+	}
+
+	if(end - src < 5 || (code = read_hex(src + 1, 4)) < 0) return NULL;
+	src += 5;
+
+	/* characters outside the basic plane come as a surrogate pair */
+	if(code >= 0xdc00 && code <= 0xdfff) return NULL;
+	if(code >= 0xd800 && code <= 0xdbff) {
+		if(end - src < 6 || src[0] != '\\' || src[1] != 'u') return NULL;
+		low = read_hex(src + 2, 4);
+		if(low < 0xdc00 || low > 0xdfff) return NULL;
+
+		code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+		src += 6;
+	}
+
+	*dst = put_utf8((unsigned long)code, *dst);
+	return src;
+}
+
+/* decodes the C escape sequence after a backslash, returns the position after it or NULL if invalid */
+static const char* unescape_c(const char *src, const char *end, char **dst)
+{
+	unsigned int value, count;
+	int digit;
+
+	if(src >= end) return NULL;
+
+	switch(*src)
+	{
+		case 'a':	*(*dst)++ = '\a'; return src + 1;
+		case 'b':	*(*dst)++ = '\b'; return src + 1;
+		case 'f':	*(*dst)++ = '\f'; return src + 1;
+		case 'n':	*(*dst)++ = '\n'; return src + 1;
+		case 'r':	*(*dst)++ = '\r'; return src + 1;
+		case 't':	*(*dst)++ = '\t'; return src + 1;
+		case 'v':	*(*dst)++ = '\v'; return src + 1;
+		case '\\':
+		case '\'':
+		case '"':
+		case '?':	*(*dst)++ = *src; return src + 1;
+
+		case 'x':
+			/* as in C, a hexadecimal escape takes every digit that follows */
+			value = 0;
+			for(++src, count = 0; src < end && (digit = hex_value((unsigned char)*src)) >= 0; ++src, ++count)
+			{
+				value = (value << 4) | digit;
+				if(value > 0xff) return NULL;
+			}
+			if(count == 0) return NULL;
+			*(*dst)++ = (char)value;
+			return src;
+
+		default:
+			if(*src < '0' || *src > '7') return NULL;
+
+			value = 0;
+			for(count = 0; count < 3 && src < end && *src >= '0' && *src <= '7'; ++src, ++count)
+				value = (value << 3) | (*src - '0');
+
+			if(value > 0xff) return NULL;
+			*(*dst)++ = (char)value;
+			return src;
+	}
+}
+
+/* unescapes text at the end of a string; the output is never longer than the input */
+static BOOL unescape_append(STRING *sobj, const STRING *text, int scheme)
+{
+	const char *src, *end;
+	unsigned int run;
+	char *dst;
+	long value;
+
+	if(sobj == NULL || text == NULL) return FALSE;
+	if(text->length > UINT_MAX - 1 - sobj->length) return FALSE;
+	if(!str_reserve(sobj, sobj->length + text->length)) return FALSE;
+
+	src = text->data;
+	end = src + text->length;
+	dst = sobj->data + sobj->length;
+	while(src < end)
+	{
+		if(scheme == ESCAPE_URL || scheme == ESCAPE_FORM)
+			run = find_either(src, end - src, '%', (scheme == ESCAPE_FORM ? '+' : '%'));
+		else
+			run = find_either(src, end - src, '\\', '\\');
+
+		memcpy(dst, src, run);
+		dst += run;
+		src += run;
+		if(src >= end) break;
+
+		if(*src == '+') {
+			*dst++ = ' ';
+			++src;
+		} else if(*src == '%') {
+			if(end - src < 3 || (value = read_hex(src + 1, 2)) < 0) src = NULL;
+			else { *dst++ = (char)value; src += 3; }
+		} else if(scheme == ESCAPE_JSON) {
+			src = unescape_json(src + 1, end, &dst);
+		} else {
+			src = unescape_c(src + 1, end, &dst);
+		}
+
+		if(src == NULL) {
+			sobj->data[sobj->length] = '\0';
+			return FALSE;
+		}
+	}
+
+	sobj->length = dst - sobj->data;
+	sobj->data[sobj->length] = '\0';
+	return TRUE;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* encodes binary data as base64 */
+STRING* str_base64_encode(const void *data, unsigned int length, BOOL url_safe)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!str_base64_encode_append(sres, data, length, url_safe)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* encodes binary data as base64 at the end of an existing string */
+BOOL str_base64_encode_append(STRING *sobj, const void *data, unsigned int length, BOOL url_safe)
+{
+	unsigned int encoded;
+
+	if(sobj == NULL || (data == NULL && length > 0)) return FALSE;
+	if(length > UINT_MAX / 4 * 3 - 3) return FALSE;
+
+	encoded = (length + 2) / 3 * 4;
+	if(url_safe && length % 3 != 0) encoded -= 3 - length % 3;
+
+	if(encoded > UINT_MAX - 1 - sobj->length) return FALSE;
+	if(!str_reserve(sobj, sobj->length + encoded)) return FALSE;
+	base64_encode((const unsigned char*)data, length, sobj->data + sobj->length, url_safe);
+
+	sobj->length += encoded;
+	sobj->data[sobj->length] = '\0';
+	return TRUE;
+}
+
+/* decodes base64 text */
+STRING* str_base64_decode(const STRING *sobj, BOOL url_safe)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!str_base64_decode_append(sres, sobj, url_safe)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* decodes base64 text at the end of an existing string */
+BOOL str_base64_decode_append(STRING *sobj, const STRING *text, BOOL url_safe)
+{
+	unsigned int decoded, chars;
+
+	if(sobj == NULL || text == NULL) return FALSE;
+
+	decoded = base64_decoded_length(text, &chars);
+	if(chars % 4 == 1) return FALSE;
+
+	if(decoded > UINT_MAX - 1 - sobj->length) return FALSE;
+	if(!str_reserve(sobj, sobj->length + decoded)) return FALSE;
+	if(!base64_decode(text->data, chars, (unsigned char*)sobj->data + sobj->length, url_safe)) {
+		sobj->data[sobj->length] = '\0';
+		return FALSE;
+	}
+
+	sobj->length += decoded;
+	sobj->data[sobj->length] = '\0';
+	return TRUE;
+}
+
+/* encodes binary data as hexadecimal digits */
+STRING* str_hex_encode(const void *data, unsigned int length, BOOL upper)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!str_hex_encode_append(sres, data, length, upper)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* encodes binary data as hexadecimal digits at the end of an existing string */
+BOOL str_hex_encode_append(STRING *sobj, const void *data, unsigned int length, BOOL upper)
+{
+	if(sobj == NULL || (data == NULL && length > 0)) return FALSE;
+	if(length > UINT_MAX / 2 - 1) return FALSE;
+
+	if(2 * length > UINT_MAX - 1 - sobj->length) return FALSE;
+	if(!str_reserve(sobj, sobj->length + 2 * length)) return FALSE;
+	hex_encode((const unsigned char*)data, length, sobj->data + sobj->length, upper);
+
+	sobj->length += 2 * length;
+	sobj->data[sobj->length] = '\0';
+	return TRUE;
+}
+
+/* decodes hexadecimal text */
+STRING* str_hex_decode(const STRING *sobj)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!str_hex_decode_append(sres, sobj)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* decodes hexadecimal text at the end of an existing string */
+BOOL str_hex_decode_append(STRING *sobj, const STRING *text)
+{
+	if(sobj == NULL || text == NULL || text->length % 2 != 0) return FALSE;
+
+	if(text->length / 2 > UINT_MAX - 1 - sobj->length) return FALSE;
+	if(!str_reserve(sobj, sobj->length + text->length / 2)) return FALSE;
+	if(!hex_decode(text->data, text->length, (unsigned char*)sobj->data + sobj->length)) {
+		sobj->data[sobj->length] = '\0';
+		return FALSE;
+	}
+
+	sobj->length += text->length / 2;
+	sobj->data[sobj->length] = '\0';
+	return TRUE;
+}
+
+/* escapes text as a JSON string body */
+STRING* str_json_escape(const STRING *sobj)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!escape_append(sres, sobj, ESCAPE_JSON)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* escapes text as a JSON string body at the end of an existing string */
+BOOL str_json_escape_append(STRING *sobj, const STRING *text)
+{
+	return escape_append(sobj, text, ESCAPE_JSON);
+}
+
+/* resolves the escape sequences of a JSON string body */
+STRING* str_json_unescape(const STRING *sobj)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!unescape_append(sres, sobj, ESCAPE_JSON)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* resolves the escape sequences of a JSON string body at the end of an existing string */
+BOOL str_json_unescape_append(STRING *sobj, const STRING *text)
+{
+	return unescape_append(sobj, text, ESCAPE_JSON);
+}
+
+/* escapes text as a C string literal body */
+STRING* str_c_escape(const STRING *sobj)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!escape_append(sres, sobj, ESCAPE_C)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* escapes text as a C string literal body at the end of an existing string */
+BOOL str_c_escape_append(STRING *sobj, const STRING *text)
+{
+	return escape_append(sobj, text, ESCAPE_C);
+}
+
+/* resolves the escape sequences of a C string literal body */
+STRING* str_c_unescape(const STRING *sobj)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!unescape_append(sres, sobj, ESCAPE_C)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* resolves the escape sequences of a C string literal body at the end of an existing string */
+BOOL str_c_unescape_append(STRING *sobj, const STRING *text)
+{
+	return unescape_append(sobj, text, ESCAPE_C);
+}
+
+/* percent-encodes text */
+STRING* str_url_encode(const STRING *sobj, BOOL form)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!escape_append(sres, sobj, (form ? ESCAPE_FORM : ESCAPE_URL))) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* percent-encodes text at the end of an existing string */
+BOOL str_url_encode_append(STRING *sobj, const STRING *text, BOOL form)
+{
+	return escape_append(sobj, text, (form ? ESCAPE_FORM : ESCAPE_URL));
+}
+
+/* decodes percent-encoded text */
+STRING* str_url_decode(const STRING *sobj, BOOL form)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!unescape_append(sres, sobj, (form ? ESCAPE_FORM : ESCAPE_URL))) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* decodes percent-encoded text at the end of an existing string */
+BOOL str_url_decode_append(STRING *sobj, const STRING *text, BOOL form)
+{
+	return unescape_append(sobj, text, (form ? ESCAPE_FORM : ESCAPE_URL));
+}
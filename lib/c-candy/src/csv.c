@@ -0,0 +1,392 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/csv.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <constants.h>
+#include <str.h>
+#include <list.h>
+#include <strarray.h>
+#include <csv.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* <------------------ private function declarations -----------------> */
+static unsigned long long byte_mask(const char *block, char c);
+static unsigned long long prefix_xor(unsigned long long x);
+static void classify_block(CSV_READER *r);
+static size_t next_structural(CSV_READER *r);
+static size_t scan_field(CSV_READER *r, size_t start, size_t *end, BOOL *last);
+static void make_field(const CSV_READER *r, CSV_FIELD *field, size_t start, size_t end);
+static BOOL unescape_into(const CSV_READER *r, const CSV_FIELD *field, STRING *out);
+
+/* <------------------ private function definitions ------------------> */
+
+/* returns a bitmask with bit i set if block[i] == c, for a block of CSV_BLOCK_SIZE bytes */
+static unsigned long long byte_mask(const char *block, char c)
+{
+#if defined(__AVX2__)
+	__m256i needle;
+	unsigned long long lo, hi;
+
+	needle = _mm256_set1_epi8(c);
+	lo = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)block), needle));
+	hi = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(block + 32)), needle));
+	return lo | (hi << 32);
+#elif defined(__SSE2__)
+	__m128i needle;
+	unsigned long long m0, m1, m2, m3;
+
+	needle = _mm_set1_epi8(c);
+	m0 = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)block), needle));
+	m1 = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(block + 16)), needle));
+	m2 = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(block + 32)), needle));
+	m3 = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(block + 48)), needle));
+	return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+#else
+	unsigned long long mask;
+	int i;
+
+	mask = 0;
+	for(i = CSV_BLOCK_SIZE - 1; i >= 0; --i) mask = (mask << 1) | (block[i] == c ? 1 : 0);
+	return mask;
+#endif
+}
+
+/* bit i of the result is the XOR of bits 0..i of x (marks the bytes between opening and closing quotes) */
+static unsigned long long prefix_xor(unsigned long long x)
+{
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
+
+/* computes the separators and newlines outside quotes for the next block of input */
+static void classify_block(CSV_READER *r)
+{
+	char tail[CSV_BLOCK_SIZE];
+	const char *block;
+	unsigned long long quotes, inside, valid;
+	size_t n;
+
+	n = r->length - r->next_block;
+	if(n >= CSV_BLOCK_SIZE) {
+		block = r->data + r->next_block;
+		valid = ~0ULL;
+	} else {
+		/* the last partial block is classified from a zero-padded copy */
+		memset(tail, 0, CSV_BLOCK_SIZE);
+		memcpy(tail, r->data + r->next_block, n);
+		block = tail;
+		valid = (1ULL << n) - 1;
+	}
+
+	quotes = byte_mask(block, r->quote) & valid;
+	inside = prefix_xor(quotes) ^ r->in_quote;
+	r->in_quote = (inside >> 63) ? ~0ULL : 0ULL;
+
+	r->structural = (byte_mask(block, r->separator) | byte_mask(block, '\n')) & ~inside & valid;
+	r->block = r->next_block;
+	r->next_block += CSV_BLOCK_SIZE;
+}
+
+/* returns the position of the next unquoted separator or newline, or the input length if there is none */
+static size_t next_structural(CSV_READER *r)
+{
+	size_t pos;
+
+	while(r->structural == 0)
+	{
+		if(r->next_block >= r->length) return r->length;
+		classify_block(r);
+	}
+
+	pos = r->block + __builtin_ctzll(r->structural);
+	r->structural &= r->structural - 1;
+	return pos;
+}
+
+/* finds the end of the field beginning at start; returns the start of the following field */
+static size_t scan_field(CSV_READER *r, size_t start, size_t *end, BOOL *last)
+{
+	size_t pos;
+
+	pos = next_structural(r);
+	*last = (pos >= r->length || r->data[pos] == '\n') ? TRUE : FALSE;
+
+	/* CRLF record terminator */
+	*end = pos;
+	if(*last && pos < r->length && *end > start && r->data[*end - 1] == '\r') --(*end);
+
+	return pos + 1;
+}
+
+/* fills in a field spanning [start, end) of the input, removing surrounding quotes */
+static void make_field(const CSV_READER *r, CSV_FIELD *field, size_t start, size_t end)
+{
+	if(end > start && r->data[start] == r->quote) {
+		++start;
+		if(end > start && r->data[end - 1] == r->quote) --end;
+		field->quoted = TRUE;
+	} else {
+		field->quoted = FALSE;
+	}
+
+	field->value.data = r->data + start;
+	field->value.length = end - start;
+}
+
+/* copies a field into a string, collapsing doubled quotes in quoted fields */
+static BOOL unescape_into(const CSV_READER *r, const CSV_FIELD *field, STRING *out)
+{
+	const char *src;
+	unsigned int i, n, k;
+
+	n = field->value.length;
+	if(!str_reserve(out, n)) return FALSE;
+
+	src = field->value.data;
+	if(!field->quoted || memchr(src, r->quote, n) == NULL) {
+		memcpy(out->data, src, n);
+		k = n;
+	} else {
+		for(i = 0, k = 0; i < n; ++i)
+		{
+			out->data[k++] = src[i];
+			if(src[i] == r->quote && i + 1 < n && src[i + 1] == r->quote) ++i;
+		}
+	}
+
+	out->data[k] = '\0';
+	out->length = k;
+	return TRUE;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for the reader */
+void csv_dump(CSV_READER *r)
+{
+	free(r);
+}
+
+/* creates a record tokenizer over a character buffer */
+CSV_READER* csv_reader(const char *data, size_t length, char separator, char quote)
+{
+	CSV_READER *r;
+
+	if(data == NULL && length > 0) return NULL;
+	if(separator == quote || separator == '\n' || quote == '\n') return NULL;
+
+	r = (CSV_READER*)malloc(sizeof(CSV_READER));
+	if(r == NULL) return NULL;
+
+	r->data = data;
+	r->length = length;
+	r->position = 0;
+	r->separator = separator;
+	r->quote = quote;
+	r->block = 0;
+	r->next_block = 0;
+	r->structural = 0;
+	r->in_quote = 0;
+	r->record_number = 0;
+	return r;
+}
+
+/* creates a record tokenizer over a string */
+CSV_READER* csv_reader_str(const STRING *sobj, char separator, char quote)
+{
+	if(sobj == NULL) return NULL;
+	return csv_reader(sobj->data, sobj->length, separator, quote);
+}
+
+/* tokenizes the next record into views over the input buffer */
+BOOL csv_next_record(CSV_READER *r, CSV_FIELD *fields, unsigned int max_fields, unsigned int *field_count)
+{
+	size_t start, end, next;
+	unsigned int count;
+	BOOL last;
+
+	if(r == NULL || field_count == NULL) return FALSE;
+	if(r->position >= r->length) return FALSE;
+
+	count = 0;
+	start = r->position;
+	do {
+		next = scan_field(r, start, &end, &last);
+
+		/* a blank line is a record without fields */
+		if(!(last && count == 0 && end == start)) {
+			if(count < max_fields) make_field(r, &fields[count], start, end);
+			++count;
+		}
+
+		start = next;
+	} while(!last);
+
+	r->position = start;
+	++r->record_number;
+	*field_count = count;
+	return TRUE;
+}
+
+/* reads the next record and appends its fields to a list as new strings */
+BOOL csv_next_record_list(CSV_READER *r, LIST *list)
+{
+	CSV_READER saved;
+	CSV_FIELD field;
+	STRING *value;
+	size_t start, end, next;
+	unsigned int count;
+	int length;
+	BOOL last;
+
+	if(r == NULL || list == NULL || list->type != TYPE_OBJECT) return FALSE;
+	if(r->position >= r->length) return FALSE;
+
+	/* the scanner state is restored on failure so the record can be read again */
+	saved = *r;
+	length = list->length;
+
+	count = 0;
+	start = r->position;
+	do {
+		next = scan_field(r, start, &end, &last);
+
+		if(!(last && count == 0 && end == start)) {
+			make_field(r, &field, start, end);
+			value = csv_field_string(r, &field);
+			if(value == NULL || !list_append(list, value)) {
+				str_dump(value);
+				while(list->length > length) str_dump((STRING*)list->data[--list->length]);
+				*r = saved;
+				return FALSE;
+			}
+			++count;
+		}
+
+		start = next;
+	} while(!last);
+
+	r->position = start;
+	++r->record_number;
+	return TRUE;
+}
+
+/* reads the next record into a string array */
+BOOL csv_next_record_array(CSV_READER *r, STRING_ARRAY *arr, unsigned int *field_count)
+{
+	CSV_READER saved;
+	CSV_FIELD field;
+	const char *src;
+	char *dest;
+	size_t start, end, next;
+	unsigned int count, i, k, n, elements;
+	BOOL last;
+
+	if(field_count != NULL) *field_count = 0;
+	if(r == NULL || arr == NULL) return FALSE;
+	if(r->position >= r->length) return FALSE;
+
+	/* the scanner state and element count are restored on failure so the record can be read again */
+	saved = *r;
+	elements = arr->count;
+
+	count = 0;
+	start = r->position;
+	do {
+		next = scan_field(r, start, &end, &last);
+
+		if(!(last && count == 0 && end == start)) {
+			make_field(r, &field, start, end);
+
+			/* unescape straight into the array: the value can only get shorter */
+			n = field.value.length;
+			src = field.value.data;
+			dest = sa_push(arr, n);
+			if(dest == NULL) {
+				/* offsets[elements] still holds the size used before this record, so this drops its fields */
+				arr->count = elements;
+				*r = saved;
+				return FALSE;
+			}
+
+			if(!field.quoted || memchr(src, r->quote, n) == NULL) {
+				memcpy(dest, src, n);
+			} else {
+				for(i = 0, k = 0; i < n; ++i)
+				{
+					dest[k++] = src[i];
+					if(src[i] == r->quote && i + 1 < n && src[i + 1] == r->quote) ++i;
+				}
+				sa_truncate_last(arr, k);
+			}
+			++count;
+		}
+
+		start = next;
+	} while(!last);
+
+	r->position = start;
+	++r->record_number;
+	if(field_count != NULL) *field_count = count;
+	return TRUE;
+}
+
+/* copies the unescaped value of a field into a caller-owned string */
+BOOL csv_field_copy(const CSV_READER *r, const CSV_FIELD *field, STRING *out)
+{
+	if(r == NULL || field == NULL || out == NULL) return FALSE;
+	return unescape_into(r, field, out);
+}
+
+/* returns the unescaped value of a field as a new string */
+STRING* csv_field_string(const CSV_READER *r, const CSV_FIELD *field)
+{
+	STRING *sres;
+
+	if(r == NULL || field == NULL) return NULL;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!unescape_into(r, field, sres)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* returns the number of records read so far */
+unsigned long long csv_record_number(const CSV_READER *r)
+{
+	if(r == NULL) return 0;
+	return r->record_number;
+}
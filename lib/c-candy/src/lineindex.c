@@ -0,0 +1,218 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/lineindex.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <constants.h>
+#include <str.h>
+#include <lineindex.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* <------------------ private constant declarations -----------------> */
+#define LIDX_INITIAL_CAPACITY			64
+
+/* <------------------ private function declarations -----------------> */
+static BOOL add_start(LINE_INDEX *idx, unsigned int offset);
+static unsigned int newline_mask(const char *block);
+static BOOL scan(LINE_INDEX *idx, unsigned int from);
+
+/* <------------------ private function definitions ------------------> */
+
+/* records the start of a line */
+static BOOL add_start(LINE_INDEX *idx, unsigned int offset)
+{
+	unsigned int *temp;
+
+	if(idx->count == idx->capacity) {
+		temp = (unsigned int*)realloc(idx->starts, idx->capacity * 2 * sizeof(unsigned int));
+		if(temp == NULL) return FALSE;
+
+		idx->starts = temp;
+		idx->capacity *= 2;
+	}
+
+	idx->starts[idx->count++] = offset;
+	return TRUE;
+}
+
+/* returns a bitmask with bit i set if block[i] is a newline, for a block of 32 bytes */
+static unsigned int newline_mask(const char *block)
+{
+#if defined(__AVX2__)
+	return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)block), _mm256_set1_epi8('\n')));
+#elif defined(__SSE2__)
+	__m128i needle;
+	unsigned int lo, hi;
+
+	needle = _mm_set1_epi8('\n');
+	lo = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)block), needle));
+	hi = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(block + 16)), needle));
+	return lo | (hi << 16);
+#else
+	unsigned int mask;
+	int i;
+
+	mask = 0;
+	for(i = 31; i >= 0; --i) mask = (mask << 1) | (block[i] == '\n' ? 1 : 0);
+	return mask;
+#endif
+}
+
+/* records a line start after every newline from an offset to the end of the text */
+static BOOL scan(LINE_INDEX *idx, unsigned int from)
+{
+	const char *data;
+	unsigned int i, n, mask;
+
+	data = idx->text->data;
+	n = idx->text->length;
+
+	for(i = from; n - i >= 32; i += 32)
+	{
+		/* walk the set bits of each block; blocks without newlines cost one compare */
+		for(mask = newline_mask(data + i); mask != 0; mask &= mask - 1)
+			if(!add_start(idx, i + __builtin_ctz(mask) + 1)) return FALSE;
+	}
+
+	for(; i < n; ++i)
+		if(data[i] == '\n' && !add_start(idx, i + 1)) return FALSE;
+
+	idx->indexed = n;
+	return TRUE;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for the line index */
+void lidx_dump(LINE_INDEX *idx)
+{
+	if(idx == NULL) return;
+
+	free(idx->starts);
+	free(idx);
+}
+
+/* builds the line index of a string */
+LINE_INDEX* line_index(const STRING *text)
+{
+	LINE_INDEX *idx;
+
+	if(text == NULL) return NULL;
+
+	idx = (LINE_INDEX*)malloc(sizeof(LINE_INDEX));
+	if(idx == NULL) return NULL;
+
+	idx->starts = (unsigned int*)malloc(LIDX_INITIAL_CAPACITY * sizeof(unsigned int));
+	if(idx->starts == NULL) {
+		free(idx);
+		return NULL;
+	}
+
+	idx->text = text;
+	idx->capacity = LIDX_INITIAL_CAPACITY;
+	idx->starts[0] = 0;
+	idx->count = 1;
+	idx->indexed = 0;
+
+	if(!scan(idx, 0)) {
+		lidx_dump(idx);
+		return NULL;
+	}
+	return idx;
+}
+
+/* brings the index up to date after the string has changed */
+BOOL lidx_update(LINE_INDEX *idx)
+{
+	if(idx == NULL) return FALSE;
+
+	if(idx->text->length < idx->indexed) {
+		idx->count = 1;
+		idx->indexed = 0;
+	}
+	return scan(idx, idx->indexed);
+}
+
+/* returns the number of lines */
+unsigned int lidx_line_count(const LINE_INDEX *idx)
+{
+	if(idx == NULL) return 0;
+
+	/* the last start is only a line if something follows it */
+	return(idx->starts[idx->count - 1] == idx->indexed ? idx->count - 1 : idx->count);
+}
+
+/* returns the offset at which a line starts */
+int lidx_line_start(const LINE_INDEX *idx, unsigned int line)
+{
+	if(idx == NULL || line >= lidx_line_count(idx)) return -1;
+	return (int)idx->starts[line];
+}
+
+/* finds the line containing a character */
+int lidx_line_at(const LINE_INDEX *idx, unsigned int offset)
+{
+	unsigned int low, high, mid;
+
+	if(idx == NULL || offset >= idx->indexed) return -1;
+
+	/* the last line starting at or before the offset */
+	low = 0;
+	high = idx->count - 1;
+	while(low < high)
+	{
+		mid = low + (high - low + 1) / 2;
+		if(idx->starts[mid] <= offset)
+			low = mid;
+		else
+			high = mid - 1;
+	}
+	return (int)low;
+}
+
+/* returns a view of a line */
+STRING_VIEW lidx_line(const LINE_INDEX *idx, unsigned int line)
+{
+	STRING_VIEW view;
+	unsigned int start, end;
+
+	view.data = NULL;
+	view.length = 0;
+	if(idx == NULL || line >= lidx_line_count(idx)) return view;
+
+	start = idx->starts[line];
+	if(line + 1 < idx->count) {
+		end = idx->starts[line + 1] - 1;
+		if(end > start && idx->text->data[end - 1] == '\r') --end;
+	} else {
+		end = idx->indexed;
+	}
+
+	view.data = idx->text->data + start;
+	view.length = end - start;
+	return view;
+}
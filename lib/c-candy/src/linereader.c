@@ -0,0 +1,263 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/linereader.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <constants.h>
+#include <str.h>
+#include <strarray.h>
+#include <linereader.h>
+
+/* <------------------ private function declarations -----------------> */
+static LINE_READER* make_reader(int fd, FILE *fp, size_t buffer_size);
+static long fill_buffer(LINE_READER *lr);
+static BOOL append_bytes(STRING *line, const char *bytes, size_t n);
+
+/* <------------------ private function definitions ------------------> */
+
+/* allocates a reader and its buffer */
+static LINE_READER* make_reader(int fd, FILE *fp, size_t buffer_size)
+{
+	LINE_READER *lr;
+
+	if(buffer_size == 0) buffer_size = LR_DEFAULT_BUFFER_SIZE;
+
+	lr = (LINE_READER*)malloc(sizeof(LINE_READER));
+	if(lr == NULL) return NULL;
+
+	lr->buffer = (char*)malloc(buffer_size);
+	if(lr->buffer == NULL) {
+		free(lr);
+		return NULL;
+	}
+
+	lr->fd = fd;
+	lr->fp = fp;
+	lr->capacity = buffer_size;
+	lr->start = 0;
+	lr->end = 0;
+	lr->line_number = 0;
+	lr->eof = FALSE;
+	lr->error = FALSE;
+	return lr;
+}
+
+/* reads as much as fits after the buffered data; returns bytes read, 0 on end of input, -1 on error */
+static long fill_buffer(LINE_READER *lr)
+{
+	size_t room;
+	long n;
+
+	room = lr->capacity - lr->end;
+
+	if(lr->fp != NULL) {
+		n = (long)fread(lr->buffer + lr->end, 1, room, lr->fp);
+		if(n == 0 && ferror(lr->fp)) n = -1;
+	} else {
+		do {
+			n = (long)read(lr->fd, lr->buffer + lr->end, room);
+		} while(n < 0 && errno == EINTR);
+	}
+
+	if(n < 0) {
+		lr->error = TRUE;
+		return -1;
+	}
+
+	if(n == 0) lr->eof = TRUE;
+	lr->end += n;
+	return n;
+}
+
+/* appends raw bytes to a line, growing its buffer geometrically */
+static BOOL append_bytes(STRING *line, const char *bytes, size_t n)
+{
+	unsigned int needed, new_capacity;
+
+	needed = line->length + n;
+	if(needed > line->capacity) {
+		new_capacity = line->capacity * 2;
+		if(new_capacity < needed) new_capacity = needed;
+		if(!str_reserve(line, new_capacity)) return FALSE;
+	}
+
+	memcpy(line->data + line->length, bytes, n);
+	line->length = needed;
+	return TRUE;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for the line reader */
+void lr_dump(LINE_READER *lr)
+{
+	if(lr != NULL)
+	{
+		free(lr->buffer);
+		free(lr);
+	}
+}
+
+/* creates a line reader over a file descriptor */
+LINE_READER* line_reader(int fd, size_t buffer_size)
+{
+	if(fd < 0) return NULL;
+	return make_reader(fd, NULL, buffer_size);
+}
+
+/* creates a line reader over a FILE stream */
+LINE_READER* line_reader_file(FILE *fp, size_t buffer_size)
+{
+	if(fp == NULL) return NULL;
+	return make_reader(-1, fp, buffer_size);
+}
+
+/* reads the next line into the given string, overwriting its contents */
+BOOL lr_read_line(LINE_READER *lr, STRING *line)
+{
+	char *nl;
+	size_t scan_from;
+	BOOL spilled;
+
+	if(lr == NULL || line == NULL || lr->error) return FALSE;
+
+	line->length = 0;
+	spilled = FALSE;
+	scan_from = lr->start;
+
+	for(;;)
+	{
+		nl = (char*)memchr(lr->buffer + scan_from, '\n', lr->end - scan_from);
+		if(nl != NULL) {
+			if(!append_bytes(line, lr->buffer + lr->start, nl - (lr->buffer + lr->start))) return FALSE;
+			lr->start = (nl - lr->buffer) + 1;
+			break;
+		}
+
+		if(lr->eof) {
+			if(lr->start == lr->end && !spilled) return FALSE;
+			if(!append_bytes(line, lr->buffer + lr->start, lr->end - lr->start)) return FALSE;
+			lr->start = lr->end;
+			break;
+		}
+
+		/* no newline in the buffered data: make room at the end and read more */
+		if(lr->start > 0) {
+			memmove(lr->buffer, lr->buffer + lr->start, lr->end - lr->start);
+			lr->end -= lr->start;
+			lr->start = 0;
+		} else if(lr->end == lr->capacity) {
+			/* the line is longer than the buffer, so move what we have into the caller's string */
+			if(!append_bytes(line, lr->buffer, lr->end)) return FALSE;
+			lr->start = lr->end = 0;
+			spilled = TRUE;
+		}
+
+		scan_from = lr->end;
+		if(fill_buffer(lr) < 0) return FALSE;
+	}
+
+	/* CRLF line endings (the CR may have arrived at the end of an earlier chunk) */
+	if(line->length > 0 && line->data[line->length - 1] == '\r') --line->length;
+
+	line->data[line->length] = '\0';
+
+	++lr->line_number;
+	return TRUE;
+}
+
+/* reads up to a number of lines into a string array */
+int lr_read_lines(LINE_READER *lr, STRING_ARRAY *arr, unsigned int max_lines)
+{
+	char *nl, *buffer;
+	size_t length, scanned;
+	unsigned int count;
+
+	if(lr == NULL || arr == NULL || lr->error) return -1;
+
+	count = 0;
+	scanned = 0;
+	while(count < max_lines)
+	{
+		nl = (char*)memchr(lr->buffer + lr->start + scanned, '\n', lr->end - lr->start - scanned);
+		if(nl == NULL && !lr->eof) {
+			/* refill, growing the buffer if the line does not fit, so every line is copied from it in one piece */
+			scanned = lr->end - lr->start;
+			if(lr->start > 0) {
+				memmove(lr->buffer, lr->buffer + lr->start, lr->end - lr->start);
+				lr->end -= lr->start;
+				lr->start = 0;
+			} else if(lr->end == lr->capacity) {
+				if(lr->capacity > (size_t)-1 / 2) return -1;
+				buffer = (char*)realloc(lr->buffer, lr->capacity * 2);
+				if(buffer == NULL) return -1;
+				lr->buffer = buffer;
+				lr->capacity *= 2;
+			}
+			if(fill_buffer(lr) < 0) break;
+			continue;
+		}
+
+		/* the last line may have no newline */
+		if(nl == NULL) {
+			if(lr->start == lr->end) break;
+			nl = lr->buffer + lr->end;
+		}
+
+		length = nl - (lr->buffer + lr->start);
+		if(length > 0 && nl[-1] == '\r') --length;
+
+		/* the line is consumed only once it is in the array, so a failed append loses nothing */
+		if(length > UINT_MAX || !sa_append_chars(arr, lr->buffer + lr->start, (unsigned int)length)) return -1;
+
+		lr->start = (nl == lr->buffer + lr->end ? lr->end : (size_t)(nl - lr->buffer) + 1);
+		scanned = 0;
+		++lr->line_number;
+		++count;
+	}
+
+	return (count == 0 && lr->error ? -1 : (int)count);
+}
+
+/* returns the number of lines read so far */
+unsigned long long lr_line_number(const LINE_READER *lr)
+{
+	if(lr == NULL) return 0;
+	return lr->line_number;
+}
+
+/* checks if all input has been consumed */
+BOOL lr_is_at_eof(const LINE_READER *lr)
+{
+	if(lr == NULL) return TRUE;
+	return (lr->eof && lr->start == lr->end) ? TRUE : FALSE;
+}
+
+/* checks if the underlying read failed */
+BOOL lr_has_error(const LINE_READER *lr)
+{
+	if(lr == NULL) return FALSE;
+	return lr->error;
+}
@@ -20,63 +20,123 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <stdarg.h>
 #include <constants.h>
 #include <list.h>
 #include <utils.h>
 
+/* <------------------ private constant declarations -----------------> */
+
+/* a sort key and the position it was taken from */
+typedef struct {
+	int key;
+	unsigned int index;
+} SORT_KEY;
+
 /* <------------------ private function declarations -----------------> */
 
-/* doubles the capacity of a list */
-static BOOL increase_capacity(LIST *list)
+/* returns the number of bytes an element of a type takes in the list's buffer */
+static unsigned int item_size(ITEM_TYPE type)
 {
-	void **new_data;
-	unsigned int i;
+	switch(type)
+	{
+		case TYPE_CHAR: return sizeof(char);
+		case TYPE_SHORT: return sizeof(short);
+		case TYPE_INT: return sizeof(int);
+		case TYPE_LONG: return sizeof(long);
+		case TYPE_LONG_LONG: return sizeof(long long);
+		case TYPE_FLOAT: return sizeof(float);
+		case TYPE_DOUBLE: return sizeof(double);
+		case TYPE_LONG_DOUBLE: return sizeof(long double);
+		default: return sizeof(void*);
+	}
+}
 
-	if(list == NULL) return FALSE;
+/* returns the address of the element at an index */
+static void* slot(const LIST *list, int index)
+{
+	return (char*)list->data + (size_t)index * list->item_size;
+}
 
-	/* allocate double memory */
-	new_data = (void**)calloc(list->capacity * LIST_CAPACITY_INCREASE_FACTOR, sizeof(void*));
-	if(new_data == NULL) return FALSE;
+/* reads the next variadic argument of the list's type into a value (char, short and float arrive promoted) */
+static void read_value(ITEM_TYPE type, va_list *args, ITEM *value)
+{
+	switch(type)
+	{
+		case TYPE_CHAR: value->char_value = (char)va_arg(*args, int); break;
+		case TYPE_SHORT: value->short_value = (short)va_arg(*args, int); break;
+		case TYPE_INT: value->int_value = va_arg(*args, int); break;
+		case TYPE_LONG: value->long_value = va_arg(*args, long); break;
+		case TYPE_LONG_LONG: value->ll_value = va_arg(*args, long long); break;
+		case TYPE_FLOAT: value->float_value = (float)va_arg(*args, double); break;
+		case TYPE_DOUBLE: value->double_value = va_arg(*args, double); break;
+		case TYPE_LONG_DOUBLE: value->ld_value = va_arg(*args, long double); break;
+		default: value->object = va_arg(*args, void*); break;
+	}
+}
 
-	/* copy items */
-	for(i = 0; i < list->length; ++i) new_data[i] = list->data[i];
+/* creates an empty list (callable where a parameter named list hides list()) */
+static LIST* make_list(ITEM_TYPE type, unsigned int initial_capacity)
+{
+	LIST *list;
 
-	/* change data members */
-	free(list->data);
-	list->data = new_data;
-	list->capacity *= 2;
+	if(initial_capacity == 0) return NULL;
 
-	return TRUE;
+	list = (LIST*)malloc(sizeof(LIST));
+	if(list == NULL) return NULL;
+
+	list->length = 0;
+	list->capacity = initial_capacity;
+	list->type = type;
+	list->item_size = item_size(type);
+	
+	list->data = (void**)calloc(initial_capacity, list->item_size);
+	if(list->data == NULL) {
+		free(list);
+		return NULL;
+	}
+
+	return list;
 }
 
-/* halves the capacity of a list */
-static BOOL decrease_capacity(LIST *list)
+/* replaces the buffer of a list with one of a new capacity */
+static BOOL resize(LIST *list, int capacity)
 {
 	void **new_data;
-	unsigned int i;
 
-	if(list == NULL) return FALSE;
+	if(capacity < 1) capacity = 1;
+	if(capacity < list->length) return FALSE;
 
-	/* allocate half memory */
-	new_data = (void**)calloc(list->capacity * LIST_CAPACITY_DECREASE_FACTOR, sizeof(void*));
+	new_data = (void**)calloc(capacity, list->item_size);
 	if(new_data == NULL) return FALSE;
 
-	/* copy items */
-	for(i = 0; i < list->length; ++i) new_data[i] = list->data[i];
-
-	/* change data members */
+	memcpy(new_data, list->data, (size_t)list->length * list->item_size);
 	free(list->data);
 	list->data = new_data;
-	list->capacity /= 2;
+	list->capacity = capacity;
 
 	return TRUE;
 }
 
+/* doubles the capacity of a list */
+static BOOL increase_capacity(LIST *list)
+{
+	if(list == NULL) return FALSE;
+	return resize(list, list->capacity * LIST_CAPACITY_INCREASE_FACTOR);
+}
+
+/* halves the capacity of a list */
+static BOOL decrease_capacity(LIST *list)
+{
+	if(list == NULL) return FALSE;
+	return resize(list, list->capacity * LIST_CAPACITY_DECREASE_FACTOR);
+}
+
 /* checks if it is time to decrease the list capacity */
 static BOOL should_decrease_capacity(LIST *list)
 {
-	return ((list != NULL) && (list->length <= list->capacity * LIST_CAPACITY_DECREASE_LOAD_FACTOR)) ? TRUE : FALSE;
+	return ((list != NULL) && (list->capacity > 1) && (list->length <= list->capacity * LIST_CAPACITY_DECREASE_LOAD_FACTOR)) ? TRUE : FALSE;
 }
 
 /* checks if it is time to decrease the list capacity */
@@ -86,10 +146,8 @@ static BOOL should_increase_capacity(LIST *list)
 }
 
 /* inserts an item at the specified index */
-static BOOL list_insert_generic(LIST *list, int index, void *value)
+static BOOL list_insert_generic(LIST *list, int index, const ITEM *value)
 {
-	unsigned int i;
-	
 	if(list == NULL) return FALSE;
 	if(index < 0) index += list->length;
 	if(index < 0 || index > list->length) return FALSE;
@@ -98,38 +156,129 @@ static BOOL list_insert_generic(LIST *list, int index, void *value)
 		if(!increase_capacity(list)) return FALSE;
 	}
 	
-	if(index == list->length)
-		list->data[list->length] = value;
-	else {
-		for(i = list->length; i > index; --i) list->data[i] = list->data[i-1];
-		list->data[index] = value;
-	}
+	if(index < list->length)
+		memmove(slot(list, index + 1), slot(list, index), (size_t)(list->length - index) * list->item_size);
+
+	/* the members of ITEM all start at its address, so the value is its first item_size bytes */
+	memcpy(slot(list, index), value, list->item_size);
 
 	++list->length;
 	return TRUE;
 }
 
 /* returns the index of where a value is found, returns -1 if not found */
-static int list_find_generic(const LIST *list, void *value)
+static int list_find_generic(const LIST *list, const ITEM *value)
 {
-	unsigned int i;
+	int i;
 	
 	if(list == NULL) return -1;
-	for(i = 0; i < list->length; ++i)
+
+	/* a typed scan of the contiguous buffer for every element type */
+	switch(list->type)
 	{
-		if(cc_generic_equals(list->type, list->data[i], value)) return i;
+		case TYPE_CHAR:
+			for(i = 0; i < list->length; ++i) if(((const char*)list->data)[i] == value->char_value) return i;
+			break;
+
+		case TYPE_SHORT:
+			for(i = 0; i < list->length; ++i) if(((const short*)list->data)[i] == value->short_value) return i;
+			break;
+
+		case TYPE_INT:
+			for(i = 0; i < list->length; ++i) if(((const int*)list->data)[i] == value->int_value) return i;
+			break;
+
+		case TYPE_LONG:
+			for(i = 0; i < list->length; ++i) if(((const long*)list->data)[i] == value->long_value) return i;
+			break;
+
+		case TYPE_LONG_LONG:
+			for(i = 0; i < list->length; ++i) if(((const long long*)list->data)[i] == value->ll_value) return i;
+			break;
+
+		case TYPE_FLOAT:
+			for(i = 0; i < list->length; ++i) if(((const float*)list->data)[i] == value->float_value) return i;
+			break;
+
+		case TYPE_DOUBLE:
+			for(i = 0; i < list->length; ++i) if(((const double*)list->data)[i] == value->double_value) return i;
+			break;
+
+		case TYPE_LONG_DOUBLE:
+			for(i = 0; i < list->length; ++i) if(((const long double*)list->data)[i] == value->ld_value) return i;
+			break;
+
+		default:
+			for(i = 0; i < list->length; ++i) if(list->data[i] == value->object) return i;
+			break;
 	}
 	return -1;
 }
 
-/* returns the element at the specified index */
-static void* list_at_generic(LIST *list, int index)
+/* returns the element at the specified index (the object itself for TYPE_OBJECT, else the address of the value) */
+static void* list_at_generic(const LIST *list, int index)
 {
 	if(list == NULL) return NULL;
 	if(index < 0) index += list->length;
 
 	if(index < 0 || index >= list->length) return NULL;
-	return list->data[index];
+	return (list->type == TYPE_OBJECT ? list->data[index] : slot(list, index));
+}
+
+/* orders sort keys ascending, keeping equal keys in their original order */
+static int compare_ascending(const void *a, const void *b)
+{
+	const SORT_KEY *k1, *k2;
+
+	k1 = (const SORT_KEY*)a;
+	k2 = (const SORT_KEY*)b;
+	if(k1->key != k2->key) return (k1->key < k2->key ? -1 : 1);
+	return (k1->index < k2->index ? -1 : (k1->index > k2->index ? 1 : 0));
+}
+
+/* orders sort keys descending, keeping equal keys in their original order */
+static int compare_descending(const void *a, const void *b)
+{
+	const SORT_KEY *k1, *k2;
+
+	k1 = (const SORT_KEY*)a;
+	k2 = (const SORT_KEY*)b;
+	if(k1->key != k2->key) return (k1->key > k2->key ? -1 : 1);
+	return (k1->index < k2->index ? -1 : (k1->index > k2->index ? 1 : 0));
+}
+
+/* sorts the elements of a list by the keys a comparator maps them to (stable) */
+static BOOL sort_elements(LIST *list, BOOL reverse, int (*comparator)(void *item))
+{
+	SORT_KEY *keys;
+	void **new_data;
+	int i;
+
+	if(list->length < 2) return TRUE;
+
+	keys = (SORT_KEY*)malloc(list->length * sizeof(SORT_KEY));
+	new_data = (void**)calloc(list->capacity, list->item_size);
+	if(keys == NULL || new_data == NULL) {
+		free(keys);
+		free(new_data);
+		return FALSE;
+	}
+
+	/* the comparator is called once per element, then the elements are moved once */
+	for(i = 0; i < list->length; ++i)
+	{
+		keys[i].key = comparator(list_at_generic(list, i));
+		keys[i].index = (unsigned int)i;
+	}
+	qsort(keys, list->length, sizeof(SORT_KEY), (reverse ? compare_descending : compare_ascending));
+
+	for(i = 0; i < list->length; ++i)
+		memcpy((char*)new_data + (size_t)i * list->item_size, slot(list, keys[i].index), list->item_size);
+
+	free(keys);
+	free(list->data);
+	list->data = new_data;
+	return TRUE;
 }
 
 /* <------------------ public function definitions -------------------> */
@@ -148,145 +297,36 @@ void list_dump(LIST *list)
 LIST* list_copy(const LIST *list, BOOL deep_copy)
 {
 	LIST *new_list;
-	void *generic_item, *new_generic_item;
-	ITEM_TYPE type;
-	unsigned int i;
 
-	char item_char;
-	short item_short;
-	int item_int;
-	long item_long;
-	long long item_long_long;
-	float item_float;
-	double item_double;
-	long double item_long_double;
+	/* values are stored inline, so both kinds of copy duplicate the buffer (objects are shared either way) */
+	(void)deep_copy;
 
 	if(list == NULL) return NULL;
 
-	new_list = list_new(list->type, list->capacity);
-	if(new_list < 0) return new_list;
+	new_list = make_list(list->type, list->capacity);
+	if(new_list == NULL) return NULL;
 
+	memcpy(new_list->data, list->data, (size_t)list->length * list->item_size);
 	new_list->length = list->length;
 
-	type = list->type;
-	for(i = 0; i < list->length; ++i)
-	{
-		if(deep_copy || type == TYPE_OBJECT) 
-		{
-			new_list->data[i] = list->data[i];
-			continue;
-		}
-
-		generic_item = list->data[i];
-
-		if(type == TYPE_CHAR) {
-			char *temp;
-			item_char = *((char*)generic_item);
-			temp = (char*)malloc(sizeof(char));
-			if(temp == NULL) return NULL;
-			*temp = item_char;
-			new_list->data[i] = (void*)temp;
-		}
-
-		if(type == TYPE_SHORT) {
-			short *temp;
-			item_short = *((short*)generic_item);
-			temp = (short*)malloc(sizeof(short));
-			if(temp == NULL) return NULL;
-			*temp = item_short;
-			new_list->data[i] = (void*)temp;
-		}
-
-		if(type == TYPE_INT) {
-			int *temp;
-			item_int = *((int*)generic_item);
-			temp = (int*)malloc(sizeof(int));
-			if(temp == NULL) return NULL;
-			*temp = item_int;
-			new_list->data[i] = (void*)temp;
-		}
-
-		if(type == TYPE_LONG) {
-			long *temp;
-			item_long = *((long*)generic_item);
-			temp = (long*)malloc(sizeof(long));
-			if(temp == NULL) return NULL;
-			*temp = item_long;
-			new_list->data[i] = (void*)temp;
-		}
-
-		if(type == TYPE_LONG_LONG) {
-			long long *temp;
-			item_long_long = *((long long*)generic_item);
-			temp = (long long*)malloc(sizeof(long long));
-			if(temp == NULL) return NULL;
-			*temp = item_long_long;
-			new_list->data[i] = (void*)temp;
-		}
-
-		if(type == TYPE_FLOAT) {
-			float *temp;
-			item_float = *((float*)generic_item);
-			temp = (float*)malloc(sizeof(float));
-			if(temp == NULL) return NULL;
-			*temp = item_float;
-			new_list->data[i] = (void*)temp;
-		}
-
-		if(type == TYPE_DOUBLE) {
-			double *temp;
-			item_double = *((double*)generic_item);
-			temp = (double*)malloc(sizeof(double));
-			if(temp == NULL) return NULL;
-			*temp = item_double;
-			new_list->data[i] = (void*)temp;
-		}
-
-		if(type == TYPE_LONG_DOUBLE) {
-			long double *temp;
-			item_long_double = *((long double*)generic_item);
-			temp = (long double*)malloc(sizeof(long double));
-			if(temp == NULL) return NULL;
-			*temp = item_long_double;
-			new_list->data[i] = (void*)temp;
-		}		
-	}
-
 	return new_list;
 }
 
 /* creates a new empty list */
 LIST* list(ITEM_TYPE type, unsigned int initial_capacity)
 {
-	LIST *list;
-
-	if(initial_capacity == 0) return NULL;
-
-	list = (LIST*)malloc(sizeof(LIST));
-	if(list == NULL) return NULL;
-
-	list->length = 0;
-	list->capacity = initial_capacity;
-	list->type = type;
-	
-	list->data = calloc(initial_capacity, sizeof(void*));
-	if(list->data == NULL) return NULL;
-
-	return list;
+	return make_list(type, initial_capacity);
 }
 
 /* deletes the item at the specified index */
 BOOL list_delete(LIST *list, int index)
 {
-	unsigned int i;
-	
 	if(list == NULL) return FALSE;
 	if(index < 0) index += list->length;
 	if(index < 0 || index >= list->length) return FALSE;
 
-	free(list->data[index]);
-	for(i = index; i < list->length - 1; ++i) list->data[i] = list->data[i+1];
-	list->data[list->length-1] = FALSE;
+	if(list->type == TYPE_OBJECT) free(list->data[index]);
+	memmove(slot(list, index), slot(list, index + 1), (size_t)(list->length - index - 1) * list->item_size);
 	--list->length;
 
 	if(should_decrease_capacity(list)) {
@@ -300,62 +340,67 @@ BOOL list_delete(LIST *list, int index)
 LIST* list_reversed(const LIST *list)
 {
 	LIST *rev_list;
-	unsigned int i;
-
-	if(list == NULL) return NULL;
 
-	rev_list = list_new(list->type, list->capacity);
+	rev_list = list_copy(list, FALSE);
 	if(rev_list == NULL) return NULL;
 
-	rev_list->length = list->length;
-
-	for(i = 0; i < list->length; ++i) rev_list->data[list->length-1-i] = list->data[i];
-	return list;
+	list_reverse(rev_list);
+	return rev_list;
 }
 
 /* concatenates two lists and returns the new list */
 LIST* list_join(const LIST *list1, const LIST *list2)
 {
 	LIST *new_list;
-	unsigned int i, k;
 	
 	if(list1 == NULL || list2 == NULL) return NULL;
 	if(list1->type != list2->type) return NULL;
 	
 	/* allocate memory */
-	new_list = list_new(list1->type, list1->capacity + list2->capacity);
+	new_list = make_list(list1->type, list1->capacity + list2->capacity);
 	if(new_list == NULL) return NULL;
 
 	/* copy items */
-	k = 0;
-	for(i = 0; i < list1->length; ++i) new_list->data[k++] = list1->data[i];
-	for(i = 0; i < list2->length; ++i) new_list->data[k++] = list2->data[i];
+	memcpy(new_list->data, list1->data, (size_t)list1->length * list1->item_size);
+	memcpy(slot(new_list, list1->length), list2->data, (size_t)list2->length * list2->item_size);
 
-	new_list->length = k;
+	new_list->length = list1->length + list2->length;
 	return new_list;
 }
 
 /* reverses a list in-place */
 void list_reverse(LIST *list)
 {
-	unsigned int i, n;
-	void *temp;
+	ITEM temp;
+	int i, n;
 	
-	if(list == NULL) return NULL;
+	if(list == NULL) return;
 
 	n = list->length;
-	for(i = 0; i < n/2; ++i) cc_generic_swap(list->data, i, n-i-1);
+	for(i = 0; i < n/2; ++i)
+	{
+		memcpy(&temp, slot(list, i), list->item_size);
+		memcpy(slot(list, i), slot(list, n-i-1), list->item_size);
+		memcpy(slot(list, n-i-1), &temp, list->item_size);
+	}
 }
 
 /* extends a list in-place */
 BOOL list_extend(LIST *list, const LIST *list_to_add)
 {
-	LIST *new_list;
-	new_list = list_join(list, list_to_add);
-	if(new_list == NULL) return FALSE;
+	int count;
+
+	if(list == NULL || list_to_add == NULL) return FALSE;
+	if(list->type != list_to_add->type) return FALSE;
 
-	list_dump(list);
-	list = new_list;
+	/* the count is read first as the list may be extended with itself */
+	count = list_to_add->length;
+	if(list->length + count > list->capacity) {
+		if(!resize(list, (list->length + count) * LIST_CAPACITY_INCREASE_FACTOR)) return FALSE;
+	}
+
+	memcpy(slot(list, list->length), list_to_add->data, (size_t)count * list->item_size);
+	list->length += count;
 	return TRUE;
 }
 
@@ -384,17 +429,16 @@ ITEM_TYPE list_type(const LIST *list)
 int list_find(const LIST *list, ...)
 {
 	va_list args;
-	void *item;
-	int index, ret_val;
+	ITEM item;
+	int index;
 
 	if(list == NULL) return -1;
 	
 	va_start(args, list);
-	
-	item = cc_as_generic(list->type, args);
-	index = list_find_generic(list, item);	
+	read_value(list->type, &args, &item);
 	va_end(args);
-	
+
+	index = list_find_generic(list, &item);
 	return index;
 }
 
@@ -402,34 +446,31 @@ int list_find(const LIST *list, ...)
 BOOL list_append(LIST *list, ...)
 {
 	va_list args;
-	void *item;
-	BOOL ret_val;
+	ITEM item;
 
 	if(list == NULL) return FALSE;
 	
 	va_start(args, list);
-	
-	item = cc_as_generic(list->type, args);	
-	ret_val = list_insert_generic(list, list->length, item);
-
+	read_value(list->type, &args, &item);
 	va_end(args);
-	return ret_val;
+
+	return list_insert_generic(list, list->length, &item);
 }
 
 /* checks if an item exists in the list */
 BOOL list_has_item(const LIST *list, ...)
 {
 	va_list args;
-	void *item;
-	int index, ret_val;
+	ITEM item;
+	int index;
 
 	if(list == NULL) return FALSE;
 	
 	va_start(args, list);
-	
-	item = cc_as_generic(list->type, args);
-	index = list_find_generic(list, item);	
+	read_value(list->type, &args, &item);
 	va_end(args);
+
+	index = list_find_generic(list, &item);
 	return (index < 0 ? FALSE : TRUE);
 }
 
@@ -437,40 +478,37 @@ BOOL list_has_item(const LIST *list, ...)
 BOOL list_insert(LIST *list, int index, ...)
 {
 	va_list args;
-	void *item;
-	BOOL ret_val;
+	ITEM item;
 
 	if(list == NULL) return FALSE;
 	
 	va_start(args, index);
-	
-	item = cc_as_generic(list->type, args);
-	ret_val = list_insert_generic(list, index, item);
+	read_value(list->type, &args, &item);
 	va_end(args);
-	return ret_val;
+
+	return list_insert_generic(list, index, &item);
 }
 
 /* form a list from the elements passed as arguments */
 LIST* list_from_elements(unsigned int argc, ITEM_TYPE type, ...)
 {
-	LIST *list;
+	LIST *new_list;
 	va_list args;
-	void *item;
+	ITEM item;
 	unsigned int i;
 
-	va_start(args, type);
-	
-	list = list_new(type, argc * LIST_CAPACITY_INIT_BUFFER_FACTOR);
-	if(list == NULL) return NULL;
+	new_list = make_list(type, argc * LIST_CAPACITY_INIT_BUFFER_FACTOR);
+	if(new_list == NULL) return NULL;
 
+	va_start(args, type);
 	for(i = 0; i < argc; ++i)
 	{
-		item = cc_as_generic(list->type, args);
-		list_insert_generic(list, i, item);		
+		read_value(type, &args, &item);
+		list_insert_generic(new_list, i, &item);
 	}
 	
 	va_end(args);
-	return list;
+	return new_list;
 }
 
 /* returns a new sorted list (shallow copy) */
@@ -484,7 +522,10 @@ LIST* list_sorted(const LIST *list, BOOL reverse, int (*comparator)(void *item))
 	sorted_list = list_copy(list, FALSE);
 	if(sorted_list == NULL) return NULL;
 
-	cc_generic_sort(sorted_list->length, sorted_list->data, reverse, comparator);
+	if(!sort_elements(sorted_list, reverse, comparator)) {
+		list_dump(sorted_list);
+		return NULL;
+	}
 	return sorted_list;
 }
 
@@ -492,46 +533,41 @@ LIST* list_sorted(const LIST *list, BOOL reverse, int (*comparator)(void *item))
 void list_sort(LIST *list, BOOL reverse, int (*comparator)(void *item))
 {
 	if(list != NULL && comparator != NULL)
-		cc_generic_sort(list->length, list->data, reverse, comparator);
+		sort_elements(list, reverse, comparator);
 }
 
 /* returns the object at the specified index as an integer */
 ITEM* list_get(const LIST *list, int index)
 {
-	ITEM *item;
-	void *p;
-
 	if(list == NULL || index < 0 || index >= list->length) return NULL;
-
-	p = list_at_generic(list, index);
-	return cc_create_item(list->type, p);
+	return cc_create_item(list->type, list_at_generic(list, index));
 }
 
 /* sets an item at the specified index */
 BOOL list_set(const LIST *list, int index, ...)
 {
 	va_list args;
-	void *item;
-	BOOL ret_val;
+	ITEM item;
 
 	if(list == NULL) return FALSE;
 	if(index < 0) index += list->length;
 	if(index < 0 || index >= list->length) return FALSE;
 	
 	va_start(args, index);
-	
-	item = cc_as_generic(list->type, args);
-	list->data[index] = item;
-
+	read_value(list->type, &args, &item);
 	va_end(args);
+
+	memcpy(slot(list, index), &item, list->item_size);
 	return TRUE;
 }
 
 /* returns a portion of a list as another list */
 LIST* list_get_sublist(const LIST *list, int start, int end, BOOL deep_copy)
 {
-	LIST *sublist, *result;
-	unsigned int i;
+	LIST *sublist;
+
+	/* as in list_copy(), the values are copied and objects are shared whatever the flag */
+	(void)deep_copy;
 
 	if(list == NULL) return NULL;
 
@@ -542,28 +578,27 @@ LIST* list_get_sublist(const LIST *list, int start, int end, BOOL deep_copy)
 	if(end < 0 || end > list->length) return NULL;
 	if(start > end) return NULL;
 
-	sublist = list_new(list->type, (end - start + 1) * LIST_CAPACITY_INIT_BUFFER_FACTOR);
-	if(start == end) return sublist;
-
-	for(i = start; i < end; ++i) sublist->data[i-start] = list->data[i];
-	sublist->length = (end - start + 1);
+	sublist = make_list(list->type, (end - start + 1) * LIST_CAPACITY_INIT_BUFFER_FACTOR);
+	if(sublist == NULL) return NULL;
 
-	result = list_copy(sublist, deep_copy);
-	list_dump(sublist);
-	return result;
+	memcpy(sublist->data, slot(list, start), (size_t)(end - start) * list->item_size);
+	sublist->length = end - start;
+	return sublist;
 }
 
 /* returns the elements of the list as an array */
 ITEM** list_to_array(const LIST *list)
 {
 	ITEM **items;
-	unsigned int i;
+	int i;
 
 	if(list == NULL) return NULL;
 	if(list->length == 0) return NULL;
 
 	items = (ITEM**)calloc(list->length, sizeof(ITEM*));
-	for(i = 0; i < list->length; ++i) items[i] = cc_create_item(list->type, list->data[i]);
+	if(items == NULL) return NULL;
+
+	for(i = 0; i < list->length; ++i) items[i] = cc_create_item(list->type, list_at_generic(list, i));
 
 	return items;
 }
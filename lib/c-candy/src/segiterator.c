@@ -0,0 +1,404 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/segiterator.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <striterator.h>
+#include <segiterator.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define SEGI_INITIAL_CAPACITY		8
+
+/* <------------------ private function declarations -----------------> */
+static unsigned int locate(const SEG_ITERATOR *si, long long position, unsigned int hint);
+static char char_at(const SEG_ITERATOR *si, long long position);
+static void set_marker(SEG_ITERATOR *si, long long position);
+static long long scan(SEG_ITERATOR *si, const CHARSET *cs, BOOL stop_inside, int step);
+
+/* <------------------ private function definitions ------------------> */
+
+/* returns the index of the segment holding a position (count if the position is at or past the end) */
+static unsigned int locate(const SEG_ITERATOR *si, long long position, unsigned int hint)
+{
+	unsigned int lo, hi, mid;
+
+	if(position >= si->starts[si->count]) return si->count;
+
+	/* sequential access stays within the hinted segment or moves to a neighbour */
+	if(hint < si->count && si->starts[hint] <= position) {
+		if(position < si->starts[hint + 1]) return hint;
+		if(hint + 1 < si->count && position < si->starts[hint + 2]) return hint + 1;
+	} else if(hint > 0 && hint <= si->count && si->starts[hint - 1] <= position && position < si->starts[hint]) {
+		return hint - 1;
+	}
+
+	lo = 0;
+	hi = si->count - 1;
+	while(lo < hi)
+	{
+		mid = lo + (hi - lo + 1) / 2;
+		if(si->starts[mid] <= position) lo = mid;
+		else hi = mid - 1;
+	}
+	return lo;
+}
+
+/* returns the character at a position, or -1 outside the segments */
+static char char_at(const SEG_ITERATOR *si, long long position)
+{
+	unsigned int seg;
+
+	if(position < si->starts[0] || position >= si->starts[si->count]) return -1;
+
+	seg = locate(si, position, si->segment);
+	return si->segments[seg].data[position - si->starts[seg]];
+}
+
+/* moves the marker to a position, clamped to the segments */
+static void set_marker(SEG_ITERATOR *si, long long position)
+{
+	if(position < si->starts[0]) position = si->starts[0];
+	if(position > si->starts[si->count]) position = si->starts[si->count];
+
+	si->marker = position;
+	si->segment = locate(si, position, si->segment);
+}
+
+/* moves the marker until a character is (stop_inside) or is not in a set */
+static long long scan(SEG_ITERATOR *si, const CHARSET *cs, BOOL stop_inside, int step)
+{
+	const STRING_VIEW *view;
+	unsigned int offset;
+	long long position, begin, end;
+
+	begin = si->starts[0];
+	end = si->starts[si->count];
+
+	/* forward one at a time: walk each segment's characters directly */
+	if(step == 1) {
+		while(si->segment < si->count)
+		{
+			view = &si->segments[si->segment];
+			offset = (unsigned int)(si->marker - si->starts[si->segment]);
+			while(offset < view->length && (CHARSET_HAS(cs, view->data[offset]) ? TRUE : FALSE) != stop_inside) ++offset;
+
+			si->marker = si->starts[si->segment] + offset;
+			if(offset < view->length) return si->marker;
+			++si->segment;
+		}
+		return si->marker;
+	}
+
+	position = si->marker;
+	while(position >= begin && position < end && (CHARSET_HAS(cs, char_at(si, position)) ? TRUE : FALSE) != stop_inside)
+	{
+		position += step;
+		if(position >= begin && position < end) si->segment = locate(si, position, si->segment);
+	}
+
+	set_marker(si, position);
+	return si->marker;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for the iterator */
+void segi_dump(SEG_ITERATOR *si)
+{
+	if(si == NULL) return;
+
+	free(si->segments);
+	free(si->starts);
+	free(si);
+}
+
+/* creates an iterator with no segments */
+SEG_ITERATOR* seg_iterator()
+{
+	SEG_ITERATOR *si;
+
+	si = (SEG_ITERATOR*)malloc(sizeof(SEG_ITERATOR));
+	if(si == NULL) return NULL;
+
+	si->segments = (STRING_VIEW*)malloc(SEGI_INITIAL_CAPACITY * sizeof(STRING_VIEW));
+	si->starts = (long long*)malloc((SEGI_INITIAL_CAPACITY + 1) * sizeof(long long));
+	if(si->segments == NULL || si->starts == NULL) {
+		segi_dump(si);
+		return NULL;
+	}
+
+	si->count = 0;
+	si->capacity = SEGI_INITIAL_CAPACITY;
+	si->starts[0] = 0;
+	si->marker = 0;
+	si->segment = 0;
+	return si;
+}
+
+/* appends a string as the next segment */
+BOOL segi_append(SEG_ITERATOR *si, const STRING *sobj)
+{
+	if(sobj == NULL) return FALSE;
+	return segi_append_view(si, str_view(sobj));
+}
+
+/* appends a view as the next segment */
+BOOL segi_append_view(SEG_ITERATOR *si, STRING_VIEW view)
+{
+	STRING_VIEW *segments;
+	long long *starts;
+
+	if(si == NULL || (view.data == NULL && view.length > 0)) return FALSE;
+	if(view.length == 0) return TRUE;
+
+	if(si->count == si->capacity) {
+		segments = (STRING_VIEW*)realloc(si->segments, si->capacity * 2 * sizeof(STRING_VIEW));
+		if(segments == NULL) return FALSE;
+		si->segments = segments;
+
+		starts = (long long*)realloc(si->starts, (si->capacity * 2 + 1) * sizeof(long long));
+		if(starts == NULL) return FALSE;
+		si->starts = starts;
+
+		si->capacity *= 2;
+	}
+
+	si->segments[si->count] = view;
+	si->starts[si->count + 1] = si->starts[si->count] + view.length;
+	++si->count;
+
+	/* a marker at the old end now points at the start of the new segment */
+	si->segment = locate(si, si->marker, si->segment);
+	return TRUE;
+}
+
+/* forgets the leading segments which end at or before a position */
+unsigned int segi_discard_before(SEG_ITERATOR *si, long long position)
+{
+	unsigned int n;
+
+	if(si == NULL) return 0;
+	if(position > si->marker) position = si->marker;
+
+	for(n = 0; n < si->count && si->starts[n + 1] <= position; ++n);
+	if(n == 0) return 0;
+
+	memmove(si->segments, si->segments + n, (si->count - n) * sizeof(STRING_VIEW));
+	memmove(si->starts, si->starts + n, (si->count - n + 1) * sizeof(long long));
+	si->count -= n;
+	si->segment = locate(si, si->marker, 0);
+	return n;
+}
+
+/* returns the position just past the last segment */
+long long segi_length(const SEG_ITERATOR *si)
+{
+	if(si == NULL) return -1;
+	return si->starts[si->count];
+}
+
+/* returns the character at the current marker position */
+char segi_this(const SEG_ITERATOR *si)
+{
+	if(si == NULL || si->segment >= si->count) return -1;
+	return si->segments[si->segment].data[si->marker - si->starts[si->segment]];
+}
+
+/* returns the character to the right of the current marker position */
+char segi_next(const SEG_ITERATOR *si)
+{
+	if(si == NULL) return -1;
+	return char_at(si, si->marker + 1);
+}
+
+/* returns the character to the left of the current marker position */
+char segi_prev(const SEG_ITERATOR *si)
+{
+	if(si == NULL) return -1;
+	return char_at(si, si->marker - 1);
+}
+
+/* returns the current marker position */
+long long segi_pos(const SEG_ITERATOR *si)
+{
+	if(si == NULL) return -1;
+	return (si->marker == si->starts[si->count] ? STRI_EOS : si->marker);
+}
+
+/* moves the marker a certain number of characters, positive for right, negative for left */
+BOOL segi_move(SEG_ITERATOR *si, long long num_chars)
+{
+	if(si == NULL) return FALSE;
+
+	set_marker(si, si->marker + num_chars);
+	return TRUE;
+}
+
+/* moves the marker 1 character to the right */
+BOOL segi_move_next(SEG_ITERATOR *si)
+{
+	return segi_move(si, 1);
+}
+
+/* moves the marker 1 character to the left */
+BOOL segi_move_prev(SEG_ITERATOR *si)
+{
+	return segi_move(si, -1);
+}
+
+/* moves the marker to a position */
+BOOL segi_move_to(SEG_ITERATOR *si, long long position)
+{
+	if(si == NULL) return FALSE;
+
+	set_marker(si, position);
+	return TRUE;
+}
+
+/* moves the marker to the beginning of the first segment */
+BOOL segi_reset(SEG_ITERATOR *si)
+{
+	if(si == NULL) return FALSE;
+
+	set_marker(si, si->starts[0]);
+	return TRUE;
+}
+
+/* moves the marker to the end of the last segment */
+BOOL segi_move_eos(SEG_ITERATOR *si)
+{
+	if(si == NULL) return FALSE;
+
+	set_marker(si, si->starts[si->count]);
+	return TRUE;
+}
+
+/* return TRUE if the marker is at the end of the last segment */
+BOOL segi_is_at_eos(const SEG_ITERATOR *si)
+{
+	if(si == NULL) return FALSE;
+	return (si->marker == si->starts[si->count] ? TRUE : FALSE);
+}
+
+/* moves the marker until one of the given characters is found */
+long long segi_move_until(SEG_ITERATOR *si, const char *chars, int step)
+{
+	CHARSET cs;
+
+	if(si == NULL || chars == NULL) return -1;
+	charset_init(&cs, chars);
+	return scan(si, &cs, TRUE, step);
+}
+
+/* moves the marker until a character other than the given characters is found */
+long long segi_move_while(SEG_ITERATOR *si, const char *chars, int step)
+{
+	CHARSET cs;
+
+	if(si == NULL || chars == NULL) return -1;
+	charset_init(&cs, chars);
+	return scan(si, &cs, FALSE, step);
+}
+
+/* moves the marker until a character belonging to the set is found */
+long long segi_move_until_charset(SEG_ITERATOR *si, const CHARSET *cs, int step)
+{
+	if(si == NULL || cs == NULL) return -1;
+	return scan(si, cs, TRUE, step);
+}
+
+/* moves the marker until a character not belonging to the set is found */
+long long segi_move_while_charset(SEG_ITERATOR *si, const CHARSET *cs, int step)
+{
+	if(si == NULL || cs == NULL) return -1;
+	return scan(si, cs, FALSE, step);
+}
+
+/* returns the characters between two positions as one view */
+STRING_VIEW segi_span(const SEG_ITERATOR *si, long long start, long long end, STRING *scratch)
+{
+	STRING_VIEW view;
+	unsigned int seg, offset, n;
+	long long position;
+
+	view.data = NULL;
+	view.length = 0;
+	if(si == NULL || start < si->starts[0] || end > si->starts[si->count] || start > end || end - start >= (long long)UINT_MAX) return view;
+
+	if(start == end) {
+		view.data = "";
+		return view;
+	}
+
+	seg = locate(si, start, si->segment);
+	offset = (unsigned int)(start - si->starts[seg]);
+
+	/* the common case: the span lies in one segment and is returned in place */
+	if(end <= si->starts[seg + 1]) {
+		view.data = si->segments[seg].data + offset;
+		view.length = (unsigned int)(end - start);
+		return view;
+	}
+
+	if(scratch == NULL || !str_reserve(scratch, (unsigned int)(end - start))) return view;
+
+	for(position = start; position < end; ++seg, offset = 0)
+	{
+		n = si->segments[seg].length - offset;
+		if(n > end - position) n = (unsigned int)(end - position);
+
+		memcpy(scratch->data + (position - start), si->segments[seg].data + offset, n);
+		position += n;
+	}
+
+	scratch->length = (unsigned int)(end - start);
+	scratch->data[scratch->length] = '\0';
+	view.data = scratch->data;
+	view.length = scratch->length;
+	return view;
+}
+
+/* returns the characters between two positions as a new string */
+STRING* segi_substring(const SEG_ITERATOR *si, long long start, long long end)
+{
+	STRING *sres;
+	STRING_VIEW view;
+
+	sres = string("");
+	if(sres == NULL) return NULL;
+
+	view = segi_span(si, start, end, sres);
+	if(view.data == NULL) {
+		str_dump(sres);
+		return NULL;
+	}
+
+	/* a span within one segment was not copied into sres yet */
+	if(view.data != sres->data) {
+		str_dump(sres);
+		return str_from_view(view);
+	}
+	return sres;
+}
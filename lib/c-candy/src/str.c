@@ -22,22 +22,24 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
+#include <limits.h>
 #include <regex.h>
 #include <constants.h>
+#include <charset.h>
 #include <str.h>
 #include <stdio.h>
 
 /* <------------------ private constant declarations -----------------> */
-static const char *WHITESPACE = " \t\n\r\v\f";
 static const char *WHITESPACE_CHAR = " ";
 
 /* <------------------ private function declarations -----------------> */
 static STRING* copy(const STRING *sobj, int length, int dest_start, int src_start, int src_end, BOOL fill_left, char fill_char, BOOL end_with_null);
 static STRING* exact_copy(const STRING *sobj);
-static BOOL is_char_in(char c, const char *s);
 static int regex_match(const char *text, const char *exp, int nmatch, regmatch_t *match_ptr);
 static char* partial_strcpy(const char *text, int start, int end);
 static int strcmpi(const char *s1, const char *s2);
+static BOOL grow(STRING *sobj, unsigned int length);
+static STRING* allocate(unsigned int length);
 
 /* <------------------ private function definitions ------------------> */
 
@@ -67,6 +69,7 @@ static STRING* copy(const STRING *sobj, int length, int dest_start, int src_star
 	if(end_with_null) sres->data[dest_start + src_end - src_start] = '\0';
 
 	sres->length = length;
+	sres->capacity = length;
 	return sres;
 }
 
@@ -76,19 +79,6 @@ static STRING* exact_copy(const STRING *sobj)
 	return copy(sobj, sobj->length, 0, 0, sobj->length, FALSE, NULL, TRUE);
 }
 
-/* Returns TRUE if the given character is within a string */
-static BOOL is_char_in(char c, const char *s)
-{
-	int i, n;
-	if(s == NULL) return FALSE;
-	n = strlen(s);
-	for(i = 0; i < n; ++i)
-	{
-		if(s[i] == c) return TRUE;
-	}
-	return FALSE;
-}
-
 /* matches a regular expression */
 static int regex_match(const char *text, const char *exp, int nmatch, regmatch_t *match_ptr)
 {
@@ -153,6 +143,38 @@ static int strcmpi(const char *s1, const char *s2)
 	return diff;
 }
 
+/* makes room for length characters, at least doubling the buffer so that repeated appends are amortized */
+static BOOL grow(STRING *sobj, unsigned int length)
+{
+	unsigned int capacity;
+
+	if(length <= sobj->capacity) return TRUE;
+
+	capacity = (sobj->capacity > UINT_MAX / 2 ? UINT_MAX - 1 : sobj->capacity * 2);
+	if(capacity < length) capacity = length;
+	return str_reserve(sobj, capacity);
+}
+
+/* allocates a string of the given length whose contents are filled in by the caller */
+static STRING* allocate(unsigned int length)
+{
+	STRING *sres;
+
+	sres = (STRING*)malloc(STR_SIZE);
+	if(sres == NULL) return NULL;
+
+	sres->data = (char*)malloc(length + 1);
+	if(sres->data == NULL) {
+		free(sres);
+		return NULL;
+	}
+
+	sres->data[length] = '\0';
+	sres->length = length;
+	sres->capacity = length;
+	return sres;
+}
+
 /* <------------------ public function definitions ------------------> */
 
 /* Frees memory allocated for the string object */
@@ -199,6 +221,7 @@ STRING* str_blank()
 	if(sobj->data == NULL) return NULL;
 
 	sobj->length = 0;
+	sobj->capacity = 0;
 	return sobj;
 }
 
@@ -216,6 +239,7 @@ STRING* string(const char *s)
 	if(sobj->data == NULL) return NULL;
 
 	sobj->length = n;
+	sobj->capacity = n;
 	strcpy(sobj->data, s);
 	return sobj;
 }
@@ -226,6 +250,39 @@ STRING* str_copy(const STRING *s)
 	return exact_copy(s);
 }
 
+/* returns a non-owning view over a string */
+STRING_VIEW str_view(const STRING *sobj)
+{
+	STRING_VIEW view;
+
+	view.data = (sobj == NULL ? NULL : sobj->data);
+	view.length = (sobj == NULL ? 0 : sobj->length);
+	return view;
+}
+
+/* creates a string object from a view */
+STRING* str_from_view(STRING_VIEW view)
+{
+	STRING *sobj;
+
+	if(view.data == NULL && view.length > 0) return NULL;
+
+	sobj = (STRING*)malloc(STR_SIZE);
+	if(sobj == NULL) return NULL;
+
+	sobj->data = (char*)malloc(view.length + 1);
+	if(sobj->data == NULL) {
+		free(sobj);
+		return NULL;
+	}
+
+	if(view.length > 0) memcpy(sobj->data, view.data, view.length);
+	sobj->data[view.length] = '\0';
+	sobj->length = view.length;
+	sobj->capacity = view.length;
+	return sobj;
+}
+
 /* Returns the number of characters in a string */
 unsigned int str_len(const STRING *sobj)
 {
@@ -233,6 +290,22 @@ unsigned int str_len(const STRING *sobj)
 	return sobj->length;
 }
 
+/* Grows the buffer of a string so that it can hold at least capacity characters */
+BOOL str_reserve(STRING *sobj, unsigned int capacity)
+{
+	char *data;
+
+	if(sobj == NULL) return FALSE;
+	if(capacity <= sobj->capacity) return TRUE;
+
+	data = (char*)realloc(sobj->data, capacity + 1);
+	if(data == NULL) return FALSE;
+
+	sobj->data = data;
+	sobj->capacity = capacity;
+	return TRUE;
+}
+
 /* Converts a STRING object to a C string literal */
 char* cstr(const STRING *sobj)
 {
@@ -262,7 +335,8 @@ char str_char_at(const STRING *sobj, int index)
 /* Returns TRUE if the given character is in the string */
 BOOL str_is_char_in(const STRING *sobj, char c)
 {
-	return is_char_in(c, cstr(sobj));
+	if(sobj == NULL) return FALSE;
+	return memchr(sobj->data, c, sobj->length) != NULL ? TRUE : FALSE;
 }
 
 /* Returns TRUE if a string (sobj) starts with another string (prefix) */
@@ -426,7 +500,7 @@ BOOL str_is_whitespace(const STRING *sobj)
 	if(sobj == NULL) return FALSE;
 	for(i = 0; i < sobj->length; ++i)
 	{
-		if(!is_char_in(sobj->data[i], WHITESPACE)) return FALSE;
+		if(!CHARSET_HAS(&CHARSET_WHITESPACE, sobj->data[i])) return FALSE;
 	}
 	return TRUE;
 }
@@ -525,7 +599,7 @@ STRING* str_title(const STRING *sobj)
 	{
 		c = sres->data[i];
 		if(c >= 97 && c <= 122) {
-			if(i == 0 || is_char_in(sres->data[i-1], WHITESPACE)) sres->data[i] = c - 32;				
+			if(i == 0 || CHARSET_HAS(&CHARSET_WHITESPACE, sres->data[i-1])) sres->data[i] = c - 32;				
 		}
 	}
 
@@ -566,46 +640,48 @@ STRING* str_expand_tabs(const STRING *sobj, unsigned int tab_size)
 /* append another string to the end of this string */
 BOOL str_append(STRING *sobj, const STRING *suffix)
 {
-	STRING *sres;
-	unsigned int i;
+	unsigned int n;
 
 	if(sobj == NULL || suffix == NULL) return FALSE;
-	
-	sres = copy(sobj, sobj->length + suffix->length, 0, 0, sobj->length, FALSE, NULL, FALSE);
-	if(sres == NULL) return FALSE;
 
-	for(i = 0; i < suffix->length; ++i)
-		sres->data[sobj->length + i] = suffix->data[i];
+	/* suffix may be sobj itself, so its length is read before growing */
+	n = suffix->length;
+	if(n > UINT_MAX - 1 - sobj->length) return FALSE;
+	if(!grow(sobj, sobj->length + n)) return FALSE;
 
-	sres->data[sobj->length + suffix->length] = '\0';
-
-	free(sobj);
-	sobj = sres;
+	memcpy(sobj->data + sobj->length, suffix->data, n);
+	sobj->length += n;
+	sobj->data[sobj->length] = '\0';
 	return TRUE;
 }
 
+/* inserts a string at a position of this string */
 BOOL str_insert(STRING *sobj, int index, const STRING *ins_str)
 {
-	STRING *sres;
-	unsigned int i;
+	unsigned int n;
 
 	if(sobj == NULL || ins_str == NULL) return FALSE;
 
 	/* convert negative to positive index */
 	if(index < 0) index += sobj->length;
 
-	if(index > sobj->length) return FALSE;
+	if(index < 0 || index > sobj->length) return FALSE;
 	if(index == sobj->length) return str_append(sobj, ins_str);
-	
-	sres = copy(sobj, sobj->length + ins_str->length, 0, 0, index, FALSE, NULL, FALSE);
-	if(sres == NULL) return FALSE;
-
-	for(i = 0; i < ins_str->length; ++i) sres->data[index + i] = ins_str->data[i];
-	for(i = index; i < sobj->length; ++i) sres->data[ins_str->length + i] = sobj->data[i];
-	sres->data[sobj->length + ins_str->length] = '\0';
 
-	free(sobj);
-	sobj = sres;
+	n = ins_str->length;
+	if(n > UINT_MAX - 1 - sobj->length) return FALSE;
+	if(!grow(sobj, sobj->length + n)) return FALSE;
+
+	memmove(sobj->data + index + n, sobj->data + index, sobj->length - index);
+	if(ins_str == sobj) {
+		/* inserting a string into itself: its two halves now lie on either side of the gap */
+		memcpy(sobj->data + index, sobj->data, index);
+		memcpy(sobj->data + 2 * index, sobj->data + index + n, n - index);
+	} else {
+		memcpy(sobj->data + index, ins_str->data, n);
+	}
+	sobj->length += n;
+	sobj->data[sobj->length] = '\0';
 
 	return TRUE;
 }
@@ -703,44 +779,75 @@ BOOL str_is_empty(const STRING *sobj)
 
 /* removes any leading / trailing whitespaces from a string */
 STRING* str_strip(const STRING *sobj)
+{
+	return str_strip_chars(sobj, &CHARSET_WHITESPACE);
+}
+
+/* removes any leading whitespaces from a string */
+STRING* str_lstrip(const STRING *sobj)
+{
+	return str_lstrip_chars(sobj, &CHARSET_WHITESPACE);
+}
+
+/* removes any trailing whitespaces from a string */
+STRING* str_rstrip(const STRING *sobj)
+{
+	return str_rstrip_chars(sobj, &CHARSET_WHITESPACE);
+}
+
+/* removes any leading / trailing characters belonging to a set from a string */
+STRING* str_strip_chars(const STRING *sobj, const CHARSET *cs)
 {
 	unsigned int start, end;
 
-	if(sobj == NULL) return NULL;
+	if(sobj == NULL || cs == NULL) return NULL;
 	
-	for(start = 0; start < sobj->length && is_char_in(sobj->data[start], WHITESPACE); ++start);
-	for(end = sobj->length; end > 0 && is_char_in(sobj->data[end-1], WHITESPACE); --end);
+	for(start = 0; start < sobj->length && CHARSET_HAS(cs, sobj->data[start]); ++start);
+	for(end = sobj->length; end > start && CHARSET_HAS(cs, sobj->data[end-1]); --end);
 
 	if(start == end) return str_blank();
 	return str_substring(sobj, start, end);
 }
 
-/* removes any leading whitespaces from a string */
-STRING* str_lstrip(const STRING *sobj)
+/* removes any leading characters belonging to a set from a string */
+STRING* str_lstrip_chars(const STRING *sobj, const CHARSET *cs)
 {
 	unsigned int start;
 
-	if(sobj == NULL) return NULL;
+	if(sobj == NULL || cs == NULL) return NULL;
 	
-	for(start = 0; start < sobj->length && is_char_in(sobj->data[start], WHITESPACE); ++start);
+	for(start = 0; start < sobj->length && CHARSET_HAS(cs, sobj->data[start]); ++start);
 
-	if(start == sobj->length-1) return str_blank();
+	if(start == sobj->length) return str_blank();
 	return str_substring(sobj, start, sobj->length);
 }
 
-/* removes any trailing whitespaces from a string */
-STRING* str_rstrip(const STRING *sobj)
+/* removes any trailing characters belonging to a set from a string */
+STRING* str_rstrip_chars(const STRING *sobj, const CHARSET *cs)
 {
 	unsigned int end;
 
-	if(sobj == NULL) return NULL;
+	if(sobj == NULL || cs == NULL) return NULL;
 	
-	for(end = sobj->length; end > 0 && is_char_in(sobj->data[end-1], WHITESPACE); --end);
+	for(end = sobj->length; end > 0 && CHARSET_HAS(cs, sobj->data[end-1]); --end);
 
 	if(end == 0) return str_blank();
 	return str_substring(sobj, 0, end);
 }
 
+/* Returns TRUE if all characters in the string belong to a set */
+BOOL str_is_in_charset(const STRING *sobj, const CHARSET *cs)
+{
+	unsigned int i;
+
+	if(sobj == NULL || cs == NULL) return FALSE;
+	for(i = 0; i < sobj->length; ++i)
+	{
+		if(!CHARSET_HAS(cs, sobj->data[i])) return FALSE;
+	}
+	return TRUE;
+}
+
 /* checks if two strings are equal or not */
 BOOL str_equals(const STRING *sobj1, const STRING *sobj2)
 {
@@ -985,6 +1092,41 @@ STRING** str_split(const STRING *sobj, const char *delimiter, int max_split, int
 	return parts;
 }
 
+/* splits a string at every run of characters belonging to a set */
+STRING** str_split_chars(const STRING *sobj, const CHARSET *delimiters, int max_split, int *split_count)
+{
+	unsigned int i, start;
+	int count;
+	STRING **parts;
+
+	if(split_count != NULL) *split_count = 0;
+	if(sobj == NULL || delimiters == NULL || split_count == NULL || max_split == 0) return NULL;
+	if(max_split < 0) max_split = INT_MAX;
+
+	/* count the parts first so that the array is allocated once at its final size */
+	count = 0;
+	for(i = 0; i < sobj->length && count < max_split; )
+	{
+		while(i < sobj->length && CHARSET_HAS(delimiters, sobj->data[i])) ++i;
+		if(i == sobj->length) break;
+		++count;
+		while(i < sobj->length && !CHARSET_HAS(delimiters, sobj->data[i])) ++i;
+	}
+
+	parts = (STRING**)calloc(count > 0 ? count : 1, sizeof(STRING*));
+	if(parts == NULL) return NULL;
+
+	for(i = 0; i < sobj->length && *split_count < count; )
+	{
+		while(i < sobj->length && CHARSET_HAS(delimiters, sobj->data[i])) ++i;
+		start = i;
+		while(i < sobj->length && !CHARSET_HAS(delimiters, sobj->data[i])) ++i;
+		parts[(*split_count)++] = str_substring(sobj, start, i);
+	}
+
+	return parts;
+}
+
 /* splits a string based on whitespace characters */
 STRING** str_split_whitespace(const STRING *sobj, int max_split, int *split_count)
 {
@@ -1017,13 +1159,125 @@ unsigned long long str_hash(const STRING *sobj)
 	const unsigned int m = 1e9 + 9;
 	unsigned long long hash = 0;
 	unsigned long long p_pow = 1;
+	unsigned int i;
 	
 	if(sobj == NULL) return 0;
 	for(i = 0; i < sobj->length; ++i)
 	{
-		hash = (hash + (sobj->data[i] + 1) * p_pow) % m;
+		hash = (hash + ((unsigned char)sobj->data[i] + 1) * p_pow) % m;
 		p_pow = (p_pow * p) % m;
 	}
 
 	return hash;
 }
+
+/* joins a list of strings with a separator */
+STRING* str_join(const LIST *list, const STRING *separator)
+{
+	if(list == NULL || list->type != TYPE_OBJECT) return NULL;
+	return str_join_array((const STRING**)list->data, list->length, separator);
+}
+
+/* joins an array of strings with a separator */
+STRING* str_join_array(const STRING **items, unsigned int count, const STRING *separator)
+{
+	STRING *sres;
+	unsigned long long length;
+	unsigned int i, sep_length;
+	char *p;
+
+	if(items == NULL && count > 0) return NULL;
+
+	/* compute the final length first so that the result is allocated exactly once */
+	sep_length = (separator == NULL ? 0 : separator->length);
+	length = (count > 0 ? (unsigned long long)sep_length * (count - 1) : 0);
+	for(i = 0; i < count; ++i)
+		if(items[i] != NULL) length += items[i]->length;
+
+	if(length >= UINT_MAX) return NULL;
+
+	sres = allocate((unsigned int)length);
+	if(sres == NULL) return NULL;
+
+	p = sres->data;
+	for(i = 0; i < count; ++i)
+	{
+		if(i > 0 && sep_length > 0) {
+			memcpy(p, separator->data, sep_length);
+			p += sep_length;
+		}
+		if(items[i] != NULL) {
+			memcpy(p, items[i]->data, items[i]->length);
+			p += items[i]->length;
+		}
+	}
+
+	return sres;
+}
+
+/* concatenates a number of strings */
+STRING* str_concat_n(int count, ...)
+{
+	va_list args;
+	const STRING *temp;
+	STRING *sres;
+	unsigned long long length;
+	char *p;
+	int i;
+
+	if(count < 0) return NULL;
+
+	length = 0;
+	va_start(args, count);
+	for(i = 0; i < count; ++i)
+	{
+		temp = va_arg(args, const STRING*);
+		if(temp != NULL) length += temp->length;
+	}
+	va_end(args);
+
+	if(length >= UINT_MAX) return NULL;
+
+	sres = allocate((unsigned int)length);
+	if(sres == NULL) return NULL;
+
+	p = sres->data;
+	va_start(args, count);
+	for(i = 0; i < count; ++i)
+	{
+		temp = va_arg(args, const STRING*);
+		if(temp != NULL) {
+			memcpy(p, temp->data, temp->length);
+			p += temp->length;
+		}
+	}
+	va_end(args);
+
+	return sres;
+}
+
+/* repeats a string a number of times */
+STRING* str_repeat(const STRING *sobj, unsigned int times)
+{
+	STRING *sres;
+	unsigned long long length;
+	unsigned int filled, chunk;
+
+	if(sobj == NULL) return NULL;
+
+	length = (unsigned long long)sobj->length * times;
+	if(length >= UINT_MAX) return NULL;
+
+	sres = allocate((unsigned int)length);
+	if(sres == NULL || length == 0) return sres;
+
+	/* copy once, then keep doubling the filled part */
+	memcpy(sres->data, sobj->data, sobj->length);
+	for(filled = sobj->length; filled < sres->length; filled += chunk)
+	{
+		chunk = (filled < sres->length - filled ? filled : sres->length - filled);
+		memcpy(sres->data + filled, sres->data, chunk);
+	}
+
+	return sres;
+}
@@ -0,0 +1,263 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strarray.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <strarray.h>
+
+/* <------------------ private function declarations -----------------> */
+static BOOL reserve(STRING_ARRAY *arr, unsigned int bytes);
+
+/* <------------------ private function definitions ------------------> */
+
+/* makes room for one more element of a given size (including its '\0') */
+static BOOL reserve(STRING_ARRAY *arr, unsigned int bytes)
+{
+	unsigned long long needed, capacity;
+	unsigned int *offsets;
+	char *data;
+
+	if(arr->count + 1 == arr->offset_capacity) {
+		offsets = (unsigned int*)realloc(arr->offsets, (size_t)arr->offset_capacity * 2 * sizeof(unsigned int));
+		if(offsets == NULL) return FALSE;
+		arr->offsets = offsets;
+		arr->offset_capacity *= 2;
+	}
+
+	needed = (unsigned long long)arr->offsets[arr->count] + bytes;
+	if(needed > arr->capacity) {
+		if(needed > UINT_MAX) return FALSE;
+
+		capacity = (unsigned long long)arr->capacity * 2;
+		if(capacity < needed) capacity = needed;
+		if(capacity > UINT_MAX) capacity = UINT_MAX;
+
+		data = (char*)realloc(arr->data, (size_t)capacity);
+		if(data == NULL) return FALSE;
+		arr->data = data;
+		arr->capacity = (unsigned int)capacity;
+	}
+
+	return TRUE;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for a string array */
+void sa_dump(STRING_ARRAY *arr)
+{
+	if(arr == NULL) return;
+
+	free(arr->data);
+	free(arr->offsets);
+	free(arr);
+}
+
+/* creates an empty string array */
+STRING_ARRAY* string_array(unsigned int count_hint, unsigned int bytes_hint)
+{
+	STRING_ARRAY *arr;
+
+	arr = (STRING_ARRAY*)malloc(sizeof(STRING_ARRAY));
+	if(arr == NULL) return NULL;
+
+	if(count_hint < 16) count_hint = 16;
+	if(bytes_hint < 256) bytes_hint = 256;
+
+	arr->data = (char*)malloc(bytes_hint);
+	arr->offsets = (unsigned int*)malloc(((size_t)count_hint + 1) * sizeof(unsigned int));
+	if(arr->data == NULL || arr->offsets == NULL) {
+		sa_dump(arr);
+		return NULL;
+	}
+
+	arr->capacity = bytes_hint;
+	arr->offset_capacity = count_hint + 1;
+	arr->count = 0;
+	arr->offsets[0] = 0;
+	return arr;
+}
+
+/* removes all elements */
+void sa_clear(STRING_ARRAY *arr)
+{
+	if(arr == NULL) return;
+
+	arr->count = 0;
+	arr->offsets[0] = 0;
+}
+
+/* returns the number of elements in a string array */
+unsigned int sa_count(const STRING_ARRAY *arr)
+{
+	if(arr == NULL) return 0;
+	return arr->count;
+}
+
+/* returns a view of an element */
+STRING_VIEW sa_get(const STRING_ARRAY *arr, unsigned int index)
+{
+	STRING_VIEW view;
+
+	if(arr == NULL || index >= arr->count) {
+		view.data = NULL;
+		view.length = 0;
+		return view;
+	}
+
+	view.data = arr->data + arr->offsets[index];
+	view.length = arr->offsets[index + 1] - arr->offsets[index] - 1;
+	return view;
+}
+
+/* returns a copy of an element as a new string */
+STRING* sa_string(const STRING_ARRAY *arr, unsigned int index)
+{
+	if(arr == NULL || index >= arr->count) return NULL;
+	return str_from_view(sa_get(arr, index));
+}
+
+/* appends a range of characters as a new element */
+BOOL sa_append_chars(STRING_ARRAY *arr, const char *data, unsigned int length)
+{
+	char *dest;
+	size_t inside;
+
+	if(arr == NULL || (data == NULL && length > 0)) return FALSE;
+
+	/* the source may move if it lies in the buffer being grown */
+	inside = (data >= arr->data && data < arr->data + arr->capacity ? (size_t)(data - arr->data) + 1 : 0);
+
+	dest = sa_push(arr, length);
+	if(dest == NULL) return FALSE;
+
+	memcpy(dest, (inside > 0 ? arr->data + inside - 1 : data), length);
+	return TRUE;
+}
+
+/* appends a copy of a string as a new element */
+BOOL sa_append(STRING_ARRAY *arr, const STRING *sobj)
+{
+	if(sobj == NULL) return FALSE;
+	return sa_append_chars(arr, sobj->data, sobj->length);
+}
+
+/* appends a copy of a string view as a new element */
+BOOL sa_append_view(STRING_ARRAY *arr, STRING_VIEW view)
+{
+	return sa_append_chars(arr, view.data, view.length);
+}
+
+/* appends a new element of a given length */
+char* sa_push(STRING_ARRAY *arr, unsigned int length)
+{
+	char *dest;
+
+	if(arr == NULL || length == UINT_MAX || !reserve(arr, length + 1)) return NULL;
+
+	dest = arr->data + arr->offsets[arr->count];
+	dest[length] = '\0';
+
+	arr->offsets[arr->count + 1] = arr->offsets[arr->count] + length + 1;
+	++arr->count;
+	return dest;
+}
+
+/* shortens the last element */
+BOOL sa_truncate_last(STRING_ARRAY *arr, unsigned int length)
+{
+	unsigned int start;
+
+	if(arr == NULL || arr->count == 0) return FALSE;
+
+	start = arr->offsets[arr->count - 1];
+	if(length > arr->offsets[arr->count] - start - 1) return FALSE;
+
+	arr->data[start + length] = '\0';
+	arr->offsets[arr->count] = start + length + 1;
+	return TRUE;
+}
+
+/* splits a string at a delimiter into a string array */
+int str_split_array(const STRING *sobj, const char *delimiter, int max_split, STRING_ARRAY *arr)
+{
+	const char *p, *end, *match;
+	unsigned int n;
+	int count;
+
+	if(sobj == NULL || delimiter == NULL || arr == NULL) return -1;
+	if(max_split < 0) max_split = INT_MAX;
+
+	n = strlen(delimiter);
+	end = sobj->data + sobj->length;
+	count = 0;
+	for(p = sobj->data; p < end && count < max_split; p = match + n)
+	{
+		/* memchr finds the candidates, memcmp confirms them */
+		match = p;
+		while(n > 0 && (match = (const char*)memchr(match, delimiter[0], end - match)) != NULL)
+		{
+			if((size_t)(end - match) < n) {
+				match = NULL;
+				break;
+			}
+			if(memcmp(match, delimiter, n) == 0) break;
+			++match;
+		}
+		if(n == 0 || match == NULL) match = end;
+
+		if(match > p) {
+			if(!sa_append_chars(arr, p, match - p)) return -1;
+			++count;
+		}
+		if(match == end) break;
+	}
+
+	return count;
+}
+
+/* splits a string at runs of characters belonging to a set into a string array */
+int str_split_chars_array(const STRING *sobj, const CHARSET *delimiters, int max_split, STRING_ARRAY *arr)
+{
+	unsigned int i, start;
+	int count;
+
+	if(sobj == NULL || delimiters == NULL || arr == NULL) return -1;
+	if(max_split < 0) max_split = INT_MAX;
+
+	count = 0;
+	for(i = 0; i < sobj->length && count < max_split; )
+	{
+		while(i < sobj->length && CHARSET_HAS(delimiters, sobj->data[i])) ++i;
+		if(i == sobj->length) break;
+
+		start = i;
+		while(i < sobj->length && !CHARSET_HAS(delimiters, sobj->data[i])) ++i;
+		if(!sa_append_chars(arr, sobj->data + start, i - start)) return -1;
+		++count;
+	}
+
+	return count;
+}
@@ -0,0 +1,529 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strdict.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <constants.h>
+#include <str.h>
+#include <strdict.h>
+
+/* <------------------ private function declarations -----------------> */
+static unsigned long long get64(const unsigned char *p);
+static unsigned int get32(const unsigned char *p);
+static void put64(unsigned char *p, unsigned long long value);
+static void put32(unsigned char *p, unsigned int value);
+static BOOL write_bytes(STR_DICT_BUILDER *sdb, const void *data, size_t length);
+static BOOL write_varint(STR_DICT_BUILDER *sdb, unsigned int value);
+static BOOL read_varint(const STR_DICT *sd, size_t *offset, unsigned int *value);
+static size_t block_offset(const STR_DICT *sd, unsigned int block);
+static unsigned int common_prefix(const unsigned char *a, unsigned int alen, const unsigned char *b, unsigned int blen);
+static int block_first_less(const STR_DICT *sd, unsigned int block, const unsigned char *q, unsigned int qlen, BOOL prefix_end, unsigned int *lcp);
+static int seek(const STR_DICT *sd, const unsigned char *q, unsigned int qlen, BOOL prefix_end, BOOL *exact);
+static size_t decode(const STR_DICT *sd, unsigned int ordinal, size_t offset, STRING *key);
+
+/* <------------------ private function definitions ------------------> */
+
+/* reads a little-endian 64-bit integer */
+static unsigned long long get64(const unsigned char *p)
+{
+	return (unsigned long long)get32(p) | ((unsigned long long)get32(p + 4) << 32);
+}
+
+/* reads a little-endian 32-bit integer */
+static unsigned int get32(const unsigned char *p)
+{
+	return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+/* stores a little-endian 64-bit integer */
+static void put64(unsigned char *p, unsigned long long value)
+{
+	put32(p, (unsigned int)value);
+	put32(p + 4, (unsigned int)(value >> 32));
+}
+
+/* stores a little-endian 32-bit integer */
+static void put32(unsigned char *p, unsigned int value)
+{
+	p[0] = (unsigned char)value;
+	p[1] = (unsigned char)(value >> 8);
+	p[2] = (unsigned char)(value >> 16);
+	p[3] = (unsigned char)(value >> 24);
+}
+
+/* writes bytes to the file of a builder */
+static BOOL write_bytes(STR_DICT_BUILDER *sdb, const void *data, size_t length)
+{
+	if(length > 0 && fwrite(data, 1, length, sdb->fp) != length) {
+		sdb->error = TRUE;
+		return FALSE;
+	}
+
+	sdb->position += length;
+	return TRUE;
+}
+
+/* writes an unsigned integer in 7-bit groups, low group first, the high bit marking that more follow */
+static BOOL write_varint(STR_DICT_BUILDER *sdb, unsigned int value)
+{
+	unsigned char bytes[5];
+	unsigned int n;
+
+	n = 0;
+	while(value >= 0x80)
+	{
+		bytes[n++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	bytes[n++] = (unsigned char)value;
+
+	return write_bytes(sdb, bytes, n);
+}
+
+/* reads an unsigned integer written by write_varint() */
+static BOOL read_varint(const STR_DICT *sd, size_t *offset, unsigned int *value)
+{
+	unsigned int shift;
+	unsigned char byte;
+
+	*value = 0;
+	for(shift = 0; shift < 35; shift += 7)
+	{
+		if(*offset >= sd->size) return FALSE;
+
+		byte = sd->map[(*offset)++];
+		*value |= (unsigned int)(byte & 0x7f) << shift;
+		if((byte & 0x80) == 0) return TRUE;
+	}
+
+	return FALSE;
+}
+
+/* returns the file offset of a block */
+static size_t block_offset(const STR_DICT *sd, unsigned int block)
+{
+	return (size_t)get64(sd->index + 8 * (size_t)block);
+}
+
+/* returns the length of the common prefix of two byte ranges */
+static unsigned int common_prefix(const unsigned char *a, unsigned int alen, const unsigned char *b, unsigned int blen)
+{
+	unsigned int i, n;
+
+	n = (alen < blen ? alen : blen);
+	for(i = 0; i < n && a[i] == b[i]; ++i);
+	return i;
+}
+
+/*
+ * checks if the first key of a block orders before a query (1) or not (0), or -1 if the file is damaged;
+ * with prefix_end, every key starting with the query counts as before it
+ */
+static int block_first_less(const STR_DICT *sd, unsigned int block, const unsigned char *q, unsigned int qlen, BOOL prefix_end, unsigned int *lcp)
+{
+	const unsigned char *key;
+	size_t offset;
+	unsigned int length, m;
+
+	offset = block_offset(sd, block);
+	if(!read_varint(sd, &offset, &length) || length > sd->size - offset) return -1;
+
+	key = sd->map + offset;
+	m = common_prefix(key, length, q, qlen);
+	if(lcp != NULL) *lcp = m;
+
+	if(m == qlen) return (prefix_end ? 1 : 0);
+	if(m == length) return 1;
+	return (key[m] < q[m] ? 1 : 0);
+}
+
+/*
+ * finds the ordinal of the first key that does not order before a query, without decoding any key: while
+ * scanning a block, m is the common prefix length of the query with the last key seen (which orders before it),
+ * and a key sharing more than m characters with that key orders before the query too
+ */
+static int seek(const STR_DICT *sd, const unsigned char *q, unsigned int qlen, BOOL prefix_end, BOOL *exact)
+{
+	const unsigned char *suffix;
+	size_t offset;
+	unsigned int lo, hi, mid, block, j, m, extended, shared, suffix_length, first;
+	int less;
+
+	*exact = FALSE;
+	if(sd->count == 0) return 0;
+
+	/* binary search for the number of blocks whose first key orders before the query */
+	lo = 0;
+	hi = sd->block_count;
+	while(lo < hi)
+	{
+		mid = lo + (hi - lo) / 2;
+		less = block_first_less(sd, mid, q, qlen, prefix_end, NULL);
+		if(less < 0) return -1;
+
+		if(less) lo = mid + 1;
+		else hi = mid;
+	}
+
+	if(lo == 0) {
+		if(!prefix_end && block_first_less(sd, 0, q, qlen, FALSE, &m) == 0 && m == qlen) {
+			offset = block_offset(sd, 0);
+			read_varint(sd, &offset, &j);
+			*exact = (j == qlen);
+		}
+		return 0;
+	}
+
+	/* scan the last such block */
+	block = lo - 1;
+	block_first_less(sd, block, q, qlen, prefix_end, &m);
+	offset = block_offset(sd, block);
+	read_varint(sd, &offset, &j);
+	offset += j;
+
+	first = block * sd->block_size;
+	for(j = 1; j < sd->block_size && first + j < sd->count; ++j)
+	{
+		if(!read_varint(sd, &offset, &shared) || !read_varint(sd, &offset, &suffix_length) || suffix_length > sd->size - offset) return -1;
+		suffix = sd->map + offset;
+		offset += suffix_length;
+
+		if(shared > m) continue;
+		if(shared < m) return (int)(first + j);
+
+		extended = m + common_prefix(suffix, suffix_length, q + m, qlen - m);
+		if(extended == qlen) {
+			if(prefix_end) {
+				m = extended;
+				continue;
+			}
+			*exact = (shared + suffix_length == qlen);
+			return (int)(first + j);
+		}
+
+		if(extended == shared + suffix_length || suffix[extended - shared] < q[extended]) {
+			m = extended;
+			continue;
+		}
+		return (int)(first + j);
+	}
+
+	/* every key of the block orders before the query, so the answer is the first key of the next block */
+	first += j;
+	if(!prefix_end && first < sd->count && block_first_less(sd, block + 1, q, qlen, FALSE, &m) == 0 && m == qlen) {
+		offset = block_offset(sd, block + 1);
+		read_varint(sd, &offset, &j);
+		*exact = (j == qlen);
+	}
+	return (int)first;
+}
+
+/* decodes the key at an ordinal, stored at an offset, from the previous key held in the string */
+static size_t decode(const STR_DICT *sd, unsigned int ordinal, size_t offset, STRING *key)
+{
+	unsigned int shared, suffix_length;
+
+	if(ordinal % sd->block_size == 0) {
+		offset = block_offset(sd, ordinal / sd->block_size);
+		shared = 0;
+	} else {
+		if(!read_varint(sd, &offset, &shared) || shared > key->length) return 0;
+	}
+
+	if(!read_varint(sd, &offset, &suffix_length) || suffix_length > sd->size - offset) return 0;
+	if(!str_reserve(key, shared + suffix_length)) return 0;
+
+	memcpy(key->data + shared, sd->map + offset, suffix_length);
+	key->length = shared + suffix_length;
+	key->data[key->length] = '\0';
+	return offset + suffix_length;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for a dictionary builder */
+void sdb_dump(STR_DICT_BUILDER *sdb)
+{
+	if(sdb == NULL) return;
+
+	if(sdb->fp != NULL) fclose(sdb->fp);
+	str_dump(sdb->previous);
+	free(sdb->offsets);
+	free(sdb);
+}
+
+/* creates a builder writing a new dictionary file */
+STR_DICT_BUILDER* str_dict_builder(const char *path, unsigned int block_size)
+{
+	STR_DICT_BUILDER *sdb;
+	unsigned char header[SD_HEADER_SIZE];
+
+	if(path == NULL) return NULL;
+
+	sdb = (STR_DICT_BUILDER*)malloc(sizeof(STR_DICT_BUILDER));
+	if(sdb == NULL) return NULL;
+
+	sdb->fp = fopen(path, "wb");
+	sdb->previous = string("");
+	sdb->offsets = NULL;
+	if(sdb->fp == NULL || sdb->previous == NULL) {
+		sdb_dump(sdb);
+		return NULL;
+	}
+
+	sdb->block_count = sdb->block_capacity = 0;
+	sdb->position = 0;
+	sdb->count = 0;
+	sdb->block_size = (block_size == 0 ? SD_DEFAULT_BLOCK_SIZE : block_size);
+	sdb->error = FALSE;
+
+	/* the header is filled in by sdb_finish() */
+	memset(header, 0, SD_HEADER_SIZE);
+	write_bytes(sdb, header, SD_HEADER_SIZE);
+	return sdb;
+}
+
+/* appends a key to the dictionary */
+BOOL sdb_add(STR_DICT_BUILDER *sdb, const STRING *key)
+{
+	unsigned long long *offsets;
+	unsigned int shared;
+	int order;
+
+	if(sdb == NULL || key == NULL || sdb->fp == NULL || sdb->error || sdb->count == INT_MAX) return FALSE;
+
+	shared = common_prefix((const unsigned char*)sdb->previous->data, sdb->previous->length, (const unsigned char*)key->data, key->length);
+	if(sdb->count > 0) {
+		order = (shared < key->length && shared < sdb->previous->length ? (unsigned char)key->data[shared] - (unsigned char)sdb->previous->data[shared] : (int)key->length - (int)sdb->previous->length);
+		if(order <= 0) return FALSE;
+	}
+
+	if(sdb->count % sdb->block_size == 0) {
+		if(sdb->block_count == sdb->block_capacity) {
+			offsets = (unsigned long long*)realloc(sdb->offsets, (sdb->block_capacity * 2 + 64) * sizeof(unsigned long long));
+			if(offsets == NULL) return FALSE;
+			sdb->offsets = offsets;
+			sdb->block_capacity = sdb->block_capacity * 2 + 64;
+		}
+
+		/* the first key of a block is stored whole, so lookups can compare against it directly */
+		sdb->offsets[sdb->block_count++] = sdb->position;
+		shared = 0;
+	} else if(!write_varint(sdb, shared)) {
+		return FALSE;
+	}
+
+	if(!write_varint(sdb, key->length - shared) || !write_bytes(sdb, key->data + shared, key->length - shared)) return FALSE;
+
+	if(!str_reserve(sdb->previous, key->length)) {
+		sdb->error = TRUE;
+		return FALSE;
+	}
+	memcpy(sdb->previous->data + shared, key->data + shared, key->length - shared);
+	sdb->previous->length = key->length;
+	sdb->previous->data[key->length] = '\0';
+
+	++sdb->count;
+	return TRUE;
+}
+
+/* writes the block index and header and closes the file */
+BOOL sdb_finish(STR_DICT_BUILDER *sdb)
+{
+	unsigned char header[SD_HEADER_SIZE], entry[8];
+	unsigned long long index_offset;
+	unsigned int i;
+
+	if(sdb == NULL || sdb->fp == NULL) return FALSE;
+
+	index_offset = sdb->position;
+	for(i = 0; i < sdb->block_count; ++i)
+	{
+		put64(entry, sdb->offsets[i]);
+		if(!write_bytes(sdb, entry, 8)) break;
+	}
+
+	memset(header, 0, SD_HEADER_SIZE);
+	memcpy(header, SD_MAGIC, 8);
+	put32(header + 8, sdb->count);
+	put32(header + 12, sdb->block_size);
+	put32(header + 16, sdb->block_count);
+	put64(header + 24, index_offset);
+
+	if(fseek(sdb->fp, 0, SEEK_SET) != 0 || fwrite(header, 1, SD_HEADER_SIZE, sdb->fp) != SD_HEADER_SIZE) sdb->error = TRUE;
+	if(fclose(sdb->fp) != 0) sdb->error = TRUE;
+	sdb->fp = NULL;
+
+	return (sdb->error ? FALSE : TRUE);
+}
+
+/* unmaps a dictionary and frees memory allocated for it */
+void sd_dump(STR_DICT *sd)
+{
+	if(sd == NULL) return;
+
+	if(sd->map != NULL) munmap((void*)sd->map, sd->size);
+	free(sd);
+}
+
+/* maps a dictionary file into memory */
+STR_DICT* str_dict_open(const char *path)
+{
+	STR_DICT *sd;
+	struct stat st;
+	void *map;
+	unsigned long long index_offset;
+	int fd;
+
+	if(path == NULL) return NULL;
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0) return NULL;
+
+	if(fstat(fd, &st) != 0 || st.st_size < SD_HEADER_SIZE) {
+		close(fd);
+		return NULL;
+	}
+
+	/* the mapping stays valid after the descriptor is closed */
+	map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED) return NULL;
+
+	sd = (STR_DICT*)malloc(sizeof(STR_DICT));
+	if(sd == NULL) {
+		munmap(map, (size_t)st.st_size);
+		return NULL;
+	}
+
+	sd->map = (const unsigned char*)map;
+	sd->size = (size_t)st.st_size;
+	sd->count = get32(sd->map + 8);
+	sd->block_size = get32(sd->map + 12);
+	sd->block_count = get32(sd->map + 16);
+	index_offset = get64(sd->map + 24);
+
+	if(memcmp(sd->map, SD_MAGIC, 8) != 0 || sd->block_size == 0 || sd->count > INT_MAX
+		|| sd->block_count != sd->count / sd->block_size + (sd->count % sd->block_size != 0)
+		|| index_offset > sd->size || (sd->size - index_offset) / 8 < sd->block_count) {
+		sd_dump(sd);
+		return NULL;
+	}
+
+	sd->index = sd->map + index_offset;
+	return sd;
+}
+
+/* returns the number of keys in a dictionary */
+unsigned int sd_count(const STR_DICT *sd)
+{
+	if(sd == NULL) return 0;
+	return sd->count;
+}
+
+/* looks up a key */
+int sd_find(const STR_DICT *sd, const STRING *key)
+{
+	BOOL exact;
+	int ordinal;
+
+	if(sd == NULL || key == NULL) return -1;
+
+	ordinal = seek(sd, (const unsigned char*)key->data, key->length, FALSE, &exact);
+	return (exact ? ordinal : -1);
+}
+
+/* finds the first key not less than a given string */
+int sd_lower_bound(const STR_DICT *sd, const STRING *key)
+{
+	BOOL exact;
+
+	if(sd == NULL || key == NULL) return -1;
+	return seek(sd, (const unsigned char*)key->data, key->length, FALSE, &exact);
+}
+
+/* finds the keys starting with a prefix */
+BOOL sd_prefix_range(const STR_DICT *sd, const STRING *prefix, unsigned int *first, unsigned int *last)
+{
+	BOOL exact;
+	int from, to;
+
+	if(sd == NULL || prefix == NULL || first == NULL || last == NULL) return FALSE;
+
+	from = seek(sd, (const unsigned char*)prefix->data, prefix->length, FALSE, &exact);
+	to = seek(sd, (const unsigned char*)prefix->data, prefix->length, TRUE, &exact);
+	if(from < 0 || to < 0) return FALSE;
+
+	*first = (unsigned int)from;
+	*last = (unsigned int)to;
+	return TRUE;
+}
+
+/* decodes the key at an ordinal */
+BOOL sd_get(const STR_DICT *sd, unsigned int ordinal, STRING *key)
+{
+	STR_DICT_CURSOR cursor;
+
+	if(sd == NULL || key == NULL || ordinal >= sd->count) return FALSE;
+
+	sd_cursor(sd, ordinal, &cursor);
+	return sd_next(&cursor, key);
+}
+
+/* positions a cursor at an ordinal */
+void sd_cursor(const STR_DICT *sd, unsigned int ordinal, STR_DICT_CURSOR *cursor)
+{
+	if(cursor == NULL) return;
+
+	cursor->dict = sd;
+	cursor->start = ordinal;
+	cursor->offset = 0;
+	if(sd == NULL || ordinal >= sd->count)
+		cursor->ordinal = (sd == NULL ? 0 : sd->count);
+	else
+		cursor->ordinal = ordinal - ordinal % sd->block_size;
+}
+
+/* reads the next key of a cursor */
+BOOL sd_next(STR_DICT_CURSOR *cursor, STRING *key)
+{
+	if(cursor == NULL || key == NULL || cursor->dict == NULL) return FALSE;
+
+	/* keys before the requested one in its block are decoded only to rebuild the shared prefixes */
+	while(cursor->ordinal < cursor->dict->count)
+	{
+		cursor->offset = decode(cursor->dict, cursor->ordinal, cursor->offset, key);
+		if(cursor->offset == 0) {
+			cursor->ordinal = cursor->dict->count;
+			return FALSE;
+		}
+
+		if(cursor->ordinal++ >= cursor->start) return TRUE;
+	}
+
+	return FALSE;
+}
@@ -0,0 +1,503 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strdiff.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <constants.h>
+#include <list.h>
+#include <str.h>
+#include <strdiff.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define DIFF_INITIAL_CAPACITY		16
+#define NO_SLOT						UINT_MAX
+
+/* the two sequences being compared: bytes, or the ids of interned lines */
+typedef struct {
+	const unsigned char *a8;
+	const unsigned char *b8;
+	const unsigned int *a32;
+	const unsigned int *b32;
+	int *v1;
+	int *v2;
+	DIFF_SCRIPT *script;
+	BOOL failed;
+} DIFF_CONTEXT;
+
+#define SAME(ctx, x, y)		((ctx)->a8 != NULL ? (ctx)->a8[x] == (ctx)->b8[y] : (ctx)->a32[x] == (ctx)->b32[y])
+
+/* <------------------ private function declarations -----------------> */
+static DIFF_SCRIPT* new_script();
+static void emit(DIFF_CONTEXT *ctx, int op, unsigned int a_start, unsigned int b_start, unsigned int length);
+static BOOL bisect(DIFF_CONTEXT *ctx, int a0, int a1, int b0, int b1, int *x, int *y);
+static void compare(DIFF_CONTEXT *ctx, int a0, int a1, int b0, int b1);
+static void compact(DIFF_SCRIPT *script);
+static DIFF_SCRIPT* diff(DIFF_CONTEXT *ctx, unsigned int n, unsigned int m);
+static unsigned long long hash_view(STRING_VIEW view);
+static BOOL intern(const STRING_VIEW *views, unsigned int count, unsigned int *ids);
+static STRING_VIEW* split_lines(const STRING *sobj, unsigned int *count);
+static DIFF_SCRIPT* diff_views(STRING_VIEW *views, unsigned int n, unsigned int m);
+
+/* <------------------ private function definitions ------------------> */
+
+/* creates an empty edit script */
+static DIFF_SCRIPT* new_script()
+{
+	DIFF_SCRIPT *script;
+
+	script = (DIFF_SCRIPT*)malloc(sizeof(DIFF_SCRIPT));
+	if(script == NULL) return NULL;
+
+	script->edits = (DIFF_EDIT*)malloc(DIFF_INITIAL_CAPACITY * sizeof(DIFF_EDIT));
+	if(script->edits == NULL) {
+		free(script);
+		return NULL;
+	}
+
+	script->count = 0;
+	script->capacity = DIFF_INITIAL_CAPACITY;
+	return script;
+}
+
+/* appends an edit to the script, extending the last edit if it continues it */
+static void emit(DIFF_CONTEXT *ctx, int op, unsigned int a_start, unsigned int b_start, unsigned int length)
+{
+	DIFF_SCRIPT *script;
+	DIFF_EDIT *last, *temp;
+
+	if(length == 0 || ctx->failed) return;
+
+	script = ctx->script;
+	if(script->count > 0) {
+		last = &script->edits[script->count - 1];
+		if(last->op == op && last->a_start + (op == DIFF_INSERT ? 0 : last->length) == a_start
+			&& last->b_start + (op == DIFF_DELETE ? 0 : last->length) == b_start) {
+			last->length += length;
+			return;
+		}
+	}
+
+	if(script->count == script->capacity) {
+		temp = (DIFF_EDIT*)realloc(script->edits, script->capacity * 2 * sizeof(DIFF_EDIT));
+		if(temp == NULL) {
+			ctx->failed = TRUE;
+			return;
+		}
+		script->edits = temp;
+		script->capacity *= 2;
+	}
+
+	script->edits[script->count].op = op;
+	script->edits[script->count].a_start = a_start;
+	script->edits[script->count].b_start = b_start;
+	script->edits[script->count].length = length;
+	++script->count;
+}
+
+/* finds a point on a shortest edit path through the middle of two ranges (Myers' middle snake) */
+static BOOL bisect(DIFF_CONTEXT *ctx, int a0, int a1, int b0, int b1, int *x, int *y)
+{
+	int *v1, *v2;
+	int n, m, max_d, offset, v_length, delta, d, k1, k2, k1_offset, k2_offset, x1, y1, x2, y2, i;
+	int k1_start, k1_end, k2_start, k2_end;
+	BOOL front;
+
+	n = a1 - a0;
+	m = b1 - b0;
+	max_d = (n + m + 1) / 2;
+	offset = max_d;
+	v_length = 2 * max_d + 2;
+	delta = n - m;
+	front = ((delta & 1) != 0);
+
+	/* v1 holds the furthest x reached on each diagonal going forward, v2 the same going backward */
+	v1 = ctx->v1;
+	v2 = ctx->v2;
+	for(i = 0; i < v_length; ++i) v1[i] = v2[i] = -1;
+	v1[offset + 1] = 0;
+	v2[offset + 1] = 0;
+
+	k1_start = k1_end = k2_start = k2_end = 0;
+	for(d = 0; d < max_d; ++d)
+	{
+		for(k1 = -d + k1_start; k1 <= d - k1_end; k1 += 2)
+		{
+			k1_offset = offset + k1;
+			if(k1 == -d || (k1 != d && v1[k1_offset - 1] < v1[k1_offset + 1]))
+				x1 = v1[k1_offset + 1];
+			else
+				x1 = v1[k1_offset - 1] + 1;
+
+			y1 = x1 - k1;
+			while(x1 < n && y1 < m && SAME(ctx, a0 + x1, b0 + y1)) { ++x1; ++y1; }
+			v1[k1_offset] = x1;
+
+			if(x1 > n) {
+				k1_end += 2;
+			} else if(y1 > m) {
+				k1_start += 2;
+			} else if(front) {
+				k2_offset = offset + delta - k1;
+				if(k2_offset >= 0 && k2_offset < v_length && v2[k2_offset] != -1 && x1 >= n - v2[k2_offset]) {
+					*x = a0 + x1;
+					*y = b0 + y1;
+					return TRUE;
+				}
+			}
+		}
+
+		for(k2 = -d + k2_start; k2 <= d - k2_end; k2 += 2)
+		{
+			k2_offset = offset + k2;
+			if(k2 == -d || (k2 != d && v2[k2_offset - 1] < v2[k2_offset + 1]))
+				x2 = v2[k2_offset + 1];
+			else
+				x2 = v2[k2_offset - 1] + 1;
+
+			y2 = x2 - k2;
+			while(x2 < n && y2 < m && SAME(ctx, a1 - x2 - 1, b1 - y2 - 1)) { ++x2; ++y2; }
+			v2[k2_offset] = x2;
+
+			if(x2 > n) {
+				k2_end += 2;
+			} else if(y2 > m) {
+				k2_start += 2;
+			} else if(!front) {
+				k1_offset = offset + delta - k2;
+				if(k1_offset >= 0 && k1_offset < v_length && v1[k1_offset] != -1) {
+					x1 = v1[k1_offset];
+					y1 = offset + x1 - k1_offset;
+					if(x1 >= n - x2) {
+						*x = a0 + x1;
+						*y = b0 + y1;
+						return TRUE;
+					}
+				}
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+/* emits the edits turning one range into another */
+static void compare(DIFF_CONTEXT *ctx, int a0, int a1, int b0, int b1)
+{
+	int prefix, suffix, x, y;
+
+	/* common prefixes and suffixes are cheap to strip and are often most of the input */
+	prefix = 0;
+	while(a0 + prefix < a1 && b0 + prefix < b1 && SAME(ctx, a0 + prefix, b0 + prefix)) ++prefix;
+	emit(ctx, DIFF_EQUAL, a0, b0, prefix);
+	a0 += prefix;
+	b0 += prefix;
+
+	suffix = 0;
+	while(a1 - suffix > a0 && b1 - suffix > b0 && SAME(ctx, a1 - suffix - 1, b1 - suffix - 1)) ++suffix;
+	a1 -= suffix;
+	b1 -= suffix;
+
+	if(a0 == a1) {
+		emit(ctx, DIFF_INSERT, a0, b0, b1 - b0);
+	} else if(b0 == b1) {
+		emit(ctx, DIFF_DELETE, a0, b0, a1 - a0);
+	} else if(bisect(ctx, a0, a1, b0, b1, &x, &y)) {
+		compare(ctx, a0, x, b0, y);
+		compare(ctx, x, a1, y, b1);
+	} else {
+		emit(ctx, DIFF_DELETE, a0, b0, a1 - a0);
+		emit(ctx, DIFF_INSERT, a1, b0, b1 - b0);
+	}
+
+	emit(ctx, DIFF_EQUAL, a1, b1, suffix);
+}
+
+/* merges every run of deletions and insertions between two equal runs into one deletion and one insertion */
+static void compact(DIFF_SCRIPT *script)
+{
+	unsigned int r, w, a_start, b_start, deleted, inserted;
+
+	w = 0;
+	for(r = 0; r < script->count; )
+	{
+		if(script->edits[r].op == DIFF_EQUAL) {
+			script->edits[w++] = script->edits[r++];
+			continue;
+		}
+
+		a_start = script->edits[r].a_start;
+		b_start = script->edits[r].b_start;
+		deleted = inserted = 0;
+		for(; r < script->count && script->edits[r].op != DIFF_EQUAL; ++r)
+		{
+			if(script->edits[r].op == DIFF_DELETE)
+				deleted += script->edits[r].length;
+			else
+				inserted += script->edits[r].length;
+		}
+
+		if(deleted > 0) {
+			script->edits[w].op = DIFF_DELETE;
+			script->edits[w].a_start = a_start;
+			script->edits[w].b_start = b_start;
+			script->edits[w].length = deleted;
+			++w;
+		}
+		if(inserted > 0) {
+			script->edits[w].op = DIFF_INSERT;
+			script->edits[w].a_start = a_start + deleted;
+			script->edits[w].b_start = b_start;
+			script->edits[w].length = inserted;
+			++w;
+		}
+	}
+
+	script->count = w;
+}
+
+/* computes the edit script of two sequences set up in the context */
+static DIFF_SCRIPT* diff(DIFF_CONTEXT *ctx, unsigned int n, unsigned int m)
+{
+	unsigned int size;
+
+	if((unsigned long long)n + m >= INT_MAX / 2) return NULL;
+
+	ctx->script = new_script();
+	if(ctx->script == NULL) return NULL;
+
+	/* one pair of diagonal arrays, sized for the whole input, serves every level of the recursion */
+	size = (n + m + 1) / 2 * 2 + 2;
+	ctx->v1 = (int*)malloc(2 * size * sizeof(int));
+	ctx->v2 = ctx->v1 + size;
+	ctx->failed = (ctx->v1 == NULL);
+
+	if(!ctx->failed) compare(ctx, 0, n, 0, m);
+
+	free(ctx->v1);
+	if(ctx->failed) {
+		diff_dump(ctx->script);
+		return NULL;
+	}
+
+	compact(ctx->script);
+	return ctx->script;
+}
+
+/* hashes a string view (64-bit FNV-1a) */
+static unsigned long long hash_view(STRING_VIEW view)
+{
+	unsigned long long h;
+	unsigned int i;
+
+	h = 0xcbf29ce484222325ULL;
+	for(i = 0; i < view.length; ++i)
+	{
+		h ^= (unsigned char)view.data[i];
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+/* gives every distinct view a number, so that views compare equal exactly when their numbers do */
+static BOOL intern(const STRING_VIEW *views, unsigned int count, unsigned int *ids)
+{
+	unsigned long long *hashes, h;
+	unsigned int *slots, i, size, slot, other;
+
+	size = 16;
+	while(size < 2 * count) size *= 2;
+
+	hashes = (unsigned long long*)malloc(count * sizeof(unsigned long long));
+	slots = (unsigned int*)malloc(size * sizeof(unsigned int));
+	if(hashes == NULL || slots == NULL) {
+		free(hashes);
+		free(slots);
+		return FALSE;
+	}
+
+	for(i = 0; i < size; ++i) slots[i] = NO_SLOT;
+	for(i = 0; i < count; ++i)
+	{
+		h = hashes[i] = hash_view(views[i]);
+		for(slot = (unsigned int)h & (size - 1); ; slot = (slot + 1) & (size - 1))
+		{
+			other = slots[slot];
+			if(other == NO_SLOT) {
+				slots[slot] = i;
+				ids[i] = i;
+				break;
+			}
+			if(hashes[other] == h && views[other].length == views[i].length && memcmp(views[other].data, views[i].data, views[i].length) == 0) {
+				ids[i] = other;
+				break;
+			}
+		}
+	}
+
+	free(hashes);
+	free(slots);
+	return TRUE;
+}
+
+/* splits a string into views of its lines */
+static STRING_VIEW* split_lines(const STRING *sobj, unsigned int *count)
+{
+	STRING_VIEW *views;
+	const char *p, *end, *nl;
+	unsigned int n;
+
+	n = 0;
+	end = sobj->data + sobj->length;
+	for(p = sobj->data; p < end && (nl = (const char*)memchr(p, '\n', end - p)) != NULL; p = nl + 1) ++n;
+	if(p < end) ++n;
+
+	views = (STRING_VIEW*)malloc((n > 0 ? n : 1) * sizeof(STRING_VIEW));
+	if(views == NULL) return NULL;
+
+	n = 0;
+	for(p = sobj->data; p < end; p = nl)
+	{
+		nl = (const char*)memchr(p, '\n', end - p);
+		nl = (nl == NULL ? end : nl + 1);
+		views[n].data = p;
+		views[n].length = nl - p;
+		++n;
+	}
+
+	*count = n;
+	return views;
+}
+
+/* diffs the first n views against the m views that follow them */
+static DIFF_SCRIPT* diff_views(STRING_VIEW *views, unsigned int n, unsigned int m)
+{
+	DIFF_CONTEXT ctx;
+	DIFF_SCRIPT *script;
+	unsigned int *ids;
+
+	ids = (unsigned int*)malloc((n + m > 0 ? n + m : 1) * sizeof(unsigned int));
+	if(ids == NULL) return NULL;
+
+	if(!intern(views, n + m, ids)) {
+		free(ids);
+		return NULL;
+	}
+
+	ctx.a8 = ctx.b8 = NULL;
+	ctx.a32 = ids;
+	ctx.b32 = ids + n;
+	script = diff(&ctx, n, m);
+
+	free(ids);
+	return script;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for an edit script */
+void diff_dump(DIFF_SCRIPT *script)
+{
+	if(script == NULL) return;
+
+	free(script->edits);
+	free(script);
+}
+
+/* computes the character-wise edit script of two strings */
+DIFF_SCRIPT* str_diff(const STRING *a, const STRING *b)
+{
+	DIFF_CONTEXT ctx;
+
+	if(a == NULL || b == NULL) return NULL;
+
+	ctx.a8 = (const unsigned char*)a->data;
+	ctx.b8 = (const unsigned char*)b->data;
+	ctx.a32 = ctx.b32 = NULL;
+	return diff(&ctx, a->length, b->length);
+}
+
+/* computes the line-wise edit script of two texts */
+DIFF_SCRIPT* str_diff_lines(const STRING *a, const STRING *b)
+{
+	DIFF_SCRIPT *script;
+	STRING_VIEW *va, *vb, *views;
+	unsigned int n, m;
+
+	if(a == NULL || b == NULL) return NULL;
+
+	va = split_lines(a, &n);
+	vb = split_lines(b, &m);
+	views = (va == NULL || vb == NULL ? NULL : (STRING_VIEW*)realloc(va, (n + m > 0 ? n + m : 1) * sizeof(STRING_VIEW)));
+	if(views == NULL) {
+		free(va);
+		free(vb);
+		return NULL;
+	}
+
+	memcpy(views + n, vb, m * sizeof(STRING_VIEW));
+	free(vb);
+
+	script = diff_views(views, n, m);
+	free(views);
+	return script;
+}
+
+/* computes the item-wise edit script of two lists of strings */
+DIFF_SCRIPT* str_diff_list(const LIST *a, const LIST *b)
+{
+	DIFF_SCRIPT *script;
+	STRING_VIEW *views;
+	const STRING *item;
+	unsigned int i, n, m;
+
+	if(a == NULL || b == NULL || a->type != TYPE_OBJECT || b->type != TYPE_OBJECT) return NULL;
+
+	n = a->length;
+	m = b->length;
+	views = (STRING_VIEW*)malloc((n + m > 0 ? n + m : 1) * sizeof(STRING_VIEW));
+	if(views == NULL) return NULL;
+
+	for(i = 0; i < n + m; ++i)
+	{
+		item = (const STRING*)(i < n ? a->data[i] : b->data[i - n]);
+		views[i].data = (item == NULL ? "" : item->data);
+		views[i].length = (item == NULL ? 0 : item->length);
+	}
+
+	script = diff_views(views, n, m);
+	free(views);
+	return script;
+}
+
+/* returns the number of units deleted and inserted by an edit script */
+int diff_distance(const DIFF_SCRIPT *script)
+{
+	unsigned int i, distance;
+
+	if(script == NULL) return -1;
+
+	distance = 0;
+	for(i = 0; i < script->count; ++i)
+		if(script->edits[i].op != DIFF_EQUAL) distance += script->edits[i].length;
+
+	return (int)distance;
+}
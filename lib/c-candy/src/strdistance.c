@@ -0,0 +1,255 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strdistance.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <constants.h>
+#include <str.h>
+#include <list.h>
+#include <strdistance.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define WORD_BITS				64
+#define HIGH_BIT				(1ULL << (WORD_BITS - 1))
+
+/* pattern pre-processed for Myers' bit-vector algorithm, split into 64-row blocks */
+typedef struct {
+	unsigned long long *peq;
+	unsigned long long *pv;
+	unsigned long long *mv;
+	int *score;
+	unsigned int m;
+	unsigned int blocks;
+	unsigned long long small_peq[256];
+	unsigned long long small_pv, small_mv;
+	int small_score;
+} PATTERN;
+
+/* <------------------ private function declarations -----------------> */
+static BOOL pattern_init(PATTERN *p, const char *s, unsigned int m);
+static void pattern_free(PATTERN *p);
+static int advance_block(unsigned long long *pv, unsigned long long *mv, unsigned long long eq, int hin, unsigned long long out_bit);
+static int pattern_distance(PATTERN *p, const char *text, unsigned int n, int k);
+static int trimmed_distance(const STRING *sobj1, const STRING *sobj2, int k);
+
+/* <------------------ private function definitions ------------------> */
+
+/* builds the per-character match masks of a pattern */
+static BOOL pattern_init(PATTERN *p, const char *s, unsigned int m)
+{
+	unsigned int i, blocks;
+
+	blocks = (m + WORD_BITS - 1) / WORD_BITS;
+	if(blocks == 0) blocks = 1;
+
+	p->m = m;
+	p->blocks = blocks;
+
+	if(blocks == 1) {
+		p->peq = p->small_peq;
+		p->pv = &p->small_pv;
+		p->mv = &p->small_mv;
+		p->score = &p->small_score;
+	} else {
+		p->peq = (unsigned long long*)malloc((256 + 2) * blocks * sizeof(unsigned long long));
+		p->score = (int*)malloc(blocks * sizeof(int));
+		if(p->peq == NULL || p->score == NULL) {
+			free(p->peq);
+			free(p->score);
+			return FALSE;
+		}
+		p->pv = p->peq + 256 * blocks;
+		p->mv = p->pv + blocks;
+	}
+
+	memset(p->peq, 0, 256 * blocks * sizeof(unsigned long long));
+	for(i = 0; i < m; ++i)
+		p->peq[(unsigned char)s[i] * blocks + i / WORD_BITS] |= 1ULL << (i % WORD_BITS);
+
+	return TRUE;
+}
+
+/* frees the block arrays of a pattern */
+static void pattern_free(PATTERN *p)
+{
+	if(p->blocks > 1) {
+		free(p->peq);
+		free(p->score);
+	}
+}
+
+/*
+ * advances one 64-row block by one text character; hin is the horizontal delta entering the top of the
+ * block, and the horizontal delta at out_bit (the bottom row of the block) is returned
+ */
+static int advance_block(unsigned long long *pv, unsigned long long *mv, unsigned long long eq, int hin, unsigned long long out_bit)
+{
+	unsigned long long xv, xh, ph, mh, hin_neg;
+	int hout;
+
+	hin_neg = (hin < 0 ? 1ULL : 0ULL);
+
+	xv = eq | *mv;
+	eq |= hin_neg;
+	xh = (((eq & *pv) + *pv) ^ *pv) | eq;
+	ph = *mv | ~(xh | *pv);
+	mh = *pv & xh;
+
+	hout = 0;
+	if(ph & out_bit) hout = 1;
+	else if(mh & out_bit) hout = -1;
+
+	ph = (ph << 1) | (hin > 0 ? 1ULL : 0ULL);
+	mh = (mh << 1) | hin_neg;
+
+	*pv = mh | ~(xv | ph);
+	*mv = ph & xv;
+	return hout;
+}
+
+/* computes the distance between a pattern and a text, giving up once it must exceed k (if k >= 0) */
+static int pattern_distance(PATTERN *p, const char *text, unsigned int n, int k)
+{
+	unsigned long long last_bit;
+	const unsigned long long *eq;
+	unsigned int j, b, blocks, rows;
+	int hin, bound, lower;
+
+	if(p->m == 0) return (k >= 0 && (int)n > k) ? -1 : (int)n;
+	if(k >= 0 && (p->m > n ? p->m - n : n - p->m) > (unsigned int)k) return -1;
+
+	blocks = p->blocks;
+	last_bit = 1ULL << ((p->m - 1) % WORD_BITS);
+	for(b = 0; b < blocks; ++b)
+	{
+		p->pv[b] = ~0ULL;
+		p->mv[b] = 0ULL;
+		p->score[b] = (b == blocks - 1 ? p->m : (b + 1) * WORD_BITS);
+	}
+
+	for(j = 0; j < n; ++j)
+	{
+		eq = p->peq + (unsigned char)text[j] * blocks;
+
+		/* the top row of the matrix is 0, 1, 2, ... so every column enters with a +1 */
+		hin = 1;
+		for(b = 0; b < blocks; ++b)
+		{
+			hin = advance_block(&p->pv[b], &p->mv[b], eq[b], hin, (b == blocks - 1 ? last_bit : HIGH_BIT));
+			p->score[b] += hin;
+		}
+
+		if(k < 0) continue;
+
+		/* neighbouring cells differ by at most 1, so the final distance cannot drop below these */
+		if(p->score[blocks - 1] - (int)(n - j - 1) > k) return -1;
+
+		lower = j + 1;
+		for(b = 0; b < blocks; ++b)
+		{
+			rows = (b == blocks - 1 ? p->m - b * WORD_BITS : WORD_BITS);
+			bound = p->score[b] - (int)(rows - 1);
+			if(bound < lower) lower = bound;
+		}
+		if(lower > k) return -1;
+	}
+
+	if(k >= 0 && p->score[blocks - 1] > k) return -1;
+	return p->score[blocks - 1];
+}
+
+/* computes the distance after removing the common prefix and suffix, using the shorter string as pattern */
+static int trimmed_distance(const STRING *sobj1, const STRING *sobj2, int k)
+{
+	const char *a, *b, *t;
+	unsigned int na, nb, n;
+	PATTERN p;
+	int distance;
+
+	if(sobj1 == NULL || sobj2 == NULL) return -1;
+
+	a = sobj1->data;
+	b = sobj2->data;
+	na = sobj1->length;
+	nb = sobj2->length;
+
+	while(na > 0 && nb > 0 && *a == *b) { ++a; ++b; --na; --nb; }
+	while(na > 0 && nb > 0 && a[na - 1] == b[nb - 1]) { --na; --nb; }
+
+	if(na > nb) {
+		t = a; a = b; b = t;
+		n = na; na = nb; nb = n;
+	}
+
+	if(!pattern_init(&p, a, na)) return -1;
+	distance = pattern_distance(&p, b, nb, k);
+	pattern_free(&p);
+	return distance;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* computes the Levenshtein distance between two strings */
+int str_edit_distance(const STRING *sobj1, const STRING *sobj2)
+{
+	return trimmed_distance(sobj1, sobj2, -1);
+}
+
+/* computes the Levenshtein distance if it does not exceed a threshold */
+int str_edit_distance_bounded(const STRING *sobj1, const STRING *sobj2, int max_distance)
+{
+	if(max_distance < 0) return -1;
+	return trimmed_distance(sobj1, sobj2, max_distance);
+}
+
+/* finds the string in a list which is closest to a query */
+int str_best_match(const STRING *query, const LIST *candidates, int max_distance, int *distance)
+{
+	const STRING *candidate;
+	PATTERN p;
+	int i, d, best, best_distance;
+
+	if(distance != NULL) *distance = -1;
+	if(query == NULL || candidates == NULL || candidates->type != TYPE_OBJECT) return -1;
+
+	/* the query is pre-processed once and reused against every candidate */
+	if(!pattern_init(&p, query->data, query->length)) return -1;
+
+	best = -1;
+	best_distance = max_distance;
+	for(i = 0; i < candidates->length; ++i)
+	{
+		candidate = (const STRING*)candidates->data[i];
+		if(candidate == NULL) continue;
+
+		/* only a strictly better candidate is of interest from here on */
+		d = pattern_distance(&p, candidate->data, candidate->length, best >= 0 ? best_distance - 1 : best_distance);
+		if(d < 0) continue;
+
+		best = i;
+		best_distance = d;
+		if(d == 0) break;
+	}
+
+	pattern_free(&p);
+	if(best >= 0 && distance != NULL) *distance = best_distance;
+	return best;
+}
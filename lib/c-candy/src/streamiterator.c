@@ -0,0 +1,409 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/streamiterator.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <striterator.h>
+#include <streamiterator.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define NO_RESULT					-2
+
+/* <------------------ private function declarations -----------------> */
+static long read_chunk(int fd, char *dst, size_t n);
+static size_t room(const STREAM_ITERATOR *si);
+static void make_room(STREAM_ITERATOR *si);
+static void absorb(STREAM_ITERATOR *si, long n);
+static void request(STREAM_ITERATOR *si);
+static void* read_ahead_worker(void *arg);
+static BOOL refill(STREAM_ITERATOR *si);
+static BOOL ensure(STREAM_ITERATOR *si, long long position);
+static long long scan(STREAM_ITERATOR *si, const CHARSET *cs, BOOL until);
+
+/* <------------------ private function definitions ------------------> */
+
+/* reads up to n bytes; returns bytes read, 0 on end of input, -1 on error */
+static long read_chunk(int fd, char *dst, size_t n)
+{
+	long r;
+
+	do {
+		r = (long)read(fd, dst, n);
+	} while(r < 0 && errno == EINTR);
+
+	return r;
+}
+
+/* returns the number of bytes the next read may fill */
+static size_t room(const STREAM_ITERATOR *si)
+{
+	return (si->capacity - si->end < si->read_size ? si->capacity - si->end : si->read_size);
+}
+
+/* slides the window forward so a full read fits after the data, keeping the lookbehind and (if it fits) the mark */
+static void make_room(STREAM_ITERATOR *si)
+{
+	long long keep;
+	size_t shift;
+
+	if(si->capacity - si->end >= si->read_size) return;
+
+	keep = si->marker - STMI_LOOKBEHIND;
+	if(keep < si->base) keep = si->base;
+
+	if(si->mark >= 0) {
+		if(si->mark >= si->base && (size_t)(si->base + (long long)si->end - si->mark) + si->read_size <= si->capacity) {
+			if(si->mark < keep) keep = si->mark;
+		} else {
+			si->mark = -1;
+		}
+	}
+
+	shift = (size_t)(keep - si->base);
+	if(shift == 0) return;
+
+	memmove(si->buffer, si->buffer + shift, si->end - shift);
+	si->end -= shift;
+	si->base = keep;
+}
+
+/* records the result of a read into the window */
+static void absorb(STREAM_ITERATOR *si, long n)
+{
+	if(n < 0)
+		si->error = TRUE;
+	else if(n == 0)
+		si->eof = TRUE;
+	else
+		si->end += (size_t)n;
+}
+
+/* asks the read-ahead thread for the next chunk (the lock must be held) */
+static void request(STREAM_ITERATOR *si)
+{
+	make_room(si);
+	si->requested = TRUE;
+	pthread_cond_broadcast(&si->cond);
+}
+
+/* background thread: reads a chunk after the window's data whenever one is requested */
+static void* read_ahead_worker(void *arg)
+{
+	STREAM_ITERATOR *si;
+	char *dst;
+	size_t n;
+	long r;
+
+	si = (STREAM_ITERATOR*)arg;
+
+	pthread_mutex_lock(&si->lock);
+	while(TRUE)
+	{
+		while(!si->requested && !si->stop) pthread_cond_wait(&si->cond, &si->lock);
+		if(si->stop) break;
+
+		/* the parser neither moves nor reads past the data while a request is in progress */
+		dst = si->buffer + si->end;
+		n = room(si);
+		pthread_mutex_unlock(&si->lock);
+
+		r = read_chunk(si->fd, dst, n);
+
+		pthread_mutex_lock(&si->lock);
+		si->ready = r;
+		si->requested = FALSE;
+		pthread_cond_broadcast(&si->cond);
+	}
+	pthread_mutex_unlock(&si->lock);
+	return NULL;
+}
+
+/* brings more characters into the window; returns FALSE at the end of the input or on error */
+static BOOL refill(STREAM_ITERATOR *si)
+{
+	long n;
+
+	if(si->eof || si->error) return FALSE;
+
+	if(!si->read_ahead) {
+		make_room(si);
+		n = read_chunk(si->fd, si->buffer + si->end, room(si));
+		absorb(si, n);
+		return (n > 0 ? TRUE : FALSE);
+	}
+
+	pthread_mutex_lock(&si->lock);
+	if(!si->requested && si->ready == NO_RESULT) request(si);
+	while(si->requested) pthread_cond_wait(&si->cond, &si->lock);
+
+	n = si->ready;
+	si->ready = NO_RESULT;
+	absorb(si, n);
+
+	/* start reading the next chunk while the caller parses this one */
+	if(!si->eof && !si->error) request(si);
+	pthread_mutex_unlock(&si->lock);
+
+	return (n > 0 ? TRUE : FALSE);
+}
+
+/* makes sure the character at a position is in the window; returns FALSE if the input ends before it */
+static BOOL ensure(STREAM_ITERATOR *si, long long position)
+{
+	while(position >= si->base + (long long)si->end)
+		if(!refill(si)) return FALSE;
+
+	return TRUE;
+}
+
+/* moves the marker right until a character is (until) or is not in a set, scanning the window in bulk */
+static long long scan(STREAM_ITERATOR *si, const CHARSET *cs, BOOL until)
+{
+	STRING_ITERATOR it;
+	STRI_SPAN span;
+	size_t offset;
+
+	do {
+		offset = (size_t)(si->marker - si->base);
+		if(offset < si->end) {
+			stri_init_chars(&it, si->buffer + offset, (unsigned int)(si->end - offset));
+			span = (until ? stri_scan_until(&it, cs, STRI_FORWARD) : stri_scan_while(&it, cs, STRI_FORWARD));
+			si->marker += span.end;
+			if(si->marker < si->base + (long long)si->end) break;
+		}
+	} while(refill(si));
+
+	return si->marker;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for the iterator */
+void stmi_dump(STREAM_ITERATOR *si)
+{
+	if(si == NULL) return;
+
+	if(si->read_ahead) {
+		pthread_mutex_lock(&si->lock);
+		si->stop = TRUE;
+		pthread_cond_broadcast(&si->cond);
+		pthread_mutex_unlock(&si->lock);
+		pthread_join(si->thread, NULL);
+	}
+
+	pthread_mutex_destroy(&si->lock);
+	pthread_cond_destroy(&si->cond);
+	free(si->buffer);
+	free(si);
+}
+
+/* creates an iterator over the characters read from a file descriptor */
+STREAM_ITERATOR* stream_iterator(int fd, size_t window_size, BOOL read_ahead)
+{
+	STREAM_ITERATOR *si;
+
+	if(fd < 0) return NULL;
+	if(window_size == 0) window_size = STMI_DEFAULT_WINDOW_SIZE;
+	if(window_size < STMI_MIN_WINDOW_SIZE) window_size = STMI_MIN_WINDOW_SIZE;
+	if(window_size > INT_MAX) return NULL;
+
+	si = (STREAM_ITERATOR*)malloc(sizeof(STREAM_ITERATOR));
+	if(si == NULL) return NULL;
+
+	si->buffer = (char*)malloc(window_size);
+	if(si->buffer == NULL) {
+		free(si);
+		return NULL;
+	}
+
+	si->fd = fd;
+	si->capacity = window_size;
+	si->read_size = window_size / 4;
+	si->end = 0;
+	si->base = 0;
+	si->marker = 0;
+	si->mark = -1;
+	si->eof = FALSE;
+	si->error = FALSE;
+	si->requested = FALSE;
+	si->stop = FALSE;
+	si->ready = NO_RESULT;
+	pthread_mutex_init(&si->lock, NULL);
+	pthread_cond_init(&si->cond, NULL);
+
+	/* a hint only: pipes and sockets reject it */
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	si->read_ahead = FALSE;
+	if(read_ahead && pthread_create(&si->thread, NULL, read_ahead_worker, si) == 0) {
+		si->read_ahead = TRUE;
+
+		pthread_mutex_lock(&si->lock);
+		request(si);
+		pthread_mutex_unlock(&si->lock);
+	}
+	return si;
+}
+
+/* returns the character at the current marker position */
+char stmi_this(STREAM_ITERATOR *si)
+{
+	if(si == NULL) return -1;
+	if(si->marker - si->base < (long long)si->end) return si->buffer[si->marker - si->base];
+	if(!ensure(si, si->marker)) return -1;
+	return si->buffer[si->marker - si->base];
+}
+
+/* returns the character to the right of the current marker position */
+char stmi_next(STREAM_ITERATOR *si)
+{
+	if(si == NULL) return -1;
+	if(!ensure(si, si->marker + 1)) return -1;
+	return si->buffer[si->marker + 1 - si->base];
+}
+
+/* returns the character to the left of the current marker position */
+char stmi_prev(const STREAM_ITERATOR *si)
+{
+	if(si == NULL) return -1;
+	if(si->marker - 1 < si->base) return -1;
+	return si->buffer[si->marker - 1 - si->base];
+}
+
+/* returns the current marker position */
+long long stmi_pos(STREAM_ITERATOR *si)
+{
+	if(si == NULL) return -1;
+	return (ensure(si, si->marker) ? si->marker : STRI_EOS);
+}
+
+/* moves the marker a certain number of characters, positive for right, negative for left */
+BOOL stmi_move(STREAM_ITERATOR *si, long long num_chars)
+{
+	long long target;
+
+	if(si == NULL) return FALSE;
+
+	target = si->marker + num_chars;
+	if(target < si->base) target = si->base;
+
+	/* step through the window so that what lies behind can be dropped */
+	while(target > si->base + (long long)si->end)
+	{
+		si->marker = si->base + (long long)si->end;
+		if(!refill(si)) break;
+	}
+
+	if(target > si->base + (long long)si->end) target = si->base + (long long)si->end;
+	si->marker = target;
+	return TRUE;
+}
+
+/* moves the marker 1 character to the right */
+BOOL stmi_move_next(STREAM_ITERATOR *si)
+{
+	return stmi_move(si, 1);
+}
+
+/* moves the marker 1 character to the left */
+BOOL stmi_move_prev(STREAM_ITERATOR *si)
+{
+	return stmi_move(si, -1);
+}
+
+/* moves the marker right until one of the given characters is found */
+long long stmi_move_until(STREAM_ITERATOR *si, const char *chars)
+{
+	CHARSET cs;
+
+	if(si == NULL || chars == NULL) return -1;
+	charset_init(&cs, chars);
+	return scan(si, &cs, TRUE);
+}
+
+/* moves the marker right until a character other than the given characters is found */
+long long stmi_move_while(STREAM_ITERATOR *si, const char *chars)
+{
+	CHARSET cs;
+
+	if(si == NULL || chars == NULL) return -1;
+	charset_init(&cs, chars);
+	return scan(si, &cs, FALSE);
+}
+
+/* moves the marker right until a character belonging to the set is found */
+long long stmi_move_until_charset(STREAM_ITERATOR *si, const CHARSET *cs)
+{
+	if(si == NULL || cs == NULL) return -1;
+	return scan(si, cs, TRUE);
+}
+
+/* moves the marker right until a character not belonging to the set is found */
+long long stmi_move_while_charset(STREAM_ITERATOR *si, const CHARSET *cs)
+{
+	if(si == NULL || cs == NULL) return -1;
+	return scan(si, cs, FALSE);
+}
+
+/* return TRUE if the marker is at the end of the input */
+BOOL stmi_is_at_eos(STREAM_ITERATOR *si)
+{
+	if(si == NULL) return FALSE;
+	return (ensure(si, si->marker) ? FALSE : TRUE);
+}
+
+/* sets the mark at the current marker position */
+BOOL stmi_mark(STREAM_ITERATOR *si)
+{
+	if(si == NULL) return FALSE;
+
+	si->mark = si->marker;
+	return TRUE;
+}
+
+/* returns the characters between the mark and the marker */
+STRING_VIEW stmi_extract(const STREAM_ITERATOR *si)
+{
+	STRING_VIEW view;
+
+	view.data = NULL;
+	view.length = 0;
+	if(si == NULL || si->mark < 0 || si->mark < si->base || si->mark > si->marker) return view;
+
+	view.data = si->buffer + (si->mark - si->base);
+	view.length = (unsigned int)(si->marker - si->mark);
+	return view;
+}
+
+/* returns TRUE if reading from the file descriptor failed */
+BOOL stmi_has_error(const STREAM_ITERATOR *si)
+{
+	if(si == NULL) return FALSE;
+	return si->error;
+}
@@ -0,0 +1,437 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strfreq.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <strfreq.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define WC_INITIAL_CAPACITY		1024
+#define FNV_OFFSET				0xcbf29ce484222325ULL
+#define FNV_PRIME				0x100000001b3ULL
+
+/* a position in an array of strings */
+typedef struct {
+	unsigned int text;
+	unsigned int offset;
+} CUT;
+
+/* the part of the input counted by one thread */
+typedef struct {
+	const STRING **texts;
+	unsigned int count;
+	CUT from;
+	CUT to;
+	const CHARSET *word_chars;
+	WORD_COUNTS *wc;
+	BOOL success;
+} SHARD;
+
+/* <------------------ private function declarations -----------------> */
+static char* store_word(WORD_COUNTS *wc, const char *word, unsigned int length);
+static BOOL rehash(WORD_COUNTS *wc);
+static BOOL add_hashed(WORD_COUNTS *wc, const char *word, unsigned int length, unsigned long long hash, unsigned long long count);
+static BOOL count_range(WORD_COUNTS *wc, const char *s, unsigned int start, unsigned int end, const CHARSET *cs);
+static void* count_shard(void *arg);
+
+/* <------------------ private function definitions ------------------> */
+
+/* copies a word into the current block, starting a new block when it is full */
+static char* store_word(WORD_COUNTS *wc, const char *word, unsigned int length)
+{
+	char **blocks, *block;
+	unsigned int size;
+
+	if(wc->block_count == 0 || wc->block_used + length > WC_BLOCK_SIZE) {
+		if(wc->block_count == wc->block_capacity) {
+			blocks = (char**)realloc(wc->blocks, (wc->block_capacity * 2 + 8) * sizeof(char*));
+			if(blocks == NULL) return NULL;
+			wc->blocks = blocks;
+			wc->block_capacity = wc->block_capacity * 2 + 8;
+		}
+
+		size = (length > WC_BLOCK_SIZE ? length : WC_BLOCK_SIZE);
+		block = (char*)malloc(size);
+		if(block == NULL) return NULL;
+
+		wc->blocks[wc->block_count++] = block;
+		wc->block_used = 0;
+	}
+
+	block = wc->blocks[wc->block_count - 1] + wc->block_used;
+	memcpy(block, word, length);
+	wc->block_used += length;
+	return block;
+}
+
+/* doubles the number of slots of a table */
+static BOOL rehash(WORD_COUNTS *wc)
+{
+	WORD_COUNT *entries;
+	unsigned int i, slot, mask;
+
+	entries = (WORD_COUNT*)calloc(wc->capacity * 2, sizeof(WORD_COUNT));
+	if(entries == NULL) return FALSE;
+
+	mask = wc->capacity * 2 - 1;
+	for(i = 0; i < wc->capacity; ++i)
+	{
+		if(wc->entries[i].word == NULL) continue;
+
+		for(slot = (unsigned int)wc->entries[i].hash & mask; entries[slot].word != NULL; slot = (slot + 1) & mask);
+		entries[slot] = wc->entries[i];
+	}
+
+	free(wc->entries);
+	wc->entries = entries;
+	wc->capacity *= 2;
+	return TRUE;
+}
+
+/* adds to the count of a word whose hash is known */
+static BOOL add_hashed(WORD_COUNTS *wc, const char *word, unsigned int length, unsigned long long hash, unsigned long long count)
+{
+	WORD_COUNT *entry;
+	unsigned int slot, mask;
+
+	/* keep the table at most half full so that probe runs stay short */
+	if((wc->count + 1) * 2 > wc->capacity && !rehash(wc)) return FALSE;
+
+	mask = wc->capacity - 1;
+	for(slot = (unsigned int)hash & mask; ; slot = (slot + 1) & mask)
+	{
+		entry = &wc->entries[slot];
+		if(entry->word == NULL) break;
+
+		if(entry->hash == hash && entry->length == length && memcmp(entry->word, word, length) == 0) {
+			entry->count += count;
+			wc->total += count;
+			return TRUE;
+		}
+	}
+
+	/* empty words are stored as a pointer to the start of a block, since NULL marks a free slot */
+	entry->word = store_word(wc, word, length);
+	if(entry->word == NULL) return FALSE;
+
+	entry->length = length;
+	entry->hash = hash;
+	entry->count = count;
+	++wc->count;
+	wc->total += count;
+	return TRUE;
+}
+
+/* counts the words of s[start..end) */
+static BOOL count_range(WORD_COUNTS *wc, const char *s, unsigned int start, unsigned int end, const CHARSET *cs)
+{
+	unsigned long long h;
+	unsigned int i, word_start;
+
+	/* the word is hashed in the same pass that finds its end */
+	for(i = start; i < end; )
+	{
+		while(i < end && !CHARSET_HAS(cs, s[i])) ++i;
+		if(i >= end) break;
+
+		word_start = i;
+		h = FNV_OFFSET;
+		while(i < end && CHARSET_HAS(cs, s[i]))
+		{
+			h ^= (unsigned char)s[i++];
+			h *= FNV_PRIME;
+		}
+
+		if(!add_hashed(wc, s + word_start, i - word_start, h, 1)) return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* thread body: counts one shard into its own table */
+static void* count_shard(void *arg)
+{
+	SHARD *shard;
+	const STRING *text;
+	unsigned int t, start, end;
+
+	shard = (SHARD*)arg;
+	shard->success = TRUE;
+	for(t = shard->from.text; t <= shard->to.text && t < shard->count; ++t)
+	{
+		text = shard->texts[t];
+		if(text == NULL) continue;
+
+		start = (t == shard->from.text ? shard->from.offset : 0);
+		end = (t == shard->to.text ? shard->to.offset : text->length);
+		if(!count_range(shard->wc, text->data, start, end, shard->word_chars)) {
+			shard->success = FALSE;
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* counts the occurrences of every byte value in a string */
+BOOL str_byte_histogram(const STRING *sobj, unsigned long long *counts)
+{
+	unsigned int c0[256], c1[256], c2[256], c3[256];
+	const unsigned char *p;
+	unsigned long long word;
+	unsigned int i, n;
+
+	if(sobj == NULL || counts == NULL) return FALSE;
+
+	memset(c0, 0, sizeof(c0));
+	memset(c1, 0, sizeof(c1));
+	memset(c2, 0, sizeof(c2));
+	memset(c3, 0, sizeof(c3));
+
+	/*
+	 * Incrementing one table for consecutive equal bytes makes every load wait for the previous store to the
+	 * same counter; spreading neighbouring bytes over four tables lets those increments overlap. Counters
+	 * cannot overflow since a string is shorter than 2^32 bytes.
+	 */
+	p = (const unsigned char*)sobj->data;
+	n = sobj->length;
+	for(i = 0; i + 8 <= n; i += 8)
+	{
+		memcpy(&word, p + i, 8);
+		++c0[word & 0xff];
+		++c1[(word >> 8) & 0xff];
+		++c2[(word >> 16) & 0xff];
+		++c3[(word >> 24) & 0xff];
+		++c0[(word >> 32) & 0xff];
+		++c1[(word >> 40) & 0xff];
+		++c2[(word >> 48) & 0xff];
+		++c3[word >> 56];
+	}
+	for(; i < n; ++i) ++c0[p[i]];
+
+	for(i = 0; i < 256; ++i) counts[i] += (unsigned long long)c0[i] + c1[i] + c2[i] + c3[i];
+	return TRUE;
+}
+
+/* frees memory allocated for a word count table */
+void wc_dump(WORD_COUNTS *wc)
+{
+	unsigned int i;
+
+	if(wc == NULL) return;
+
+	for(i = 0; i < wc->block_count; ++i) free(wc->blocks[i]);
+	free(wc->blocks);
+	free(wc->entries);
+	free(wc);
+}
+
+/* creates an empty word count table */
+WORD_COUNTS* word_counts()
+{
+	WORD_COUNTS *wc;
+
+	wc = (WORD_COUNTS*)malloc(sizeof(WORD_COUNTS));
+	if(wc == NULL) return NULL;
+
+	wc->entries = (WORD_COUNT*)calloc(WC_INITIAL_CAPACITY, sizeof(WORD_COUNT));
+	if(wc->entries == NULL) {
+		free(wc);
+		return NULL;
+	}
+
+	wc->capacity = WC_INITIAL_CAPACITY;
+	wc->count = 0;
+	wc->total = 0;
+	wc->blocks = NULL;
+	wc->block_count = wc->block_capacity = wc->block_used = 0;
+	return wc;
+}
+
+/* adds to the count of a word */
+BOOL wc_add(WORD_COUNTS *wc, const char *word, unsigned int length, unsigned long long count)
+{
+	unsigned long long h;
+	unsigned int i;
+
+	if(wc == NULL || (word == NULL && length > 0)) return FALSE;
+
+	h = FNV_OFFSET;
+	for(i = 0; i < length; ++i)
+	{
+		h ^= (unsigned char)word[i];
+		h *= FNV_PRIME;
+	}
+
+	return add_hashed(wc, word, length, h, count);
+}
+
+/* counts the words of a string */
+BOOL wc_add_string(WORD_COUNTS *wc, const STRING *sobj, const CHARSET *word_chars)
+{
+	if(wc == NULL || sobj == NULL) return FALSE;
+	return count_range(wc, sobj->data, 0, sobj->length, (word_chars == NULL ? &CHARSET_ALPHANUMERIC : word_chars));
+}
+
+/* returns the count of a word */
+unsigned long long wc_get(const WORD_COUNTS *wc, const STRING *word)
+{
+	const WORD_COUNT *entry;
+	unsigned long long h;
+	unsigned int i, slot, mask;
+
+	if(wc == NULL || word == NULL) return 0;
+
+	h = FNV_OFFSET;
+	for(i = 0; i < word->length; ++i)
+	{
+		h ^= (unsigned char)word->data[i];
+		h *= FNV_PRIME;
+	}
+
+	mask = wc->capacity - 1;
+	for(slot = (unsigned int)h & mask; wc->entries[slot].word != NULL; slot = (slot + 1) & mask)
+	{
+		entry = &wc->entries[slot];
+		if(entry->hash == h && entry->length == word->length && memcmp(entry->word, word->data, word->length) == 0) return entry->count;
+	}
+
+	return 0;
+}
+
+/* adds the counts of one table to another */
+BOOL wc_merge(WORD_COUNTS *wc, const WORD_COUNTS *other)
+{
+	const WORD_COUNT *entry;
+	unsigned int i;
+
+	if(wc == NULL || other == NULL) return FALSE;
+
+	for(i = 0; i < other->capacity; ++i)
+	{
+		entry = &other->entries[i];
+		if(entry->word != NULL && !add_hashed(wc, entry->word, entry->length, entry->hash, entry->count)) return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* counts the words of several strings, splitting the work across threads */
+WORD_COUNTS* str_word_counts(const STRING **texts, unsigned int count, const CHARSET *word_chars, unsigned int threads)
+{
+	WORD_COUNTS *result;
+	SHARD *shards;
+	pthread_t *ids;
+	BOOL *started, success;
+	const STRING *text;
+	unsigned long long total, target, seen;
+	unsigned int i, t, offset;
+
+	if(texts == NULL && count > 0) return NULL;
+	if(word_chars == NULL) word_chars = &CHARSET_ALPHANUMERIC;
+	if(threads == 0) threads = 1;
+
+	total = 0;
+	for(t = 0; t < count; ++t)
+		if(texts[t] != NULL) total += texts[t]->length;
+
+	shards = (SHARD*)malloc(threads * sizeof(SHARD));
+	ids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+	started = (BOOL*)calloc(threads, sizeof(BOOL));
+	if(shards == NULL || ids == NULL || started == NULL) {
+		free(shards);
+		free(ids);
+		free(started);
+		return NULL;
+	}
+
+	/* cut the input into shards of about equal size, moving each cut forward out of any word it falls into */
+	t = 0;
+	seen = 0;
+	for(i = 0; i < threads; ++i)
+	{
+		shards[i].texts = texts;
+		shards[i].count = count;
+		shards[i].word_chars = word_chars;
+		shards[i].from.text = (i == 0 ? 0 : shards[i - 1].to.text);
+		shards[i].from.offset = (i == 0 ? 0 : shards[i - 1].to.offset);
+
+		target = total * (i + 1) / threads;
+		while(t < count && seen + (texts[t] == NULL ? 0 : texts[t]->length) <= target && i + 1 < threads)
+		{
+			seen += (texts[t] == NULL ? 0 : texts[t]->length);
+			++t;
+		}
+
+		if(i + 1 == threads || t >= count) {
+			shards[i].to.text = count;
+			shards[i].to.offset = 0;
+		} else {
+			text = texts[t];
+			offset = (unsigned int)(target - seen);
+			while(offset > 0 && offset < text->length && CHARSET_HAS(word_chars, text->data[offset - 1]) && CHARSET_HAS(word_chars, text->data[offset])) ++offset;
+
+			shards[i].to.text = t;
+			shards[i].to.offset = offset;
+			if(t == shards[i].from.text && offset < shards[i].from.offset) shards[i].to.offset = shards[i].from.offset;
+		}
+
+		shards[i].wc = word_counts();
+		shards[i].success = FALSE;
+	}
+
+	/* shard 0 runs in the calling thread; a shard whose thread cannot be started runs there too */
+	for(i = 1; i < threads; ++i)
+		if(shards[i].wc != NULL) started[i] = (pthread_create(&ids[i], NULL, count_shard, &shards[i]) == 0);
+
+	if(shards[0].wc != NULL) count_shard(&shards[0]);
+	for(i = 1; i < threads; ++i)
+	{
+		if(started[i])
+			pthread_join(ids[i], NULL);
+		else if(shards[i].wc != NULL)
+			count_shard(&shards[i]);
+	}
+
+	result = shards[0].wc;
+	success = TRUE;
+	for(i = 0; i < threads; ++i)
+	{
+		if(!shards[i].success || (i > 0 && success && !wc_merge(result, shards[i].wc))) success = FALSE;
+		if(i > 0) wc_dump(shards[i].wc);
+	}
+
+	if(!success) {
+		wc_dump(result);
+		result = NULL;
+	}
+
+	free(ids);
+	free(started);
+	free(shards);
+	return result;
+}
@@ -0,0 +1,298 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strglob.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <strglob.h>
+
+/* <------------------ private function declarations -----------------> */
+static unsigned int parse_set(const char *p, unsigned int n, unsigned int i, CHARSET *cs);
+static unsigned int match_atom(const char *p, unsigned int n, unsigned int i, char c);
+static BOOL match_segment(const STR_GLOB *glob, const GLOB_SEGMENT *seg, const char *s);
+static int find_segment(const STR_GLOB *glob, const GLOB_SEGMENT *seg, const char *s, unsigned int from, unsigned int to);
+
+/* <------------------ private function definitions ------------------> */
+
+/* parses the set starting with the '[' at p[i]; returns the index after its ']', or 0 if it is not closed */
+static unsigned int parse_set(const char *p, unsigned int n, unsigned int i, CHARSET *cs)
+{
+	unsigned char first, last;
+	BOOL negate;
+
+	charset_clear(cs);
+	++i;
+
+	negate = (i < n && (p[i] == '!' || p[i] == '^'));
+	if(negate) ++i;
+
+	/* a ']' right after the opening bracket is a member, not the end */
+	if(i < n && p[i] == ']') {
+		charset_add_range(cs, ']', ']');
+		++i;
+	}
+
+	while(i < n && p[i] != ']')
+	{
+		if(p[i] == '\\' && i + 1 < n) ++i;
+		first = (unsigned char)p[i++];
+
+		last = first;
+		if(i + 1 < n && p[i] == '-' && p[i + 1] != ']') {
+			++i;
+			if(p[i] == '\\' && i + 1 < n) ++i;
+			last = (unsigned char)p[i++];
+		}
+
+		if(first <= last) charset_add_range(cs, first, last);
+	}
+
+	if(i >= n) return 0;
+	if(negate) charset_invert(cs);
+	return i + 1;
+}
+
+/* matches a character against the atom at p[i]; returns the index after the atom, or 0 if it does not match */
+static unsigned int match_atom(const char *p, unsigned int n, unsigned int i, char c)
+{
+	CHARSET cs;
+	unsigned int end;
+
+	if(p[i] == '?') return i + 1;
+	if(p[i] == '\\' && i + 1 < n) return (p[i + 1] == c ? i + 2 : 0);
+
+	if(p[i] == '[') {
+		end = parse_set(p, n, i, &cs);
+		if(end > 0) return (CHARSET_HAS(&cs, c) ? end : 0);
+	}
+
+	return (p[i] == c ? i + 1 : 0);
+}
+
+/* checks if a segment matches the characters at s */
+static BOOL match_segment(const STR_GLOB *glob, const GLOB_SEGMENT *seg, const char *s)
+{
+	unsigned int i;
+	int atom;
+
+	if(seg->literal) return (memcmp(glob->literals + seg->start, s, seg->length) == 0);
+
+	for(i = 0; i < seg->length; ++i)
+	{
+		atom = glob->atoms[seg->start + i];
+		if(atom == GLOB_ATOM_LITERAL) {
+			if(glob->literals[seg->start + i] != s[i]) return FALSE;
+		} else if(atom != GLOB_ATOM_ANY) {
+			if(!CHARSET_HAS(&glob->sets[atom], s[i])) return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/* finds the leftmost position in s[from..to) where a segment matches completely; returns -1 if there is none */
+static int find_segment(const STR_GLOB *glob, const GLOB_SEGMENT *seg, const char *s, unsigned int from, unsigned int to)
+{
+	const char *p, *last;
+	char first;
+
+	if(to < from + seg->length) return -1;
+	last = s + to - seg->length;
+
+	/* for segments starting with a literal, let memchr skip to the candidate positions */
+	if(glob->atoms[seg->start] == GLOB_ATOM_LITERAL) {
+		first = glob->literals[seg->start];
+		for(p = s + from; p <= last; ++p)
+		{
+			p = (const char*)memchr(p, first, last - p + 1);
+			if(p == NULL) return -1;
+			if(match_segment(glob, seg, p)) return (int)(p - s);
+		}
+		return -1;
+	}
+
+	for(p = s + from; p <= last; ++p)
+		if(match_segment(glob, seg, p)) return (int)(p - s);
+
+	return -1;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* checks if a whole string matches a wildcard pattern */
+BOOL str_glob_match(const STRING *sobj, const STRING *pattern)
+{
+	const char *p, *s;
+	unsigned int n, len, pi, si, star_p, star_s, next;
+	BOOL star;
+
+	if(sobj == NULL || pattern == NULL) return FALSE;
+
+	p = pattern->data;
+	n = pattern->length;
+	s = sobj->data;
+	len = sobj->length;
+
+	/* match greedily; on a mismatch let the most recent '*' absorb one more character and retry after it */
+	pi = si = star_p = star_s = 0;
+	star = FALSE;
+	while(si < len)
+	{
+		if(pi < n && p[pi] == '*') {
+			star = TRUE;
+			star_p = ++pi;
+			star_s = si;
+			continue;
+		}
+
+		if(pi < n && (next = match_atom(p, n, pi, s[si])) > 0) {
+			pi = next;
+			++si;
+			continue;
+		}
+
+		if(!star) return FALSE;
+		pi = star_p;
+		si = ++star_s;
+	}
+
+	while(pi < n && p[pi] == '*') ++pi;
+	return (pi == n ? TRUE : FALSE);
+}
+
+/* frees memory allocated for a compiled pattern */
+void glob_dump(STR_GLOB *glob)
+{
+	if(glob == NULL) return;
+
+	free(glob->literals);
+	free(glob->atoms);
+	free(glob->segments);
+	free(glob->sets);
+	free(glob);
+}
+
+/* compiles a wildcard pattern */
+STR_GLOB* str_glob(const STRING *pattern)
+{
+	STR_GLOB *glob;
+	GLOB_SEGMENT *seg;
+	const char *p;
+	unsigned int i, n, end;
+
+	if(pattern == NULL) return NULL;
+
+	glob = (STR_GLOB*)malloc(sizeof(STR_GLOB));
+	if(glob == NULL) return NULL;
+
+	/* a pattern never has more atoms, segments or sets than characters */
+	p = pattern->data;
+	n = pattern->length;
+	glob->literals = (char*)malloc(n + 1);
+	glob->atoms = (int*)malloc((n + 1) * sizeof(int));
+	glob->segments = (GLOB_SEGMENT*)malloc((n + 1) * sizeof(GLOB_SEGMENT));
+	glob->sets = (CHARSET*)malloc((n + 1) * sizeof(CHARSET));
+	if(glob->literals == NULL || glob->atoms == NULL || glob->segments == NULL || glob->sets == NULL) {
+		glob_dump(glob);
+		return NULL;
+	}
+
+	glob->atom_count = glob->set_count = 0;
+	glob->segment_count = 1;
+	seg = &glob->segments[0];
+	seg->start = 0;
+	seg->length = 0;
+	seg->literal = TRUE;
+
+	for(i = 0; i < n; )
+	{
+		if(p[i] == '*') {
+			while(i < n && p[i] == '*') ++i;
+			seg = &glob->segments[glob->segment_count++];
+			seg->start = glob->atom_count;
+			seg->length = 0;
+			seg->literal = TRUE;
+			continue;
+		}
+
+		glob->literals[glob->atom_count] = '\0';
+		if(p[i] == '?') {
+			glob->atoms[glob->atom_count] = GLOB_ATOM_ANY;
+			seg->literal = FALSE;
+			++i;
+		} else if(p[i] == '[' && (end = parse_set(p, n, i, &glob->sets[glob->set_count])) > 0) {
+			glob->atoms[glob->atom_count] = (int)glob->set_count++;
+			seg->literal = FALSE;
+			i = end;
+		} else {
+			if(p[i] == '\\' && i + 1 < n) ++i;
+			glob->atoms[glob->atom_count] = GLOB_ATOM_LITERAL;
+			glob->literals[glob->atom_count] = p[i++];
+		}
+
+		++glob->atom_count;
+		++seg->length;
+	}
+
+	return glob;
+}
+
+/* checks if a whole string matches a compiled pattern */
+BOOL glob_match(const STR_GLOB *glob, const STRING *sobj)
+{
+	if(glob == NULL || sobj == NULL) return FALSE;
+	return glob_match_view(glob, str_view(sobj));
+}
+
+/* checks if a string view matches a compiled pattern */
+BOOL glob_match_view(const STR_GLOB *glob, STRING_VIEW view)
+{
+	const GLOB_SEGMENT *first, *last;
+	unsigned int i, from, to;
+	int pos;
+
+	if(glob == NULL || (view.data == NULL && view.length > 0)) return FALSE;
+
+	first = &glob->segments[0];
+	last = &glob->segments[glob->segment_count - 1];
+
+	/* without a '*' the pattern has a fixed length */
+	if(glob->segment_count == 1) return (view.length == first->length && match_segment(glob, first, view.data) ? TRUE : FALSE);
+
+	/* the first segment is anchored at the start and the last at the end */
+	if(view.length < first->length + last->length) return FALSE;
+	if(!match_segment(glob, first, view.data)) return FALSE;
+	if(!match_segment(glob, last, view.data + view.length - last->length)) return FALSE;
+
+	/* the leftmost match of each segment in between leaves the most room for the ones after it */
+	from = first->length;
+	to = view.length - last->length;
+	for(i = 1; i + 1 < glob->segment_count; ++i)
+	{
+		pos = find_segment(glob, &glob->segments[i], view.data, from, to);
+		if(pos < 0) return FALSE;
+		from = (unsigned int)pos + glob->segments[i].length;
+	}
+
+	return TRUE;
+}
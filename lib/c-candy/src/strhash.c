@@ -0,0 +1,355 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strhash.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <constants.h>
+#include <str.h>
+#include <strhash.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define EMPTY_SLOT				UINT_MAX
+
+/* a string to look for, with its hash */
+typedef struct {
+	unsigned int length;
+	unsigned int hash;
+	unsigned int index;
+} PATTERN;
+
+/* <------------------ private function declarations -----------------> */
+static unsigned int mod_pow(unsigned long long base, unsigned int exponent);
+static unsigned int window_hash(const STR_PREFIX_HASH *ph, unsigned int start, unsigned int length);
+static unsigned int table_size(unsigned int count, unsigned int *mask);
+static int compare_patterns(const void *p1, const void *p2);
+static unsigned int hash_of(const STRING *sobj);
+
+/* <------------------ private function definitions ------------------> */
+
+/* computes base^exponent modulo the hash modulus */
+static unsigned int mod_pow(unsigned long long base, unsigned int exponent)
+{
+	unsigned long long result;
+
+	result = 1;
+	base %= STRPH_MODULUS;
+	while(exponent > 0)
+	{
+		if(exponent & 1) result = result * base % STRPH_MODULUS;
+		base = base * base % STRPH_MODULUS;
+		exponent >>= 1;
+	}
+	return (unsigned int)result;
+}
+
+/* hashes a window of the text: the prefix difference, shifted down by the inverse power of its start */
+static unsigned int window_hash(const STR_PREFIX_HASH *ph, unsigned int start, unsigned int length)
+{
+	unsigned long long h;
+
+	h = (unsigned long long)ph->prefix[start + length] + STRPH_MODULUS - ph->prefix[start];
+	return (unsigned int)(h % STRPH_MODULUS * ph->inverse[start] % STRPH_MODULUS);
+}
+
+/* returns the number of slots (a power of 2, at least twice the count) of an open addressing table */
+static unsigned int table_size(unsigned int count, unsigned int *mask)
+{
+	unsigned int size;
+
+	for(size = 16; size < count * 2 && size < (UINT_MAX >> 1); size <<= 1);
+	*mask = size - 1;
+	return size;
+}
+
+/* orders patterns by length, then by their position in the caller's array */
+static int compare_patterns(const void *p1, const void *p2)
+{
+	const PATTERN *a, *b;
+
+	a = (const PATTERN*)p1;
+	b = (const PATTERN*)p2;
+	if(a->length != b->length) return(a->length < b->length ? -1 : 1);
+	return(a->index < b->index ? -1 : (a->index > b->index ? 1 : 0));
+}
+
+/* hashes a whole string */
+static unsigned int hash_of(const STRING *sobj)
+{
+	return (unsigned int)str_hash(sobj);
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for the prefix hashes */
+void strph_dump(STR_PREFIX_HASH *ph)
+{
+	if(ph == NULL) return;
+
+	free(ph->prefix);
+	free(ph->power);
+	free(ph->inverse);
+	free(ph);
+}
+
+/* precomputes the prefix hashes of a string */
+STR_PREFIX_HASH* strph(const STRING *text)
+{
+	STR_PREFIX_HASH *ph;
+	unsigned int i, n, inverse_base;
+
+	if(text == NULL || text->length == UINT_MAX) return NULL;
+
+	ph = (STR_PREFIX_HASH*)malloc(sizeof(STR_PREFIX_HASH));
+	if(ph == NULL) return NULL;
+
+	n = text->length;
+	ph->text = text;
+	ph->length = n;
+	ph->prefix = (unsigned int*)malloc((n + 1) * sizeof(unsigned int));
+	ph->power = (unsigned int*)malloc((n + 1) * sizeof(unsigned int));
+	ph->inverse = (unsigned int*)malloc((n + 1) * sizeof(unsigned int));
+	if(ph->prefix == NULL || ph->power == NULL || ph->inverse == NULL) {
+		strph_dump(ph);
+		return NULL;
+	}
+
+	/* the modulus is prime, so the inverse of the base is base^(m-2) */
+	inverse_base = mod_pow(STRPH_BASE, STRPH_MODULUS - 2);
+
+	ph->prefix[0] = 0;
+	ph->power[0] = 1;
+	ph->inverse[0] = 1;
+	for(i = 0; i < n; ++i)
+	{
+		ph->prefix[i + 1] = (unsigned int)((ph->prefix[i] + ((unsigned char)text->data[i] + 1ULL) * ph->power[i]) % STRPH_MODULUS);
+		ph->power[i + 1] = (unsigned int)((unsigned long long)ph->power[i] * STRPH_BASE % STRPH_MODULUS);
+		ph->inverse[i + 1] = (unsigned int)((unsigned long long)ph->inverse[i] * inverse_base % STRPH_MODULUS);
+	}
+
+	return ph;
+}
+
+/* computes the hash of a substring */
+unsigned long long strph_hash(const STR_PREFIX_HASH *ph, unsigned int start, unsigned int end)
+{
+	if(ph == NULL || start > end || end > ph->length) return 0;
+	return window_hash(ph, start, end - start);
+}
+
+/* checks if two substrings are equal */
+BOOL strph_equals(const STR_PREFIX_HASH *ph, unsigned int i, unsigned int j, unsigned int length)
+{
+	if(ph == NULL || i > ph->length || j > ph->length) return FALSE;
+	if(length > ph->length - i || length > ph->length - j) return FALSE;
+
+	if(i == j) return TRUE;
+	if(window_hash(ph, i, length) != window_hash(ph, j, length)) return FALSE;
+	return(memcmp(ph->text->data + i, ph->text->data + j, length) == 0 ? TRUE : FALSE);
+}
+
+/* computes the length of the common prefix of two suffixes */
+unsigned int strph_common_prefix(const STR_PREFIX_HASH *ph, unsigned int i, unsigned int j)
+{
+	unsigned int low, high, mid;
+
+	if(ph == NULL || i > ph->length || j > ph->length) return 0;
+	if(i == j) return ph->length - i;
+
+	/* the common prefix is the largest length whose windows hash the same */
+	low = 0;
+	high = ph->length - (i > j ? i : j);
+	while(low < high)
+	{
+		mid = low + (high - low + 1) / 2;
+		if(window_hash(ph, i, mid) == window_hash(ph, j, mid))
+			low = mid;
+		else
+			high = mid - 1;
+	}
+	return low;
+}
+
+/* compares two substrings lexicographically */
+int strph_compare(const STR_PREFIX_HASH *ph, unsigned int i, unsigned int j, unsigned int length)
+{
+	unsigned int common;
+
+	if(ph == NULL || i > ph->length || j > ph->length) return 0;
+	if(length > ph->length - i || length > ph->length - j) return 0;
+
+	common = strph_common_prefix(ph, i, j);
+	if(common >= length) return 0;
+	return (int)(unsigned char)ph->text->data[i + common] - (int)(unsigned char)ph->text->data[j + common];
+}
+
+/* finds the first occurrence of a string at or after a position */
+int strph_find(const STR_PREFIX_HASH *ph, const STRING *match, unsigned int start)
+{
+	unsigned int i, m, target;
+
+	if(ph == NULL || match == NULL || start > ph->length) return -1;
+
+	m = match->length;
+	if(m > ph->length - start) return -1;
+
+	target = hash_of(match);
+	for(i = start; i <= ph->length - m; ++i)
+	{
+		if(window_hash(ph, i, m) == target && memcmp(ph->text->data + i, match->data, m) == 0) return i;
+	}
+	return -1;
+}
+
+/* finds the first occurrence of any of several strings */
+int strph_find_any(const STR_PREFIX_HASH *ph, const STRING **matches, unsigned int count, int *which)
+{
+	PATTERN *patterns;
+	unsigned int *table;
+	unsigned int i, j, k, first, last, size, mask, slot, h, best, best_index, limit;
+
+	if(which != NULL) *which = -1;
+	if(ph == NULL || matches == NULL || count == 0) return -1;
+
+	patterns = (PATTERN*)malloc(count * sizeof(PATTERN));
+	table = (unsigned int*)malloc(table_size(count, &mask) * sizeof(unsigned int));
+	if(patterns == NULL || table == NULL) {
+		free(patterns);
+		free(table);
+		return -1;
+	}
+
+	k = 0;
+	for(i = 0; i < count; ++i)
+	{
+		if(matches[i] == NULL || matches[i]->length > ph->length) continue;
+
+		patterns[k].length = matches[i]->length;
+		patterns[k].hash = hash_of(matches[i]);
+		patterns[k].index = i;
+		++k;
+	}
+	qsort(patterns, k, sizeof(PATTERN), compare_patterns);
+
+	/* one rolling pass per distinct length, never scanning past the best position found so far */
+	best = UINT_MAX;
+	best_index = UINT_MAX;
+	for(first = 0; first < k; first = last)
+	{
+		for(last = first + 1; last < k && patterns[last].length == patterns[first].length; ++last);
+
+		size = mask + 1;
+		for(j = 0; j < size; ++j) table[j] = EMPTY_SLOT;
+		for(j = first; j < last; ++j)
+		{
+			for(slot = patterns[j].hash & mask; table[slot] != EMPTY_SLOT; slot = (slot + 1) & mask);
+			table[slot] = j;
+		}
+
+		limit = ph->length - patterns[first].length;
+		if(best < limit) limit = best;
+		for(i = 0; i <= limit; ++i)
+		{
+			h = window_hash(ph, i, patterns[first].length);
+			for(slot = h & mask; table[slot] != EMPTY_SLOT; slot = (slot + 1) & mask)
+			{
+				j = table[slot];
+				if(patterns[j].hash != h) continue;
+				if(memcmp(ph->text->data + i, matches[patterns[j].index]->data, patterns[j].length) != 0) continue;
+
+				if(i < best || patterns[j].index < best_index) {
+					best = i;
+					best_index = patterns[j].index;
+				}
+			}
+			if(best == i) break;
+		}
+	}
+
+	free(patterns);
+	free(table);
+
+	if(best == UINT_MAX) return -1;
+	if(which != NULL) *which = (int)best_index;
+	return (int)best;
+}
+
+/* finds every window which repeats an earlier window */
+int strph_duplicate_windows(const STR_PREFIX_HASH *ph, unsigned int window, STR_WINDOW_MATCH **matches)
+{
+	STR_WINDOW_MATCH *result, *temp;
+	unsigned int *table, *hashes;
+	unsigned int i, windows, size, mask, slot, h, count, capacity;
+
+	if(matches != NULL) *matches = NULL;
+	if(ph == NULL || matches == NULL || window == 0) return -1;
+	if(window > ph->length) return 0;
+
+	windows = ph->length - window + 1;
+	size = table_size(windows, &mask);
+	table = (unsigned int*)malloc(size * sizeof(unsigned int));
+	hashes = (unsigned int*)malloc(size * sizeof(unsigned int));
+	if(table == NULL || hashes == NULL) {
+		free(table);
+		free(hashes);
+		return -1;
+	}
+	for(i = 0; i < size; ++i) table[i] = EMPTY_SLOT;
+
+	/* the table keeps the first position of every distinct window, keyed by its hash */
+	result = NULL;
+	count = capacity = 0;
+	for(i = 0; i < windows; ++i)
+	{
+		h = window_hash(ph, i, window);
+		for(slot = h & mask; table[slot] != EMPTY_SLOT; slot = (slot + 1) & mask)
+		{
+			if(hashes[slot] == h && memcmp(ph->text->data + table[slot], ph->text->data + i, window) == 0) break;
+		}
+
+		if(table[slot] == EMPTY_SLOT) {
+			table[slot] = i;
+			hashes[slot] = h;
+			continue;
+		}
+
+		if(count == capacity) {
+			capacity = (capacity == 0 ? 16 : capacity * 2);
+			temp = (STR_WINDOW_MATCH*)realloc(result, capacity * sizeof(STR_WINDOW_MATCH));
+			if(temp == NULL) {
+				free(result);
+				free(table);
+				free(hashes);
+				return -1;
+			}
+			result = temp;
+		}
+		result[count].position = i;
+		result[count].first = table[slot];
+		++count;
+	}
+
+	free(table);
+	free(hashes);
+
+	*matches = result;
+	return (int)count;
+}
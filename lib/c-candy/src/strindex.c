@@ -0,0 +1,469 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strindex.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <constants.h>
+#include <str.h>
+#include <strindex.h>
+
+/* <------------------ private constant declarations -----------------> */
+
+/* suffix types for SA-IS: S-type suffixes are smaller than their successor, L-type ones larger */
+#define TYPE_GET(t, i)			(((t)[(i) >> 3] >> ((i) & 7)) & 1)
+#define TYPE_SET(t, i, b)		((b) ? ((t)[(i) >> 3] |= (1 << ((i) & 7))) : ((t)[(i) >> 3] &= ~(1 << ((i) & 7))))
+#define IS_LMS(t, i)			((i) > 0 && TYPE_GET(t, i) && !TYPE_GET(t, (i) - 1))
+
+/* <------------------ private function declarations -----------------> */
+static void get_buckets(const int *s, int *bkt, int n, int k, BOOL end);
+static void induce_l(const unsigned char *t, int *sa, const int *s, int *bkt, int n, int k);
+static void induce_s(const unsigned char *t, int *sa, const int *s, int *bkt, int n, int k);
+static BOOL sais(const int *s, int *sa, int n, int k);
+static unsigned int* build_lcp(const char *text, const unsigned int *sa, unsigned int n);
+static int compare_suffix(const STR_INDEX *idx, unsigned int suffix, const STRING *match);
+static BOOL find_range(const STR_INDEX *idx, const STRING *match, unsigned int *first, unsigned int *last);
+static int compare_positions(const void *p1, const void *p2);
+static unsigned long long text_checksum(const STRING *text);
+
+/* <------------------ private function definitions ------------------> */
+
+/* computes the start (or end) of the bucket of every symbol */
+static void get_buckets(const int *s, int *bkt, int n, int k, BOOL end)
+{
+	int i, sum;
+
+	for(i = 0; i <= k; ++i) bkt[i] = 0;
+	for(i = 0; i < n; ++i) ++bkt[s[i]];
+
+	sum = 0;
+	for(i = 0; i <= k; ++i)
+	{
+		sum += bkt[i];
+		bkt[i] = (end ? sum : sum - bkt[i]);
+	}
+}
+
+/* induces the order of L-type suffixes from the sorted suffixes already placed */
+static void induce_l(const unsigned char *t, int *sa, const int *s, int *bkt, int n, int k)
+{
+	int i, j;
+
+	get_buckets(s, bkt, n, k, FALSE);
+	for(i = 0; i < n; ++i)
+	{
+		j = sa[i] - 1;
+		if(j >= 0 && !TYPE_GET(t, j)) sa[bkt[s[j]]++] = j;
+	}
+}
+
+/* induces the order of S-type suffixes from the sorted L-type suffixes */
+static void induce_s(const unsigned char *t, int *sa, const int *s, int *bkt, int n, int k)
+{
+	int i, j;
+
+	get_buckets(s, bkt, n, k, TRUE);
+	for(i = n - 1; i >= 0; --i)
+	{
+		j = sa[i] - 1;
+		if(j >= 0 && TYPE_GET(t, j)) sa[--bkt[s[j]]] = j;
+	}
+}
+
+/*
+ * SA-IS (Nong, Zhang and Chan): sorts the suffixes of s[0..n-1] over the alphabet [0, k], where s[n-1] is
+ * a unique smallest sentinel 0
+ */
+static BOOL sais(const int *s, int *sa, int n, int k)
+{
+	unsigned char *t;
+	int *bkt, *s1, *sa1;
+	int i, j, d, n1, name, prev, pos;
+	BOOL diff;
+
+	t = (unsigned char*)calloc(n / 8 + 1, sizeof(unsigned char));
+	bkt = (int*)malloc((k + 1) * sizeof(int));
+	if(t == NULL || bkt == NULL) {
+		free(t);
+		free(bkt);
+		return FALSE;
+	}
+
+	/* classify the suffixes */
+	TYPE_SET(t, n - 1, 1);
+	if(n > 1) TYPE_SET(t, n - 2, 0);
+	for(i = n - 3; i >= 0; --i)
+		TYPE_SET(t, i, (s[i] < s[i + 1] || (s[i] == s[i + 1] && TYPE_GET(t, i + 1))) ? 1 : 0);
+
+	/* stage 1: sort the LMS substrings by induction */
+	get_buckets(s, bkt, n, k, TRUE);
+	for(i = 0; i < n; ++i) sa[i] = -1;
+	for(i = 1; i < n; ++i)
+		if(IS_LMS(t, i)) sa[--bkt[s[i]]] = i;
+	induce_l(t, sa, s, bkt, n, k);
+	induce_s(t, sa, s, bkt, n, k);
+
+	/* move the sorted LMS substrings to the front and give each distinct one a name */
+	n1 = 0;
+	for(i = 0; i < n; ++i)
+		if(IS_LMS(t, sa[i])) sa[n1++] = sa[i];
+
+	for(i = n1; i < n; ++i) sa[i] = -1;
+	name = 0;
+	prev = -1;
+	for(i = 0; i < n1; ++i)
+	{
+		pos = sa[i];
+		diff = FALSE;
+		for(d = 0; d < n; ++d)
+		{
+			if(prev == -1 || s[pos + d] != s[prev + d] || TYPE_GET(t, pos + d) != TYPE_GET(t, prev + d)) {
+				diff = TRUE;
+				break;
+			} else if(d > 0 && (IS_LMS(t, pos + d) || IS_LMS(t, prev + d))) {
+				break;
+			}
+		}
+
+		if(diff) {
+			++name;
+			prev = pos;
+		}
+		sa[n1 + pos / 2] = name - 1;
+	}
+	for(i = n - 1, j = n - 1; i >= n1; --i)
+		if(sa[i] >= 0) sa[j--] = sa[i];
+
+	/* stage 2: sort the reduced string, recursing if the names are not unique */
+	s1 = sa + n - n1;
+	sa1 = sa;
+	if(name < n1) {
+		if(!sais(s1, sa1, n1, name - 1)) {
+			free(t);
+			free(bkt);
+			return FALSE;
+		}
+	} else {
+		for(i = 0; i < n1; ++i) sa1[s1[i]] = i;
+	}
+
+	/* stage 3: induce the full suffix array from the sorted LMS suffixes */
+	get_buckets(s, bkt, n, k, TRUE);
+	for(i = 1, j = 0; i < n; ++i)
+		if(IS_LMS(t, i)) s1[j++] = i;
+	for(i = 0; i < n1; ++i) sa1[i] = s1[sa1[i]];
+	for(i = n1; i < n; ++i) sa[i] = -1;
+	for(i = n1 - 1; i >= 0; --i)
+	{
+		j = sa[i];
+		sa[i] = -1;
+		sa[--bkt[s[j]]] = j;
+	}
+	induce_l(t, sa, s, bkt, n, k);
+	induce_s(t, sa, s, bkt, n, k);
+
+	free(bkt);
+	free(t);
+	return TRUE;
+}
+
+/* Kasai's algorithm: lcp[i] is the length of the common prefix of suffixes sa[i-1] and sa[i] */
+static unsigned int* build_lcp(const char *text, const unsigned int *sa, unsigned int n)
+{
+	unsigned int *lcp, *rank;
+	unsigned int i, j, h;
+
+	lcp = (unsigned int*)malloc((n > 0 ? n : 1) * sizeof(unsigned int));
+	rank = (unsigned int*)malloc((n > 0 ? n : 1) * sizeof(unsigned int));
+	if(lcp == NULL || rank == NULL) {
+		free(lcp);
+		free(rank);
+		return NULL;
+	}
+
+	for(i = 0; i < n; ++i) rank[sa[i]] = i;
+
+	h = 0;
+	for(i = 0; i < n; ++i)
+	{
+		if(rank[i] == 0) {
+			lcp[0] = 0;
+			h = 0;
+			continue;
+		}
+
+		j = sa[rank[i] - 1];
+		while(i + h < n && j + h < n && text[i + h] == text[j + h]) ++h;
+		lcp[rank[i]] = h;
+		if(h > 0) --h;
+	}
+
+	free(rank);
+	return lcp;
+}
+
+/* compares the first match->length bytes of a suffix with a string */
+static int compare_suffix(const STR_INDEX *idx, unsigned int suffix, const STRING *match)
+{
+	unsigned int available;
+	int diff;
+
+	available = idx->length - suffix;
+	diff = memcmp(idx->text->data + suffix, match->data, available < match->length ? available : match->length);
+	if(diff != 0) return diff;
+	return (available < match->length ? -1 : 0);
+}
+
+/* binary searches the suffix array for the range [first, last) of suffixes starting with a string */
+static BOOL find_range(const STR_INDEX *idx, const STRING *match, unsigned int *first, unsigned int *last)
+{
+	unsigned int lo, hi, mid;
+
+	lo = 0;
+	hi = idx->length;
+	while(lo < hi)
+	{
+		mid = lo + (hi - lo) / 2;
+		if(compare_suffix(idx, idx->sa[mid], match) < 0) lo = mid + 1;
+		else hi = mid;
+	}
+	*first = lo;
+
+	hi = idx->length;
+	while(lo < hi)
+	{
+		mid = lo + (hi - lo) / 2;
+		if(compare_suffix(idx, idx->sa[mid], match) <= 0) lo = mid + 1;
+		else hi = mid;
+	}
+	*last = lo;
+
+	return (*first < *last ? TRUE : FALSE);
+}
+
+/* orders positions ascending */
+static int compare_positions(const void *p1, const void *p2)
+{
+	unsigned int a, b;
+
+	a = *(const unsigned int*)p1;
+	b = *(const unsigned int*)p2;
+	return (a < b ? -1 : (a > b ? 1 : 0));
+}
+
+/* fingerprints the indexed text so that a saved index is not loaded against another string */
+static unsigned long long text_checksum(const STRING *text)
+{
+	unsigned long long hash;
+	unsigned int i;
+
+	/* 64-bit FNV-1a */
+	hash = 14695981039346656037ULL;
+	for(i = 0; i < text->length; ++i)
+	{
+		hash ^= (unsigned char)text->data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for the index */
+void stridx_dump(STR_INDEX *idx)
+{
+	if(idx != NULL)
+	{
+		free(idx->sa);
+		free(idx->lcp);
+		free(idx);
+	}
+}
+
+/* builds a suffix array and LCP array over a string */
+STR_INDEX* stridx(const STRING *text)
+{
+	STR_INDEX *idx;
+	int *s, *sa;
+	unsigned int i, n;
+
+	if(text == NULL || text->length >= INT_MAX) return NULL;
+	n = text->length;
+
+	idx = (STR_INDEX*)malloc(sizeof(STR_INDEX));
+	if(idx == NULL) return NULL;
+
+	idx->text = text;
+	idx->length = n;
+	idx->lcp = NULL;
+
+	/* bytes are shifted up by one so that 0 can serve as the sentinel */
+	s = (int*)malloc((n + 1) * sizeof(int));
+	sa = (int*)malloc((n + 1) * sizeof(int));
+	if(s == NULL || sa == NULL) {
+		free(s);
+		free(sa);
+		free(idx);
+		return NULL;
+	}
+
+	for(i = 0; i < n; ++i) s[i] = (unsigned char)text->data[i] + 1;
+	s[n] = 0;
+
+	if(!sais(s, sa, n + 1, 256)) {
+		free(s);
+		free(sa);
+		free(idx);
+		return NULL;
+	}
+	free(s);
+
+	/* drop the sentinel suffix, which always sorts first */
+	memmove(sa, sa + 1, n * sizeof(int));
+	idx->sa = (unsigned int*)sa;
+
+	idx->lcp = build_lcp(text->data, idx->sa, n);
+	if(idx->lcp == NULL) {
+		stridx_dump(idx);
+		return NULL;
+	}
+
+	return idx;
+}
+
+/* counts the occurrences of a string in the indexed text */
+int stridx_count(const STR_INDEX *idx, const STRING *match)
+{
+	unsigned int first, last;
+
+	if(idx == NULL || match == NULL || match->length == 0) return -1;
+	if(!find_range(idx, match, &first, &last)) return 0;
+	return last - first;
+}
+
+/* finds the first occurrence of a string in the indexed text */
+int stridx_find(const STR_INDEX *idx, const STRING *match)
+{
+	unsigned int first, last, i, best;
+
+	if(idx == NULL || match == NULL || match->length == 0) return -1;
+	if(!find_range(idx, match, &first, &last)) return -1;
+
+	best = idx->sa[first];
+	for(i = first + 1; i < last; ++i)
+		if(idx->sa[i] < best) best = idx->sa[i];
+
+	return best;
+}
+
+/* finds all occurrences of a string in the indexed text */
+int stridx_find_all(const STR_INDEX *idx, const STRING *match, unsigned int **indices)
+{
+	unsigned int first, last;
+
+	if(indices != NULL) *indices = NULL;
+	if(idx == NULL || match == NULL || indices == NULL || match->length == 0) return -1;
+	if(!find_range(idx, match, &first, &last)) return 0;
+
+	*indices = (unsigned int*)malloc((last - first) * sizeof(unsigned int));
+	if(*indices == NULL) return -1;
+
+	memcpy(*indices, idx->sa + first, (last - first) * sizeof(unsigned int));
+	qsort(*indices, last - first, sizeof(unsigned int), compare_positions);
+	return last - first;
+}
+
+/* finds the longest substring which occurs at least twice in the indexed text */
+unsigned int stridx_longest_repeat(const STR_INDEX *idx, unsigned int *position)
+{
+	unsigned int i, best, best_at;
+
+	if(idx == NULL) return 0;
+
+	best = 0;
+	best_at = 0;
+	for(i = 1; i < idx->length; ++i)
+	{
+		if(idx->lcp[i] > best) {
+			best = idx->lcp[i];
+			best_at = idx->sa[i];
+		}
+	}
+
+	if(position != NULL) *position = best_at;
+	return best;
+}
+
+/* writes the index to a stream */
+BOOL stridx_save(const STR_INDEX *idx, FILE *fp)
+{
+	unsigned int header[2];
+	unsigned long long checksum;
+
+	if(idx == NULL || fp == NULL) return FALSE;
+
+	header[0] = STRIDX_FILE_VERSION;
+	header[1] = idx->length;
+	checksum = text_checksum(idx->text);
+
+	if(fwrite(STRIDX_FILE_MAGIC, 1, 8, fp) != 8) return FALSE;
+	if(fwrite(header, sizeof(unsigned int), 2, fp) != 2) return FALSE;
+	if(fwrite(&checksum, sizeof(checksum), 1, fp) != 1) return FALSE;
+	if(fwrite(idx->sa, sizeof(unsigned int), idx->length, fp) != idx->length) return FALSE;
+	if(fwrite(idx->lcp, sizeof(unsigned int), idx->length, fp) != idx->length) return FALSE;
+	return TRUE;
+}
+
+/* reads an index written by stridx_save() */
+STR_INDEX* stridx_load(const STRING *text, FILE *fp)
+{
+	STR_INDEX *idx;
+	char magic[8];
+	unsigned int header[2];
+	unsigned long long checksum;
+	size_t n;
+
+	if(text == NULL || fp == NULL) return NULL;
+
+	if(fread(magic, 1, 8, fp) != 8 || memcmp(magic, STRIDX_FILE_MAGIC, 8) != 0) return NULL;
+	if(fread(header, sizeof(unsigned int), 2, fp) != 2) return NULL;
+	if(fread(&checksum, sizeof(checksum), 1, fp) != 1) return NULL;
+	if(header[0] != STRIDX_FILE_VERSION || header[1] != text->length) return NULL;
+	if(checksum != text_checksum(text)) return NULL;
+
+	idx = (STR_INDEX*)malloc(sizeof(STR_INDEX));
+	if(idx == NULL) return NULL;
+
+	n = (text->length > 0 ? text->length : 1);
+	idx->text = text;
+	idx->length = text->length;
+	idx->sa = (unsigned int*)malloc(n * sizeof(unsigned int));
+	idx->lcp = (unsigned int*)malloc(n * sizeof(unsigned int));
+	if(idx->sa == NULL || idx->lcp == NULL
+		|| fread(idx->sa, sizeof(unsigned int), idx->length, fp) != idx->length
+		|| fread(idx->lcp, sizeof(unsigned int), idx->length, fp) != idx->length) {
+		stridx_dump(idx);
+		return NULL;
+	}
+
+	return idx;
+}
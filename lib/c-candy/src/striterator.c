@@ -20,10 +20,277 @@
  */
 
 #include <stdlib.h>
+#include <limits.h>
 #include <constants.h>
+#include <charset.h>
 #include <str.h>
 #include <striterator.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STRI_X86
+#include <immintrin.h>
+#endif
+
+/* <------------------ private constant declarations -----------------> */
+#define SIMD_NONE				0
+#define SIMD_SSSE3				2
+#define SIMD_AVX2				3
+
+/* characters checked one at a time before the lookup tables are built, as most runs are short */
+#define SCALAR_PREFIX			16
+
+static int simd_level = -1;
+
+/* <------------------ private function declarations -----------------> */
+static int get_simd_level();
+static int find_forward(const char *data, int from, int to, const CHARSET *cs, BOOL member);
+static int find_backward(const char *data, int from, int to, const CHARSET *cs, BOOL member);
+static STRI_SPAN scan(STRING_ITERATOR *s, const CHARSET *cs, int direction, BOOL member);
+
+#ifdef STRI_X86
+static void nibble_tables(const CHARSET *cs, unsigned char *low, unsigned char *high);
+static int find_forward_ssse3(const unsigned char *s, int n, const unsigned char *low, const unsigned char *high, BOOL member);
+static int find_backward_ssse3(const unsigned char *s, int n, const unsigned char *low, const unsigned char *high, BOOL member);
+static int find_forward_avx2(const unsigned char *s, int n, const unsigned char *low, const unsigned char *high, BOOL member);
+static int find_backward_avx2(const unsigned char *s, int n, const unsigned char *low, const unsigned char *high, BOOL member);
+#endif
+
+/* <------------------ private function definitions ------------------> */
+
+/* detects (once) the widest instruction set the kernels can use on this CPU */
+static int get_simd_level()
+{
+	if(simd_level < 0) {
+#ifdef STRI_X86
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx2"))
+			simd_level = SIMD_AVX2;
+		else if(__builtin_cpu_supports("ssse3"))
+			simd_level = SIMD_SSSE3;
+		else
+			simd_level = SIMD_NONE;
+#else
+		simd_level = SIMD_NONE;
+#endif
+	}
+	return simd_level;
+}
+
+#ifdef STRI_X86
+
+/* splits a set into two 16-byte tables indexed by the low nibble, with one bit per high nibble (0-7 in low, 8-15 in high) */
+static void nibble_tables(const CHARSET *cs, unsigned char *low, unsigned char *high)
+{
+	int l, h;
+
+	for(l = 0; l < 16; ++l)
+	{
+		low[l] = 0;
+		high[l] = 0;
+		for(h = 0; h < 8; ++h)
+		{
+			if(CHARSET_HAS(cs, (h << 4) | l)) low[l] |= (unsigned char)(1 << h);
+			if(CHARSET_HAS(cs, ((h + 8) << 4) | l)) high[l] |= (unsigned char)(1 << h);
+		}
+	}
+}
+
+/* marks the members of a set in a 16-byte block (pshufb nibble lookup) */
+__attribute__((target("ssse3")))
+static __inline__ __m128i member_mask_ssse3(__m128i x, __m128i low, __m128i high)
+{
+	const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+	__m128i nibble, rows, bit;
+
+	/* pshufb yields 0 for indices with the top bit set, which selects the table for the high nibble */
+	nibble = _mm_and_si128(x, _mm_set1_epi8(0x0f));
+	rows = _mm_or_si128(_mm_shuffle_epi8(low, _mm_or_si128(nibble, _mm_and_si128(x, _mm_set1_epi8(-128)))),
+						_mm_shuffle_epi8(high, _mm_or_si128(nibble, _mm_andnot_si128(x, _mm_set1_epi8(-128)))));
+	bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(x, 4), _mm_set1_epi8(0x0f)));
+	return _mm_cmpeq_epi8(_mm_and_si128(rows, bit), bit);
+}
+
+/* returns the offset of the first byte with the given membership within the 16-byte blocks of s, or the number of bytes scanned */
+__attribute__((target("ssse3")))
+static int find_forward_ssse3(const unsigned char *s, int n, const unsigned char *low, const unsigned char *high, BOOL member)
+{
+	__m128i tlow, thigh;
+	unsigned int mask, flip;
+	int i;
+
+	tlow = _mm_loadu_si128((const __m128i*)low);
+	thigh = _mm_loadu_si128((const __m128i*)high);
+	flip = (member ? 0 : 0xffff);
+
+	for(i = 0; n - i >= 16; i += 16)
+	{
+		mask = (unsigned int)_mm_movemask_epi8(member_mask_ssse3(_mm_loadu_si128((const __m128i*)(s + i)), tlow, thigh)) ^ flip;
+		if(mask != 0) return i + __builtin_ctz(mask);
+	}
+	return i;
+}
+
+/* returns one past the last byte with the given membership within the trailing 16-byte blocks of s, or the number of bytes left unscanned */
+__attribute__((target("ssse3")))
+static int find_backward_ssse3(const unsigned char *s, int n, const unsigned char *low, const unsigned char *high, BOOL member)
+{
+	__m128i tlow, thigh;
+	unsigned int mask, flip;
+	int i;
+
+	tlow = _mm_loadu_si128((const __m128i*)low);
+	thigh = _mm_loadu_si128((const __m128i*)high);
+	flip = (member ? 0 : 0xffff);
+
+	for(i = n; i >= 16; i -= 16)
+	{
+		mask = (unsigned int)_mm_movemask_epi8(member_mask_ssse3(_mm_loadu_si128((const __m128i*)(s + i - 16)), tlow, thigh)) ^ flip;
+		if(mask != 0) return i - 16 + 32 - __builtin_clz(mask);
+	}
+	return i;
+}
+
+/* marks the members of a set in a 32-byte block (pshufb nibble lookup on both lanes) */
+__attribute__((target("avx2")))
+static __inline__ __m256i member_mask_avx2(__m256i x, __m256i low, __m256i high)
+{
+	const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+										  1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+	__m256i nibble, rows, bit;
+
+	nibble = _mm256_and_si256(x, _mm256_set1_epi8(0x0f));
+	rows = _mm256_or_si256(_mm256_shuffle_epi8(low, _mm256_or_si256(nibble, _mm256_and_si256(x, _mm256_set1_epi8(-128)))),
+						   _mm256_shuffle_epi8(high, _mm256_or_si256(nibble, _mm256_andnot_si256(x, _mm256_set1_epi8(-128)))));
+	bit = _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(x, 4), _mm256_set1_epi8(0x0f)));
+	return _mm256_cmpeq_epi8(_mm256_and_si256(rows, bit), bit);
+}
+
+/* returns the offset of the first byte with the given membership within the 32-byte blocks of s, or the number of bytes scanned */
+__attribute__((target("avx2")))
+static int find_forward_avx2(const unsigned char *s, int n, const unsigned char *low, const unsigned char *high, BOOL member)
+{
+	__m256i tlow, thigh;
+	unsigned int mask, flip;
+	int i;
+
+	tlow = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)low));
+	thigh = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)high));
+	flip = (member ? 0 : 0xffffffff);
+
+	for(i = 0; n - i >= 32; i += 32)
+	{
+		mask = (unsigned int)_mm256_movemask_epi8(member_mask_avx2(_mm256_loadu_si256((const __m256i*)(s + i)), tlow, thigh)) ^ flip;
+		if(mask != 0) return i + __builtin_ctz(mask);
+	}
+	return i;
+}
+
+/* returns one past the last byte with the given membership within the trailing 32-byte blocks of s, or the number of bytes left unscanned */
+__attribute__((target("avx2")))
+static int find_backward_avx2(const unsigned char *s, int n, const unsigned char *low, const unsigned char *high, BOOL member)
+{
+	__m256i tlow, thigh;
+	unsigned int mask, flip;
+	int i;
+
+	tlow = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)low));
+	thigh = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)high));
+	flip = (member ? 0 : 0xffffffff);
+
+	for(i = n; i >= 32; i -= 32)
+	{
+		mask = (unsigned int)_mm256_movemask_epi8(member_mask_avx2(_mm256_loadu_si256((const __m256i*)(s + i - 32)), tlow, thigh)) ^ flip;
+		if(mask != 0) return i - 32 + 32 - __builtin_clz(mask);
+	}
+	return i;
+}
+
+#endif
+
+/* returns the first position in [from, to) whose membership in a set is as given, or to if there is none */
+static int find_forward(const char *data, int from, int to, const CHARSET *cs, BOOL member)
+{
+#ifdef STRI_X86
+	unsigned char low[16], high[16];
+#endif
+	int i, end;
+
+	end = (to - from > SCALAR_PREFIX ? from + SCALAR_PREFIX : to);
+	for(i = from; i < end; ++i)
+		if((CHARSET_HAS(cs, data[i]) ? TRUE : FALSE) == member) return i;
+
+#ifdef STRI_X86
+	if(to - i >= 16 && get_simd_level() >= SIMD_SSSE3) {
+		nibble_tables(cs, low, high);
+		if(get_simd_level() == SIMD_AVX2) {
+			i += find_forward_avx2((const unsigned char*)data + i, to - i, low, high, member);
+			if(to - i >= 32) return i;
+		}
+		i += find_forward_ssse3((const unsigned char*)data + i, to - i, low, high, member);
+		if(to - i >= 16) return i;
+	}
+#endif
+
+	for(; i < to; ++i)
+		if((CHARSET_HAS(cs, data[i]) ? TRUE : FALSE) == member) return i;
+
+	return to;
+}
+
+/* returns the last position in [from, to) whose membership in a set is as given, or from - 1 if there is none */
+static int find_backward(const char *data, int from, int to, const CHARSET *cs, BOOL member)
+{
+#ifdef STRI_X86
+	unsigned char low[16], high[16];
+#endif
+	int i, end;
+
+	/* i is one past the next position to check */
+	end = (to - from > SCALAR_PREFIX ? to - SCALAR_PREFIX : from);
+	for(i = to; i > end; --i)
+		if((CHARSET_HAS(cs, data[i - 1]) ? TRUE : FALSE) == member) return i - 1;
+
+#ifdef STRI_X86
+	if(i - from >= 16 && get_simd_level() >= SIMD_SSSE3) {
+		nibble_tables(cs, low, high);
+		if(get_simd_level() == SIMD_AVX2) {
+			i = from + find_backward_avx2((const unsigned char*)data + from, i - from, low, high, member);
+			if(i - from >= 32) return i - 1;
+		}
+		i = from + find_backward_ssse3((const unsigned char*)data + from, i - from, low, high, member);
+		if(i - from >= 16) return i - 1;
+	}
+#endif
+
+	for(; i > from; --i)
+		if((CHARSET_HAS(cs, data[i - 1]) ? TRUE : FALSE) == member) return i - 1;
+
+	return from - 1;
+}
+
+/* moves the marker up to the next character (in the given direction) whose membership in a set is as given */
+static STRI_SPAN scan(STRING_ITERATOR *s, const CHARSET *cs, int direction, BOOL member)
+{
+	STRI_SPAN span;
+
+	if(s == NULL || cs == NULL || (direction != STRI_FORWARD && direction != STRI_BACKWARD)) {
+		span.start = -1;
+		span.end = -1;
+		return span;
+	}
+
+	if(direction == STRI_FORWARD) {
+		span.start = s->marker;
+		span.end = find_forward(s->chars, s->marker, s->length, cs, member);
+		s->marker = span.end;
+	} else {
+		span.start = find_backward(s->chars, 0, s->marker, cs, member) + 1;
+		span.end = s->marker;
+		s->marker = span.start;
+	}
+	return span;
+}
+
 /* <----------------------- public function definitions -------------------------> */
 
 /* frees memory allocated for the string iterator object */
@@ -31,7 +298,7 @@ void stri_dump(STRING_ITERATOR *s)
 {
 	if(s != NULL)
 	{
-		str_dump(s->data);
+		if(s->data != NULL) str_dump(s->data);
 		free(s);
 	}
 }
@@ -48,30 +315,85 @@ STRING_ITERATOR* stri(const STRING *s)
 	if(result == NULL) return NULL;
 
 	result->data = str_copy(s);
+	if(result->data == NULL) {
+		free(result);
+		return NULL;
+	}
+
 	result->marker = 0;
+	result->chars = result->data->data;
+	result->length = result->data->length;
 	return result;
 }
 
 /* returns a new string iterator object from a given C-style string */
 STRING_ITERATOR* stri_cs(const char *s)
 {
-	return stri(str(s));
+	STRING_ITERATOR *result;
+	STRING *sobj;
+
+	sobj = string(s);
+	if(sobj == NULL) return NULL;
+	if(sobj->length == 0) {
+		str_dump(sobj);
+		return NULL;
+	}
+
+	result = (STRING_ITERATOR*)malloc(sizeof(STRING_ITERATOR));
+	if(result == NULL) {
+		str_dump(sobj);
+		return NULL;
+	}
+
+	/* the iterator takes over the temporary string instead of copying it again */
+	result->data = sobj;
+	result->marker = 0;
+	result->chars = sobj->data;
+	result->length = sobj->length;
+	return result;
+}
+
+/* initializes an iterator borrowing the characters of a given string */
+BOOL stri_init(STRING_ITERATOR *s, const STRING *src)
+{
+	if(src == NULL) return FALSE;
+	return stri_init_chars(s, src->data, src->length);
+}
+
+/* initializes an iterator borrowing the characters of a given view */
+BOOL stri_init_view(STRING_ITERATOR *s, STRING_VIEW view)
+{
+	return stri_init_chars(s, view.data, view.length);
+}
+
+/* initializes an iterator borrowing a given character buffer */
+BOOL stri_init_chars(STRING_ITERATOR *s, const char *chars, unsigned int length)
+{
+	if(s == NULL) return FALSE;
+	if(chars == NULL && length > 0) return FALSE;
+	if(length > INT_MAX) return FALSE;
+
+	s->data = NULL;
+	s->marker = 0;
+	s->chars = chars;
+	s->length = (int)length;
+	return TRUE;
 }
 
 /* returns the character at the current marker position */
 char stri_this(const STRING_ITERATOR *s)
 {
 	if(s == NULL) return -1;
-	if(s->marker == s->data->length) return -1;
-	return s->data->data[s->marker];
+	if(s->marker == s->length) return -1;
+	return s->chars[s->marker];
 }
 
 /* returns the character to the right of the current marker position */
 char stri_next(const STRING_ITERATOR *s)
 {
 	if(s == NULL) return -1;
-	if(s->marker >= s->data->length) return -1;
-	return s->data->data[s->marker + 1];
+	if(s->marker + 1 >= s->length) return -1;
+	return s->chars[s->marker + 1];
 }
 
 /* returns the character to the left of the current marker position */
@@ -79,14 +401,14 @@ char stri_prev(const STRING_ITERATOR *s)
 {
 	if(s == NULL) return -1;
 	if(s->marker <= 0) return -1;
-	return s->data->data[s->marker - 1];
+	return s->chars[s->marker - 1];
 }
 
 /* returns the current marker position */
 int stri_pos(const STRING_ITERATOR *s)
 {
 	if(s == NULL) return -1;
-	return(s->marker == s->data->length ? STRI_EOS : s->marker);
+	return(s->marker == s->length ? STRI_EOS : s->marker);
 }
 
 /* moves the marker to a certain number of characters, positive for right, negative for left */
@@ -98,7 +420,7 @@ BOOL stri_move(STRING_ITERATOR *s, int num_chars)
 
 	new_pos = s->marker + num_chars;
 	if(new_pos < 0) new_pos = 0;
-	if(new_pos > s->data->length) new_pos = s->data->length;
+	if(new_pos > s->length) new_pos = s->length;
 	s->marker = new_pos;
 	return TRUE;
 }
@@ -139,7 +461,7 @@ BOOL stri_move_bos(STRING_ITERATOR *s)
 BOOL stri_move_eos(STRING_ITERATOR *s)
 {
 	if(s == NULL) return FALSE;
-	s->marker = s->data->length;
+	s->marker = s->length;
 	return TRUE;
 }
 
@@ -147,7 +469,7 @@ BOOL stri_move_eos(STRING_ITERATOR *s)
 BOOL stri_is_at_eos(const STRING_ITERATOR *s)
 {
 	if(s == NULL) return FALSE;
-	return (s->marker == s->data->length ? TRUE : FALSE);
+	return (s->marker == s->length ? TRUE : FALSE);
 }
 
 /* return TRUE if the marker is at the beginning of the string */
@@ -167,41 +489,109 @@ BOOL stri_is_at(const STRING_ITERATOR *s, int position)
 /* moves the marker until the given character is found */
 int stri_move_until(STRING_ITERATOR *s, const char *chars, int step)
 {
-	STRING *schars;
+	CHARSET cs;
 
-	if(s == NULL) return -1;
-	schars = str(chars);
-	if(schars == NULL) return -1;
-	
-	while(s->marker < s->data->length && !str_is_char_in(schars, s->data->data[s->marker]))
+	if(s == NULL || chars == NULL) return -1;
+	charset_init(&cs, chars);
+	return stri_move_until_charset(s, &cs, step);
+}
+
+/* moves the marker until any character other than the given character is found */
+int stri_move_while(STRING_ITERATOR *s, const char *chars, int step)
+{
+	CHARSET cs;
+
+	if(s == NULL || chars == NULL) return -1;
+	charset_init(&cs, chars);
+	return stri_move_while_charset(s, &cs, step);
+}
+
+/* moves the marker until a character belonging to the set is found */
+int stri_move_until_charset(STRING_ITERATOR *s, const CHARSET *cs, int step)
+{
+	const char *data;
+	int length;
+
+	if(s == NULL || cs == NULL) return -1;
+
+	data = s->chars;
+	length = s->length;
+	/* single steps in either direction are bulk scans */
+	if(step == 1) {
+		s->marker = find_forward(data, s->marker, length, cs, TRUE);
+		return s->marker;
+	}
+	if(step == -1 && s->marker < length) {
+		s->marker = find_backward(data, 0, s->marker + 1, cs, TRUE);
+		if(s->marker < 0) s->marker = 0;
+		return s->marker;
+	}
+
+	while(s->marker >= 0 && s->marker < length && !CHARSET_HAS(cs, data[s->marker]))
 		s->marker += step;
 
 	if(s->marker < 0)
 		s->marker = 0;
-	else if(s->marker > s->data->length)
-		s->marker = s->data->length;
+	else if(s->marker > length)
+		s->marker = length;
 
-	free(schars);
 	return s->marker;
 }
 
-/* moves the marker until any character other than the given character is found */
-int stri_move_while(STRING_ITERATOR *s, const char *chars, int step)
+/* moves the marker until a character not belonging to the set is found */
+int stri_move_while_charset(STRING_ITERATOR *s, const CHARSET *cs, int step)
 {
-	STRING *schars;
+	const char *data;
+	int length;
 
-	if(s == NULL) return -1;
-	schars = str(chars);
-	if(schars == NULL) return -1;
-	
-	while(s->marker < s->data->length && str_is_char_in(schars, s->data->data[s->marker]))
+	if(s == NULL || cs == NULL) return -1;
+
+	data = s->chars;
+	length = s->length;
+	/* single steps in either direction are bulk scans */
+	if(step == 1) {
+		s->marker = find_forward(data, s->marker, length, cs, FALSE);
+		return s->marker;
+	}
+	if(step == -1 && s->marker < length) {
+		s->marker = find_backward(data, 0, s->marker + 1, cs, FALSE);
+		if(s->marker < 0) s->marker = 0;
+		return s->marker;
+	}
+
+	while(s->marker >= 0 && s->marker < length && CHARSET_HAS(cs, data[s->marker]))
 		s->marker += step;
 
 	if(s->marker < 0)
 		s->marker = 0;
-	else if(s->marker > s->data->length)
-		s->marker = s->data->length;
+	else if(s->marker > length)
+		s->marker = length;
 
-	free(schars);
 	return s->marker;
 }
+
+/* moves the marker over a run of characters belonging to a set */
+STRI_SPAN stri_scan_while(STRING_ITERATOR *s, const CHARSET *cs, int direction)
+{
+	return scan(s, cs, direction, FALSE);
+}
+
+/* moves the marker over a run of characters not belonging to a set */
+STRI_SPAN stri_scan_until(STRING_ITERATOR *s, const CHARSET *cs, int direction)
+{
+	return scan(s, cs, direction, TRUE);
+}
+
+/* returns the characters of a span as a view */
+STRING_VIEW stri_span_view(const STRING_ITERATOR *s, STRI_SPAN span)
+{
+	STRING_VIEW view;
+
+	view.data = NULL;
+	view.length = 0;
+	if(s == NULL || span.start < 0 || span.start > span.end || span.end > s->length) return view;
+
+	view.data = s->chars + span.start;
+	view.length = (unsigned int)(span.end - span.start);
+	return view;
+}
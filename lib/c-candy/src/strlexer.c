@@ -0,0 +1,768 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strlexer.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <striterator.h>
+#include <strlexer.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define LB_INITIAL_NODES			64
+#define LB_INITIAL_RULES			8
+#define LB_MAX_DEPTH				256
+
+/* a piece of NFA with one entry node and one exit (epsilon) node */
+typedef struct {
+	int start;
+	int end;
+} FRAGMENT;
+
+/* <------------------ private function declarations -----------------> */
+static int new_node(LEXER_BUILDER *lb, BOOL is_char, const CHARSET *cs);
+static BOOL fragment_set(LEXER_BUILDER *lb, const CHARSET *cs, FRAGMENT *f);
+static BOOL fragment_empty(LEXER_BUILDER *lb, FRAGMENT *f);
+static BOOL add_rule(LEXER_BUILDER *lb, FRAGMENT f, int type);
+static char escaped_char(char c);
+static BOOL parse_escape(const char **p, CHARSET *cs);
+static BOOL parse_class(const char **p, CHARSET *cs);
+static BOOL parse_atom(LEXER_BUILDER *lb, const char **p, int depth, FRAGMENT *f);
+static BOOL parse_repeat(LEXER_BUILDER *lb, const char **p, int depth, FRAGMENT *f);
+static BOOL parse_sequence(LEXER_BUILDER *lb, const char **p, int depth, FRAGMENT *f);
+static BOOL parse_alternation(LEXER_BUILDER *lb, const char **p, int depth, FRAGMENT *f);
+static void closure(const LEXER_BUILDER *lb, unsigned int *set, int *stack);
+static unsigned int hash_set(const unsigned int *set, unsigned int words);
+static unsigned int* state_table(const unsigned int *hashes, unsigned int state_count, unsigned int size);
+static BOOL build_dfa(const LEXER_BUILDER *lb, LEXER *lex, const unsigned char *reps);
+static int longest_match(const LEXER *lex, const char *data, int from, int length, int *type);
+
+/* <------------------ private function definitions ------------------> */
+
+/* appends a node to the NFA and returns its index, or -1 */
+static int new_node(LEXER_BUILDER *lb, BOOL is_char, const CHARSET *cs)
+{
+	LEX_NFA_NODE *nodes, *node;
+
+	if(lb->node_count == lb->node_capacity) {
+		nodes = (LEX_NFA_NODE*)realloc(lb->nodes, lb->node_capacity * 2 * sizeof(LEX_NFA_NODE));
+		if(nodes == NULL) return -1;
+
+		lb->nodes = nodes;
+		lb->node_capacity *= 2;
+	}
+
+	node = &lb->nodes[lb->node_count];
+	if(cs != NULL) node->set = *cs;
+	else charset_clear(&node->set);
+	node->is_char = is_char;
+	node->out1 = -1;
+	node->out2 = -1;
+	node->rule = -1;
+	return (int)lb->node_count++;
+}
+
+/* builds a fragment consuming one character of a set */
+static BOOL fragment_set(LEXER_BUILDER *lb, const CHARSET *cs, FRAGMENT *f)
+{
+	f->start = new_node(lb, TRUE, cs);
+	if(f->start < 0) return FALSE;
+
+	f->end = new_node(lb, FALSE, NULL);
+	if(f->end < 0) return FALSE;
+
+	lb->nodes[f->start].out1 = f->end;
+	return TRUE;
+}
+
+/* builds a fragment consuming nothing */
+static BOOL fragment_empty(LEXER_BUILDER *lb, FRAGMENT *f)
+{
+	f->start = new_node(lb, FALSE, NULL);
+	f->end = f->start;
+	return (f->start < 0 ? FALSE : TRUE);
+}
+
+/* records a fragment as a rule producing a token type */
+static BOOL add_rule(LEXER_BUILDER *lb, FRAGMENT f, int type)
+{
+	int *starts, *types;
+
+	if(lb->rule_count == lb->rule_capacity) {
+		starts = (int*)realloc(lb->starts, lb->rule_capacity * 2 * sizeof(int));
+		if(starts == NULL) return FALSE;
+		lb->starts = starts;
+
+		types = (int*)realloc(lb->types, lb->rule_capacity * 2 * sizeof(int));
+		if(types == NULL) return FALSE;
+		lb->types = types;
+
+		lb->rule_capacity *= 2;
+	}
+
+	lb->nodes[f.end].rule = (int)lb->rule_count;
+	lb->starts[lb->rule_count] = f.start;
+	lb->types[lb->rule_count] = type;
+	++lb->rule_count;
+	return TRUE;
+}
+
+/* returns the character denoted by an escaped character */
+static char escaped_char(char c)
+{
+	switch(c)
+	{
+		case 'n': return '\n';
+		case 'r': return '\r';
+		case 't': return '\t';
+		default: return c;
+	}
+}
+
+/* parses the character after a '\' into a set */
+static BOOL parse_escape(const char **p, CHARSET *cs)
+{
+	char c;
+
+	c = **p;
+	if(c == '\0') return FALSE;
+	++*p;
+
+	charset_clear(cs);
+	switch(c)
+	{
+		case 'd': case 'D':
+			*cs = CHARSET_DIGITS;
+			break;
+
+		case 'w': case 'W':
+			*cs = CHARSET_ALPHANUMERIC;
+			charset_add(cs, "_");
+			break;
+
+		case 's': case 'S':
+			*cs = CHARSET_WHITESPACE;
+			break;
+
+		default:
+			c = escaped_char(c);
+			charset_add_range(cs, (unsigned char)c, (unsigned char)c);
+			return TRUE;
+	}
+
+	if(c == 'D' || c == 'W' || c == 'S') charset_invert(cs);
+	return TRUE;
+}
+
+/* parses a '[...]' set whose '[' has been consumed */
+static BOOL parse_class(const char **p, CHARSET *cs)
+{
+	CHARSET escape;
+	BOOL negate, first;
+	unsigned char lo, hi;
+
+	charset_clear(cs);
+	negate = FALSE;
+	if(**p == '^') {
+		negate = TRUE;
+		++*p;
+	}
+
+	/* a ']' right after the opening bracket is a member */
+	for(first = TRUE; first || **p != ']'; first = FALSE)
+	{
+		if(**p == '\0') return FALSE;
+
+		if(**p == '\\') {
+			++*p;
+			if(**p == '\0') return FALSE;
+			if(strchr("dDwWsS", **p) != NULL) {
+				parse_escape(p, &escape);
+				charset_union(cs, &escape);
+				continue;
+			}
+			lo = (unsigned char)escaped_char(*(*p)++);
+		} else {
+			lo = (unsigned char)*(*p)++;
+		}
+
+		hi = lo;
+		if((*p)[0] == '-' && (*p)[1] != ']' && (*p)[1] != '\0') {
+			++*p;
+			if(**p == '\\') {
+				++*p;
+				if(**p == '\0') return FALSE;
+				hi = (unsigned char)escaped_char(*(*p)++);
+			} else {
+				hi = (unsigned char)*(*p)++;
+			}
+			if(hi < lo) return FALSE;
+		}
+		charset_add_range(cs, lo, hi);
+	}
+
+	++*p;
+	if(negate) charset_invert(cs);
+	return TRUE;
+}
+
+/* parses a character, set, escape or group */
+static BOOL parse_atom(LEXER_BUILDER *lb, const char **p, int depth, FRAGMENT *f)
+{
+	CHARSET cs;
+	char c;
+
+	c = **p;
+	switch(c)
+	{
+		case '(':
+			if(depth >= LB_MAX_DEPTH) return FALSE;
+			++*p;
+			if(!parse_alternation(lb, p, depth + 1, f)) return FALSE;
+			if(**p != ')') return FALSE;
+			++*p;
+			return TRUE;
+
+		case '[':
+			++*p;
+			if(!parse_class(p, &cs)) return FALSE;
+			break;
+
+		case '.':
+			++*p;
+			charset_init(&cs, "\n");
+			charset_invert(&cs);
+			break;
+
+		case '\\':
+			++*p;
+			if(!parse_escape(p, &cs)) return FALSE;
+			break;
+
+		case '*': case '+': case '?': case ')': case '|': case '\0':
+			return FALSE;
+
+		default:
+			++*p;
+			charset_clear(&cs);
+			charset_add_range(&cs, (unsigned char)c, (unsigned char)c);
+			break;
+	}
+
+	return fragment_set(lb, &cs, f);
+}
+
+/* parses an atom followed by any number of '*', '+' and '?' */
+static BOOL parse_repeat(LEXER_BUILDER *lb, const char **p, int depth, FRAGMENT *f)
+{
+	int start, end;
+
+	if(!parse_atom(lb, p, depth, f)) return FALSE;
+
+	while(**p == '*' || **p == '+' || **p == '?')
+	{
+		end = new_node(lb, FALSE, NULL);
+		if(end < 0) return FALSE;
+
+		if(**p == '+') {
+			start = f->start;
+		} else {
+			start = new_node(lb, FALSE, NULL);
+			if(start < 0) return FALSE;
+			lb->nodes[start].out1 = f->start;
+			lb->nodes[start].out2 = end;
+		}
+
+		/* the exit loops back for '*' and '+', and always leads on to the new exit */
+		if(**p == '?') {
+			lb->nodes[f->end].out1 = end;
+		} else {
+			lb->nodes[f->end].out1 = f->start;
+			lb->nodes[f->end].out2 = end;
+		}
+
+		f->start = start;
+		f->end = end;
+		++*p;
+	}
+	return TRUE;
+}
+
+/* parses a sequence of repeated atoms, up to a '|', ')' or the end */
+static BOOL parse_sequence(LEXER_BUILDER *lb, const char **p, int depth, FRAGMENT *f)
+{
+	FRAGMENT next;
+	BOOL empty;
+
+	empty = TRUE;
+	while(**p != '\0' && **p != '|' && **p != ')')
+	{
+		if(!parse_repeat(lb, p, depth, &next)) return FALSE;
+
+		if(empty) {
+			*f = next;
+			empty = FALSE;
+		} else {
+			lb->nodes[f->end].out1 = next.start;
+			f->end = next.end;
+		}
+	}
+
+	if(empty) return fragment_empty(lb, f);
+	return TRUE;
+}
+
+/* parses sequences separated by '|' */
+static BOOL parse_alternation(LEXER_BUILDER *lb, const char **p, int depth, FRAGMENT *f)
+{
+	FRAGMENT next;
+	int start, end;
+
+	if(!parse_sequence(lb, p, depth, f)) return FALSE;
+
+	while(**p == '|')
+	{
+		++*p;
+		if(!parse_sequence(lb, p, depth, &next)) return FALSE;
+
+		start = new_node(lb, FALSE, NULL);
+		if(start < 0) return FALSE;
+		end = new_node(lb, FALSE, NULL);
+		if(end < 0) return FALSE;
+
+		lb->nodes[start].out1 = f->start;
+		lb->nodes[start].out2 = next.start;
+		lb->nodes[f->end].out1 = end;
+		lb->nodes[next.end].out1 = end;
+
+		f->start = start;
+		f->end = end;
+	}
+	return TRUE;
+}
+
+/* adds to a set of NFA nodes every node reachable from them without consuming a character */
+static void closure(const LEXER_BUILDER *lb, unsigned int *set, int *stack)
+{
+	const LEX_NFA_NODE *node;
+	unsigned int i, top;
+	int out[2], k;
+
+	top = 0;
+	for(i = 0; i < lb->node_count; ++i)
+		if(set[i >> 5] & (1u << (i & 31))) stack[top++] = (int)i;
+
+	while(top > 0)
+	{
+		node = &lb->nodes[stack[--top]];
+		if(node->is_char) continue;
+
+		out[0] = node->out1;
+		out[1] = node->out2;
+		for(k = 0; k < 2; ++k)
+		{
+			if(out[k] < 0 || (set[out[k] >> 5] & (1u << (out[k] & 31)))) continue;
+			set[out[k] >> 5] |= 1u << (out[k] & 31);
+			stack[top++] = out[k];
+		}
+	}
+}
+
+/* returns the FNV-1a hash of a set of NFA nodes */
+static unsigned int hash_set(const unsigned int *set, unsigned int words)
+{
+	unsigned int h, i;
+
+	h = 2166136261u;
+	for(i = 0; i < words; ++i)
+		h = (h ^ set[i]) * 16777619u;
+	return h;
+}
+
+/* builds an open-addressing table of a number of states keyed by their hashes (slots hold state + 1, 0 if empty) */
+static unsigned int* state_table(const unsigned int *hashes, unsigned int state_count, unsigned int size)
+{
+	unsigned int *table, i, slot;
+
+	table = (unsigned int*)calloc(size, sizeof(unsigned int));
+	if(table == NULL) return NULL;
+
+	for(i = 0; i < state_count; ++i)
+	{
+		for(slot = hashes[i] & (size - 1); table[slot] != 0; slot = (slot + 1) & (size - 1));
+		table[slot] = i + 1;
+	}
+	return table;
+}
+
+/* runs the subset construction, filling the transitions and accepting types of a lexer */
+static BOOL build_dfa(const LEXER_BUILDER *lb, LEXER *lex, const unsigned char *reps)
+{
+	unsigned int *sets, *hashes, *table, *next, *current, *target, words, capacity, state, c, i, j, h, bits, slot;
+	int *accept, *stack, rule, k;
+	BOOL ok;
+
+	words = (lb->node_count + 31) / 32;
+	if(words == 0) words = 1;
+	capacity = 16;
+
+	sets = (unsigned int*)calloc(capacity * words, sizeof(unsigned int));
+	hashes = (unsigned int*)malloc(capacity * sizeof(unsigned int));
+	current = (unsigned int*)malloc(2 * words * sizeof(unsigned int));
+	stack = (int*)malloc((lb->node_count + 1) * sizeof(int));
+	lex->next = (unsigned int*)malloc(capacity * lex->class_count * sizeof(unsigned int));
+	lex->accept = (int*)malloc(capacity * sizeof(int));
+	if(sets == NULL || hashes == NULL || current == NULL || stack == NULL || lex->next == NULL || lex->accept == NULL) {
+		free(sets);
+		free(hashes);
+		free(current);
+		free(stack);
+		return FALSE;
+	}
+	target = current + words;
+
+	/* state 0 is the empty set, state 1 everything reachable from the starts of the rules */
+	for(i = 0; i < lb->rule_count; ++i)
+		sets[words + (lb->starts[i] >> 5)] |= 1u << (lb->starts[i] & 31);
+	closure(lb, sets + words, stack);
+	hashes[0] = hash_set(sets, words);
+	hashes[1] = hash_set(sets + words, words);
+	lex->state_count = 2;
+
+	/* the table has twice as many slots as there is room for states, so probe sequences stay short */
+	table = state_table(hashes, lex->state_count, 2 * capacity);
+	if(table == NULL) {
+		free(sets);
+		free(hashes);
+		free(current);
+		free(stack);
+		return FALSE;
+	}
+
+	ok = TRUE;
+	for(state = 0; ok && state < lex->state_count; ++state)
+	{
+		memcpy(current, sets + state * words, words * sizeof(unsigned int));
+
+		/* a state accepts the rule added first among its accepting nodes */
+		rule = -1;
+		for(i = 0; i < words; ++i)
+		{
+			for(bits = current[i]; bits != 0; bits &= bits - 1)
+			{
+				k = lb->nodes[i * 32 + __builtin_ctz(bits)].rule;
+				if(k >= 0 && (rule < 0 || k < rule)) rule = k;
+			}
+		}
+		lex->accept[state] = (rule < 0 ? LEXER_ERROR : lb->types[rule]);
+
+		for(c = 0; ok && c < lex->class_count; ++c)
+		{
+			memset(target, 0, words * sizeof(unsigned int));
+			for(i = 0; i < words; ++i)
+			{
+				for(bits = current[i]; bits != 0; bits &= bits - 1)
+				{
+					k = (int)(i * 32 + __builtin_ctz(bits));
+					if(lb->nodes[k].is_char && CHARSET_HAS(&lb->nodes[k].set, reps[c]))
+						target[lb->nodes[k].out1 >> 5] |= 1u << (lb->nodes[k].out1 & 31);
+				}
+			}
+			closure(lb, target, stack);
+
+			h = hash_set(target, words);
+			j = lex->state_count;
+			for(slot = h & (2 * capacity - 1); table[slot] != 0; slot = (slot + 1) & (2 * capacity - 1))
+			{
+				i = table[slot] - 1;
+				if(hashes[i] == h && memcmp(sets + i * words, target, words * sizeof(unsigned int)) == 0) {
+					j = i;
+					break;
+				}
+			}
+
+			if(j == lex->state_count) {
+				if(j == LEXER_MAX_STATES) {
+					ok = FALSE;
+					break;
+				}
+
+				if(j == capacity) {
+					capacity *= 2;
+					if((next = (unsigned int*)realloc(sets, capacity * words * sizeof(unsigned int))) != NULL) sets = next;
+					else ok = FALSE;
+					if((next = (unsigned int*)realloc(hashes, capacity * sizeof(unsigned int))) != NULL) hashes = next;
+					else ok = FALSE;
+					if((next = (unsigned int*)realloc(lex->next, capacity * lex->class_count * sizeof(unsigned int))) != NULL) lex->next = next;
+					else ok = FALSE;
+					if((accept = (int*)realloc(lex->accept, capacity * sizeof(int))) != NULL) lex->accept = accept;
+					else ok = FALSE;
+					if(!ok) break;
+
+					free(table);
+					table = state_table(hashes, lex->state_count, 2 * capacity);
+					if(table == NULL) {
+						ok = FALSE;
+						break;
+					}
+					for(slot = h & (2 * capacity - 1); table[slot] != 0; slot = (slot + 1) & (2 * capacity - 1));
+				}
+
+				memcpy(sets + j * words, target, words * sizeof(unsigned int));
+				hashes[j] = h;
+				table[slot] = j + 1;
+				++lex->state_count;
+			}
+			lex->next[state * lex->class_count + c] = j;
+		}
+	}
+
+	free(sets);
+	free(hashes);
+	free(table);
+	free(current);
+	free(stack);
+	return ok;
+}
+
+/* returns the end of the longest match at a position (and its type), or -1 */
+static int longest_match(const LEXER *lex, const char *data, int from, int length, int *type)
+{
+	const unsigned int *next;
+	const int *accept;
+	unsigned int state, classes;
+	int i, last;
+
+	next = lex->next;
+	accept = lex->accept;
+	classes = lex->class_count;
+
+	last = -1;
+	state = 1;
+	for(i = from; i < length; ++i)
+	{
+		state = next[state * classes + lex->classes[(unsigned char)data[i]]];
+		if(state == 0) break;
+		if(accept[state] != LEXER_ERROR) {
+			last = i + 1;
+			*type = accept[state];
+		}
+	}
+	return last;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for a lexer builder */
+void lb_dump(LEXER_BUILDER *lb)
+{
+	if(lb == NULL) return;
+
+	free(lb->nodes);
+	free(lb->starts);
+	free(lb->types);
+	free(lb);
+}
+
+/* creates a lexer builder with no rules */
+LEXER_BUILDER* lexer_builder()
+{
+	LEXER_BUILDER *lb;
+
+	lb = (LEXER_BUILDER*)malloc(sizeof(LEXER_BUILDER));
+	if(lb == NULL) return NULL;
+
+	lb->nodes = (LEX_NFA_NODE*)malloc(LB_INITIAL_NODES * sizeof(LEX_NFA_NODE));
+	lb->starts = (int*)malloc(LB_INITIAL_RULES * sizeof(int));
+	lb->types = (int*)malloc(LB_INITIAL_RULES * sizeof(int));
+	if(lb->nodes == NULL || lb->starts == NULL || lb->types == NULL) {
+		lb_dump(lb);
+		return NULL;
+	}
+
+	lb->node_count = 0;
+	lb->node_capacity = LB_INITIAL_NODES;
+	lb->rule_count = 0;
+	lb->rule_capacity = LB_INITIAL_RULES;
+	return lb;
+}
+
+/* adds a rule matching a fixed string */
+BOOL lb_add_literal(LEXER_BUILDER *lb, const char *literal, int type)
+{
+	FRAGMENT f, next;
+	CHARSET cs;
+	unsigned int mark;
+	const char *p;
+
+	if(lb == NULL || literal == NULL || literal[0] == '\0' || (type < 0 && type != LEXER_SKIP)) return FALSE;
+
+	mark = lb->node_count;
+	for(p = literal; *p != '\0'; ++p)
+	{
+		charset_clear(&cs);
+		charset_add_range(&cs, (unsigned char)*p, (unsigned char)*p);
+		if(!fragment_set(lb, &cs, &next)) break;
+
+		if(p == literal) {
+			f = next;
+		} else {
+			lb->nodes[f.end].out1 = next.start;
+			f.end = next.end;
+		}
+	}
+
+	if(*p != '\0' || !add_rule(lb, f, type)) {
+		lb->node_count = mark;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* adds a rule matching one character of a set, or a run of them */
+BOOL lb_add_charset(LEXER_BUILDER *lb, const CHARSET *cs, BOOL repeat, int type)
+{
+	FRAGMENT f;
+	unsigned int mark;
+
+	if(lb == NULL || cs == NULL || (type < 0 && type != LEXER_SKIP)) return FALSE;
+
+	mark = lb->node_count;
+	if(fragment_set(lb, cs, &f)) {
+		/* a run loops from the exit back to the character node */
+		if(repeat) lb->nodes[f.end].out2 = f.start;
+		if(add_rule(lb, f, type)) return TRUE;
+	}
+
+	lb->node_count = mark;
+	return FALSE;
+}
+
+/* adds a rule matching a simple regular expression */
+BOOL lb_add_regex(LEXER_BUILDER *lb, const char *pattern, int type)
+{
+	FRAGMENT f;
+	unsigned int mark;
+	const char *p;
+
+	if(lb == NULL || pattern == NULL || (type < 0 && type != LEXER_SKIP)) return FALSE;
+
+	mark = lb->node_count;
+	p = pattern;
+	if(parse_alternation(lb, &p, 0, &f) && *p == '\0' && add_rule(lb, f, type)) return TRUE;
+
+	lb->node_count = mark;
+	return FALSE;
+}
+
+/* compiles the rules of a builder into a lexer */
+LEXER* lb_compile(const LEXER_BUILDER *lb)
+{
+	LEXER *lex;
+	unsigned char reps[256];
+	int remap[512];
+	unsigned int i, b, count;
+
+	if(lb == NULL) return NULL;
+
+	lex = (LEXER*)malloc(sizeof(LEXER));
+	if(lex == NULL) return NULL;
+
+	/* bytes which every character node treats alike share a class (and a column of the table) */
+	memset(lex->classes, 0, sizeof(lex->classes));
+	lex->class_count = 1;
+	for(i = 0; i < lb->node_count; ++i)
+	{
+		if(!lb->nodes[i].is_char) continue;
+
+		for(b = 0; b < 2 * lex->class_count; ++b) remap[b] = -1;
+		count = 0;
+		for(b = 0; b < 256; ++b)
+		{
+			if(remap[lex->classes[b] * 2 + CHARSET_HAS(&lb->nodes[i].set, b)] < 0)
+				remap[lex->classes[b] * 2 + CHARSET_HAS(&lb->nodes[i].set, b)] = (int)count++;
+			lex->classes[b] = (unsigned char)remap[lex->classes[b] * 2 + CHARSET_HAS(&lb->nodes[i].set, b)];
+		}
+		lex->class_count = count;
+	}
+
+	for(b = 256; b > 0; --b)
+		reps[lex->classes[b - 1]] = (unsigned char)(b - 1);
+
+	lex->next = NULL;
+	lex->accept = NULL;
+	if(!build_dfa(lb, lex, reps)) {
+		lexer_dump(lex);
+		return NULL;
+	}
+	return lex;
+}
+
+/* frees memory allocated for a lexer */
+void lexer_dump(LEXER *lex)
+{
+	if(lex == NULL) return;
+
+	free(lex->next);
+	free(lex->accept);
+	free(lex);
+}
+
+/* reads the next token at the marker of an iterator */
+BOOL lexer_next(const LEXER *lex, STRING_ITERATOR *s, LEX_TOKEN *token)
+{
+	int end, type;
+
+	if(lex == NULL || s == NULL || token == NULL) return FALSE;
+
+	while(s->marker < s->length)
+	{
+		end = longest_match(lex, s->chars, s->marker, s->length, &type);
+		if(end < 0) {
+			type = LEXER_ERROR;
+			end = s->marker + 1;
+		} else if(type == LEXER_SKIP) {
+			s->marker = end;
+			continue;
+		}
+
+		token->type = type;
+		token->start = s->marker;
+		token->end = end;
+		s->marker = end;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/* reads tokens at the marker of an iterator into a buffer */
+unsigned int lexer_run(const LEXER *lex, STRING_ITERATOR *s, LEX_TOKEN *tokens, unsigned int capacity)
+{
+	unsigned int count;
+
+	if(tokens == NULL) return 0;
+
+	for(count = 0; count < capacity; ++count)
+		if(!lexer_next(lex, s, &tokens[count])) break;
+
+	return count;
+}
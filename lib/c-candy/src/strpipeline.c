@@ -0,0 +1,428 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strpipeline.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <strpipeline.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define STRP_INITIAL_CAPACITY			4
+#define STRP_STACK_STAGES				16
+#define STRP_INLINE_PENDING				32
+#define DROP							-1
+
+/* the state of a stage while a string runs through the pipeline */
+typedef struct {
+	BOOL started;
+	BOOL in_run;
+	char *pending;
+	unsigned int pending_length;
+	unsigned int pending_capacity;
+	char inline_pending[STRP_INLINE_PENDING];
+} STAGE_STATE;
+
+/* one run of a string through the pipeline */
+typedef struct {
+	const STR_PIPELINE *pipe;
+	STAGE_STATE *states;
+	STRING *out;
+	BOOL failed;
+} RUN;
+
+/* <------------------ private function declarations -----------------> */
+static STR_PIPELINE_STAGE* add_stage(STR_PIPELINE *pipe, int kind);
+static BOOL add_map(STR_PIPELINE *pipe, const short *map);
+static BOOL add_set_stage(STR_PIPELINE *pipe, int kind, const CHARSET *cs);
+static void push(RUN *run, unsigned int k, unsigned char c);
+static BOOL hold(STAGE_STATE *state, unsigned char c);
+
+/* <------------------ private function definitions ------------------> */
+
+/* appends an uninitialized stage */
+static STR_PIPELINE_STAGE* add_stage(STR_PIPELINE *pipe, int kind)
+{
+	STR_PIPELINE_STAGE *temp;
+
+	if(pipe->count == pipe->capacity) {
+		temp = (STR_PIPELINE_STAGE*)realloc(pipe->stages, pipe->capacity * 2 * sizeof(STR_PIPELINE_STAGE));
+		if(temp == NULL) return NULL;
+
+		pipe->stages = temp;
+		pipe->capacity *= 2;
+	}
+
+	temp = &pipe->stages[pipe->count++];
+	temp->kind = kind;
+	return temp;
+}
+
+/* adds a byte-to-byte stage, composing it with the previous stage if that is one too */
+static BOOL add_map(STR_PIPELINE *pipe, const short *map)
+{
+	STR_PIPELINE_STAGE *stage;
+	int i;
+
+	if(pipe->count > 0 && pipe->stages[pipe->count - 1].kind == STRP_STAGE_MAP) {
+		stage = &pipe->stages[pipe->count - 1];
+		for(i = 0; i < 256; ++i)
+			if(stage->map[i] != DROP) stage->map[i] = map[stage->map[i]];
+
+		return TRUE;
+	}
+
+	stage = add_stage(pipe, STRP_STAGE_MAP);
+	if(stage == NULL) return FALSE;
+
+	memcpy(stage->map, map, sizeof(stage->map));
+	return TRUE;
+}
+
+/* adds a stage driven by a character set */
+static BOOL add_set_stage(STR_PIPELINE *pipe, int kind, const CHARSET *cs)
+{
+	STR_PIPELINE_STAGE *stage;
+
+	if(pipe == NULL) return FALSE;
+
+	stage = add_stage(pipe, kind);
+	if(stage == NULL) return FALSE;
+
+	stage->set = (cs == NULL ? CHARSET_WHITESPACE : *cs);
+	return TRUE;
+}
+
+/* holds back a character of a right-strip stage, moving the held run to the heap once it outgrows the state */
+static BOOL hold(STAGE_STATE *state, unsigned char c)
+{
+	char *temp;
+
+	if(state->pending_length == state->pending_capacity) {
+		if(state->pending == state->inline_pending) {
+			temp = (char*)malloc(state->pending_capacity * 2);
+			if(temp != NULL) memcpy(temp, state->pending, state->pending_length);
+		} else {
+			temp = (char*)realloc(state->pending, state->pending_capacity * 2);
+		}
+		if(temp == NULL) return FALSE;
+
+		state->pending = temp;
+		state->pending_capacity *= 2;
+	}
+
+	state->pending[state->pending_length++] = (char)c;
+	return TRUE;
+}
+
+/* feeds a character to stage k and the stages after it, writing what comes out to the output */
+static void push(RUN *run, unsigned int k, unsigned char c)
+{
+	const STR_PIPELINE_STAGE *stage;
+	STAGE_STATE *state;
+	STRING *out;
+	unsigned int i;
+
+	for(; k < run->pipe->count; ++k)
+	{
+		stage = &run->pipe->stages[k];
+		state = &run->states[k];
+
+		switch(stage->kind)
+		{
+			case STRP_STAGE_MAP:
+				if(stage->map[c] == DROP) return;
+				c = (unsigned char)stage->map[c];
+				break;
+
+			case STRP_STAGE_LSTRIP:
+				if(!state->started) {
+					if(CHARSET_HAS(&stage->set, c)) return;
+					state->started = TRUE;
+				}
+				break;
+
+			case STRP_STAGE_RSTRIP:
+				/* a run of strippable characters is held back until something follows it, and dropped at the end */
+				if(CHARSET_HAS(&stage->set, c)) {
+					if(!hold(state, c)) run->failed = TRUE;
+					return;
+				}
+				for(i = 0; i < state->pending_length; ++i) push(run, k + 1, (unsigned char)state->pending[i]);
+				state->pending_length = 0;
+				break;
+
+			case STRP_STAGE_COLLAPSE:
+				if(!CHARSET_HAS(&stage->set, c)) {
+					state->in_run = FALSE;
+				} else {
+					if(state->in_run) return;
+					state->in_run = TRUE;
+					c = (unsigned char)stage->replacement;
+				}
+				break;
+
+			case STRP_STAGE_EXPAND_TABS:
+				if(c == '\t') {
+					for(i = 0; i < stage->tab_size; ++i) push(run, k + 1, ' ');
+					return;
+				}
+				break;
+		}
+	}
+
+	/* only tab expansion can outrun the space reserved up front, so the buffer is doubled when full */
+	out = run->out;
+	if(out->length == out->capacity && (out->capacity >= UINT_MAX / 2 || !str_reserve(out, out->capacity * 2 + 16))) {
+		run->failed = TRUE;
+		return;
+	}
+	out->data[out->length++] = (char)c;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* frees memory allocated for the pipeline */
+void strp_dump(STR_PIPELINE *pipe)
+{
+	if(pipe == NULL) return;
+
+	free(pipe->stages);
+	free(pipe);
+}
+
+/* creates an empty pipeline */
+STR_PIPELINE* str_pipeline()
+{
+	STR_PIPELINE *pipe;
+
+	pipe = (STR_PIPELINE*)malloc(sizeof(STR_PIPELINE));
+	if(pipe == NULL) return NULL;
+
+	pipe->stages = (STR_PIPELINE_STAGE*)malloc(STRP_INITIAL_CAPACITY * sizeof(STR_PIPELINE_STAGE));
+	if(pipe->stages == NULL) {
+		free(pipe);
+		return NULL;
+	}
+
+	pipe->count = 0;
+	pipe->capacity = STRP_INITIAL_CAPACITY;
+	return pipe;
+}
+
+/* adds a stage removing characters from both ends */
+BOOL strp_strip(STR_PIPELINE *pipe, const CHARSET *cs)
+{
+	return(strp_lstrip(pipe, cs) && strp_rstrip(pipe, cs) ? TRUE : FALSE);
+}
+
+/* adds a stage removing characters from the start */
+BOOL strp_lstrip(STR_PIPELINE *pipe, const CHARSET *cs)
+{
+	return add_set_stage(pipe, STRP_STAGE_LSTRIP, cs);
+}
+
+/* adds a stage removing characters from the end */
+BOOL strp_rstrip(STR_PIPELINE *pipe, const CHARSET *cs)
+{
+	return add_set_stage(pipe, STRP_STAGE_RSTRIP, cs);
+}
+
+/* adds a stage converting uppercase letters to lowercase */
+BOOL strp_to_lower(STR_PIPELINE *pipe)
+{
+	short map[256];
+	int i;
+
+	if(pipe == NULL) return FALSE;
+
+	for(i = 0; i < 256; ++i) map[i] = (i >= 'A' && i <= 'Z' ? i + 32 : i);
+	return add_map(pipe, map);
+}
+
+/* adds a stage converting lowercase letters to uppercase */
+BOOL strp_to_upper(STR_PIPELINE *pipe)
+{
+	short map[256];
+	int i;
+
+	if(pipe == NULL) return FALSE;
+
+	for(i = 0; i < 256; ++i) map[i] = (i >= 'a' && i <= 'z' ? i - 32 : i);
+	return add_map(pipe, map);
+}
+
+/* adds a stage swapping the case of letters */
+BOOL strp_swap_case(STR_PIPELINE *pipe)
+{
+	short map[256];
+	int i;
+
+	if(pipe == NULL) return FALSE;
+
+	for(i = 0; i < 256; ++i)
+	{
+		if(i >= 'A' && i <= 'Z')
+			map[i] = i + 32;
+		else if(i >= 'a' && i <= 'z')
+			map[i] = i - 32;
+		else
+			map[i] = i;
+	}
+	return add_map(pipe, map);
+}
+
+/* adds a stage replacing one character with another */
+BOOL strp_replace_char(STR_PIPELINE *pipe, char find, char replace_with)
+{
+	short map[256];
+	int i;
+
+	if(pipe == NULL) return FALSE;
+
+	for(i = 0; i < 256; ++i) map[i] = i;
+	map[(unsigned char)find] = (unsigned char)replace_with;
+	return add_map(pipe, map);
+}
+
+/* adds a stage dropping characters not in a set */
+BOOL strp_keep(STR_PIPELINE *pipe, const CHARSET *cs)
+{
+	short map[256];
+	int i;
+
+	if(pipe == NULL || cs == NULL) return FALSE;
+
+	for(i = 0; i < 256; ++i) map[i] = (CHARSET_HAS(cs, i) ? i : DROP);
+	return add_map(pipe, map);
+}
+
+/* adds a stage dropping characters in a set */
+BOOL strp_remove(STR_PIPELINE *pipe, const CHARSET *cs)
+{
+	short map[256];
+	int i;
+
+	if(pipe == NULL || cs == NULL) return FALSE;
+
+	for(i = 0; i < 256; ++i) map[i] = (CHARSET_HAS(cs, i) ? DROP : i);
+	return add_map(pipe, map);
+}
+
+/* adds a stage replacing tabs with spaces */
+BOOL strp_expand_tabs(STR_PIPELINE *pipe, unsigned int tab_size)
+{
+	STR_PIPELINE_STAGE *stage;
+
+	if(pipe == NULL) return FALSE;
+
+	stage = add_stage(pipe, STRP_STAGE_EXPAND_TABS);
+	if(stage == NULL) return FALSE;
+
+	stage->tab_size = tab_size;
+	return TRUE;
+}
+
+/* adds a stage collapsing runs of characters from a set */
+BOOL strp_collapse(STR_PIPELINE *pipe, const CHARSET *cs, char replacement)
+{
+	if(!add_set_stage(pipe, STRP_STAGE_COLLAPSE, cs)) return FALSE;
+
+	pipe->stages[pipe->count - 1].replacement = replacement;
+	return TRUE;
+}
+
+/* runs a string through the pipeline */
+STRING* strp_run(const STR_PIPELINE *pipe, const STRING *sobj)
+{
+	STRING *sres;
+
+	sres = str_blank();
+	if(sres == NULL) return NULL;
+
+	if(!strp_run_append(pipe, sres, sobj)) {
+		str_dump(sres);
+		return NULL;
+	}
+	return sres;
+}
+
+/* runs a string through the pipeline, appending the result */
+BOOL strp_run_append(const STR_PIPELINE *pipe, STRING *out, const STRING *sobj)
+{
+	STAGE_STATE stack_states[STRP_STACK_STAGES];
+	const short *map;
+	RUN run;
+	unsigned int i, length;
+	char *dst;
+
+	if(pipe == NULL || out == NULL || sobj == NULL || out == sobj) return FALSE;
+	if(sobj->length > UINT_MAX / 2 - out->length) return FALSE;
+
+	/* only tab expansion makes the output longer than the input, so this is usually the only allocation */
+	if(!str_reserve(out, out->length + sobj->length)) return FALSE;
+
+	/* a single fused byte-to-byte stage needs no per-stage dispatch */
+	if(pipe->count == 1 && pipe->stages[0].kind == STRP_STAGE_MAP) {
+		map = pipe->stages[0].map;
+		dst = out->data + out->length;
+		for(i = 0; i < sobj->length; ++i)
+		{
+			if(map[(unsigned char)sobj->data[i]] != DROP) *dst++ = (char)map[(unsigned char)sobj->data[i]];
+		}
+		out->length = dst - out->data;
+		out->data[out->length] = '\0';
+		return TRUE;
+	}
+
+	run.pipe = pipe;
+	run.out = out;
+	run.failed = FALSE;
+	run.states = stack_states;
+	if(pipe->count > STRP_STACK_STAGES) {
+		run.states = (STAGE_STATE*)malloc(pipe->count * sizeof(STAGE_STATE));
+		if(run.states == NULL) return FALSE;
+	}
+	for(i = 0; i < pipe->count; ++i)
+	{
+		run.states[i].started = FALSE;
+		run.states[i].in_run = FALSE;
+		run.states[i].pending = run.states[i].inline_pending;
+		run.states[i].pending_length = 0;
+		run.states[i].pending_capacity = STRP_INLINE_PENDING;
+	}
+
+	length = out->length;
+	for(i = 0; i < sobj->length && !run.failed; ++i) push(&run, 0, (unsigned char)sobj->data[i]);
+
+	/* the runs still held by right-strip stages are trailing, so they are dropped */
+	for(i = 0; i < pipe->count; ++i)
+	{
+		if(run.states[i].pending != run.states[i].inline_pending) free(run.states[i].pending);
+	}
+	if(run.states != stack_states) free(run.states);
+
+	if(run.failed) out->length = length;
+	out->data[out->length] = '\0';
+	return(run.failed ? FALSE : TRUE);
+}
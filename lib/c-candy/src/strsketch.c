@@ -0,0 +1,552 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strsketch.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <constants.h>
+#include <charset.h>
+#include <str.h>
+#include <strsketch.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define ROLLING_BASE				0x100000001b3ULL
+#define FNV_OFFSET					0xcbf29ce484222325ULL
+#define NO_ENTRY					UINT_MAX
+#define LSH_INITIAL_CAPACITY		64
+
+/* a band key together with the id it came from */
+typedef struct {
+	unsigned long long key;
+	unsigned int id;
+} KEYED_ID;
+
+/* <------------------ private function declarations -----------------> */
+static unsigned long long mix64(unsigned long long x);
+static unsigned long long splitmix64(unsigned long long seed);
+static unsigned long long word_hash(const char *s, unsigned int n);
+static unsigned long long band_key(const unsigned long long *values, unsigned int band, unsigned int rows);
+static int compare_ull(const void *p1, const void *p2);
+static int compare_keyed(const void *p1, const void *p2);
+static BOOL push_ull(unsigned long long **array, unsigned int *count, unsigned int *capacity, unsigned long long value);
+static BOOL grow_entries(LSH_INDEX *lsh);
+static BOOL rehash(LSH_BAND *band, unsigned int count);
+
+/* <------------------ private function definitions ------------------> */
+
+/* scrambles the bits of a 64-bit value (the finalizer of MurmurHash3) */
+static unsigned long long mix64(unsigned long long x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+/* derives a pseudo-random 64-bit value from a seed */
+static unsigned long long splitmix64(unsigned long long seed)
+{
+	seed += 0x9e3779b97f4a7c15ULL;
+	seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	seed = (seed ^ (seed >> 27)) * 0x94d049bb133111ebULL;
+	return seed ^ (seed >> 31);
+}
+
+/* hashes a word (64-bit FNV-1a) */
+static unsigned long long word_hash(const char *s, unsigned int n)
+{
+	unsigned long long h;
+	unsigned int i;
+
+	h = FNV_OFFSET;
+	for(i = 0; i < n; ++i)
+	{
+		h ^= (unsigned char)s[i];
+		h *= 0x100000001b3ULL;
+	}
+	return mix64(h);
+}
+
+/* combines the sketch values of one band into a single key */
+static unsigned long long band_key(const unsigned long long *values, unsigned int band, unsigned int rows)
+{
+	unsigned long long key;
+	unsigned int i;
+
+	key = splitmix64(band);
+	for(i = 0; i < rows; ++i) key = mix64(key ^ values[band * rows + i]) + i;
+	return key;
+}
+
+/* orders 64-bit values */
+static int compare_ull(const void *p1, const void *p2)
+{
+	unsigned long long a, b;
+
+	a = *(const unsigned long long*)p1;
+	b = *(const unsigned long long*)p2;
+	return(a < b ? -1 : (a > b ? 1 : 0));
+}
+
+/* orders keyed ids by key */
+static int compare_keyed(const void *p1, const void *p2)
+{
+	return compare_ull(&((const KEYED_ID*)p1)->key, &((const KEYED_ID*)p2)->key);
+}
+
+/* appends a value to a growable array */
+static BOOL push_ull(unsigned long long **array, unsigned int *count, unsigned int *capacity, unsigned long long value)
+{
+	unsigned long long *temp;
+
+	if(*count == *capacity) {
+		*capacity = (*capacity == 0 ? 64 : *capacity * 2);
+		temp = (unsigned long long*)realloc(*array, *capacity * sizeof(unsigned long long));
+		if(temp == NULL) return FALSE;
+		*array = temp;
+	}
+
+	(*array)[(*count)++] = value;
+	return TRUE;
+}
+
+/* doubles the number of entries every band can hold */
+static BOOL grow_entries(LSH_INDEX *lsh)
+{
+	LSH_BAND *band;
+	void *keys, *ids, *next;
+	unsigned int i, capacity;
+
+	capacity = lsh->capacity * 2;
+	for(i = 0; i < lsh->band_count; ++i)
+	{
+		band = &lsh->bands[i];
+
+		keys = realloc(band->keys, capacity * sizeof(unsigned long long));
+		if(keys != NULL) band->keys = (unsigned long long*)keys;
+		ids = realloc(band->ids, capacity * sizeof(unsigned int));
+		if(ids != NULL) band->ids = (unsigned int*)ids;
+		next = realloc(band->next, capacity * sizeof(unsigned int));
+		if(next != NULL) band->next = (unsigned int*)next;
+
+		if(keys == NULL || ids == NULL || next == NULL) return FALSE;
+	}
+
+	lsh->capacity = capacity;
+	return TRUE;
+}
+
+/* doubles the number of buckets of a band and relinks its entries */
+static BOOL rehash(LSH_BAND *band, unsigned int count)
+{
+	unsigned int *heads;
+	unsigned int i, size, slot;
+
+	size = (band->mask + 1) * 2;
+	heads = (unsigned int*)malloc(size * sizeof(unsigned int));
+	if(heads == NULL) return FALSE;
+
+	for(i = 0; i < size; ++i) heads[i] = NO_ENTRY;
+	for(i = 0; i < count; ++i)
+	{
+		slot = (unsigned int)band->keys[i] & (size - 1);
+		band->next[i] = heads[slot];
+		heads[slot] = i;
+	}
+
+	free(band->heads);
+	band->heads = heads;
+	band->mask = size - 1;
+	return TRUE;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* computes a hash of every shingle of a string */
+int str_shingle_hashes(const STRING *sobj, unsigned int shingle_size, BOOL words, unsigned long long **hashes)
+{
+	unsigned long long *result, *word_hashes, h, top;
+	unsigned int i, n, count, capacity, start;
+
+	if(hashes != NULL) *hashes = NULL;
+	if(sobj == NULL || hashes == NULL || shingle_size == 0) return -1;
+
+	/* the units being shingled: characters, or the hashes of the words */
+	word_hashes = NULL;
+	if(words) {
+		n = capacity = 0;
+		for(i = 0; i < sobj->length; )
+		{
+			while(i < sobj->length && CHARSET_HAS(&CHARSET_WHITESPACE, sobj->data[i])) ++i;
+			if(i >= sobj->length) break;
+
+			start = i;
+			while(i < sobj->length && !CHARSET_HAS(&CHARSET_WHITESPACE, sobj->data[i])) ++i;
+			if(!push_ull(&word_hashes, &n, &capacity, word_hash(sobj->data + start, i - start))) {
+				free(word_hashes);
+				return -1;
+			}
+		}
+	} else {
+		n = sobj->length;
+	}
+
+	if(n == 0) return 0;
+	if(shingle_size > n) shingle_size = n;
+	count = n - shingle_size + 1;
+
+	result = (unsigned long long*)malloc(count * sizeof(unsigned long long));
+	if(result == NULL) {
+		free(word_hashes);
+		return -1;
+	}
+
+	/* polynomial rolling hash modulo 2^64, finished with a bit mixer */
+	top = 1;
+	for(i = 1; i < shingle_size; ++i) top *= ROLLING_BASE;
+
+	h = 0;
+	for(i = 0; i < n; ++i)
+	{
+		if(i >= shingle_size) h -= top * (words ? word_hashes[i - shingle_size] : (unsigned char)sobj->data[i - shingle_size] + 1ULL);
+		h = h * ROLLING_BASE + (words ? word_hashes[i] : (unsigned char)sobj->data[i] + 1ULL);
+		if(i + 1 >= shingle_size) result[i + 1 - shingle_size] = mix64(h);
+	}
+
+	free(word_hashes);
+	*hashes = result;
+	return (int)count;
+}
+
+/* frees memory allocated for a MinHash sketch */
+void minhash_dump(MINHASH *mh)
+{
+	if(mh == NULL) return;
+
+	free(mh->values);
+	free(mh);
+}
+
+/* computes the MinHash sketch of a string */
+MINHASH* minhash(const STRING *sobj, unsigned int size, unsigned int shingle_size, BOOL words)
+{
+	MINHASH *mh;
+	unsigned long long *shingles, *a, *b, v;
+	unsigned int i, j;
+	int count;
+
+	if(size == 0) return NULL;
+
+	count = str_shingle_hashes(sobj, shingle_size, words, &shingles);
+	if(count < 0) return NULL;
+
+	mh = (MINHASH*)malloc(sizeof(MINHASH));
+	a = (unsigned long long*)malloc(2 * size * sizeof(unsigned long long));
+	if(mh == NULL || a == NULL) {
+		free(mh);
+		free(a);
+		free(shingles);
+		return NULL;
+	}
+
+	mh->size = size;
+	mh->values = (unsigned long long*)malloc(size * sizeof(unsigned long long));
+	if(mh->values == NULL) {
+		free(mh);
+		free(a);
+		free(shingles);
+		return NULL;
+	}
+
+	/* hash function i is x -> a[i] * x + b[i] with fixed odd multipliers, so sketches are comparable across calls */
+	b = a + size;
+	for(i = 0; i < size; ++i)
+	{
+		a[i] = splitmix64(2 * (unsigned long long)i) | 1;
+		b[i] = splitmix64(2 * (unsigned long long)i + 1);
+		mh->values[i] = ~0ULL;
+	}
+
+	for(j = 0; j < (unsigned int)count; ++j)
+	{
+		for(i = 0; i < size; ++i)
+		{
+			v = a[i] * shingles[j] + b[i];
+			if(v < mh->values[i]) mh->values[i] = v;
+		}
+	}
+
+	free(a);
+	free(shingles);
+	return mh;
+}
+
+/* estimates the Jaccard similarity of two strings from their sketches */
+double minhash_similarity(const MINHASH *mh1, const MINHASH *mh2)
+{
+	unsigned int i, equal;
+
+	if(mh1 == NULL || mh2 == NULL || mh1->size != mh2->size) return -1.0;
+
+	equal = 0;
+	for(i = 0; i < mh1->size; ++i)
+		if(mh1->values[i] == mh2->values[i]) ++equal;
+
+	return (double)equal / mh1->size;
+}
+
+/* computes the SimHash fingerprint of a string */
+unsigned long long str_simhash(const STRING *sobj, unsigned int shingle_size, BOOL words)
+{
+	unsigned long long *shingles, result;
+	int weights[64];
+	int i, count, bit;
+
+	count = str_shingle_hashes(sobj, shingle_size, words, &shingles);
+	if(count <= 0) return 0;
+
+	/* every shingle votes on every bit */
+	for(bit = 0; bit < 64; ++bit) weights[bit] = 0;
+	for(i = 0; i < count; ++i)
+	{
+		for(bit = 0; bit < 64; ++bit) weights[bit] += ((shingles[i] >> bit) & 1 ? 1 : -1);
+	}
+
+	result = 0;
+	for(bit = 0; bit < 64; ++bit)
+		if(weights[bit] > 0) result |= 1ULL << bit;
+
+	free(shingles);
+	return result;
+}
+
+/* returns the number of bits in which two fingerprints differ */
+int simhash_distance(unsigned long long h1, unsigned long long h2)
+{
+	return __builtin_popcountll(h1 ^ h2);
+}
+
+/* frees memory allocated for an LSH index */
+void lsh_dump(LSH_INDEX *lsh)
+{
+	unsigned int i;
+
+	if(lsh == NULL) return;
+
+	if(lsh->bands != NULL) {
+		for(i = 0; i < lsh->band_count; ++i)
+		{
+			free(lsh->bands[i].keys);
+			free(lsh->bands[i].ids);
+			free(lsh->bands[i].next);
+			free(lsh->bands[i].heads);
+		}
+		free(lsh->bands);
+	}
+	free(lsh);
+}
+
+/* creates an empty LSH banding index */
+LSH_INDEX* lsh_index(unsigned int bands, unsigned int rows)
+{
+	LSH_INDEX *lsh;
+	LSH_BAND *band;
+	unsigned int i, j;
+
+	if(bands == 0 || rows == 0) return NULL;
+
+	lsh = (LSH_INDEX*)malloc(sizeof(LSH_INDEX));
+	if(lsh == NULL) return NULL;
+
+	lsh->band_count = bands;
+	lsh->rows = rows;
+	lsh->count = 0;
+	lsh->capacity = LSH_INITIAL_CAPACITY;
+	lsh->bands = (LSH_BAND*)calloc(bands, sizeof(LSH_BAND));
+	if(lsh->bands == NULL) {
+		free(lsh);
+		return NULL;
+	}
+
+	for(i = 0; i < bands; ++i)
+	{
+		band = &lsh->bands[i];
+		band->keys = (unsigned long long*)malloc(LSH_INITIAL_CAPACITY * sizeof(unsigned long long));
+		band->ids = (unsigned int*)malloc(LSH_INITIAL_CAPACITY * sizeof(unsigned int));
+		band->next = (unsigned int*)malloc(LSH_INITIAL_CAPACITY * sizeof(unsigned int));
+		band->heads = (unsigned int*)malloc(LSH_INITIAL_CAPACITY * sizeof(unsigned int));
+		if(band->keys == NULL || band->ids == NULL || band->next == NULL || band->heads == NULL) {
+			lsh_dump(lsh);
+			return NULL;
+		}
+
+		band->mask = LSH_INITIAL_CAPACITY - 1;
+		for(j = 0; j < LSH_INITIAL_CAPACITY; ++j) band->heads[j] = NO_ENTRY;
+	}
+
+	return lsh;
+}
+
+/* adds a sketch to the index */
+BOOL lsh_add(LSH_INDEX *lsh, const MINHASH *mh, unsigned int id)
+{
+	LSH_BAND *band;
+	unsigned int i, slot;
+
+	if(lsh == NULL || mh == NULL || mh->size / lsh->rows < lsh->band_count) return FALSE;
+	if(lsh->count == lsh->capacity && !grow_entries(lsh)) return FALSE;
+
+	for(i = 0; i < lsh->band_count; ++i)
+	{
+		band = &lsh->bands[i];
+		if(lsh->count > band->mask && !rehash(band, lsh->count)) return FALSE;
+	}
+
+	for(i = 0; i < lsh->band_count; ++i)
+	{
+		band = &lsh->bands[i];
+		band->keys[lsh->count] = band_key(mh->values, i, lsh->rows);
+		band->ids[lsh->count] = id;
+
+		slot = (unsigned int)band->keys[lsh->count] & band->mask;
+		band->next[lsh->count] = band->heads[slot];
+		band->heads[slot] = lsh->count;
+	}
+
+	++lsh->count;
+	return TRUE;
+}
+
+/* finds the ids of the sketches sharing a band with a sketch */
+int lsh_query(const LSH_INDEX *lsh, const MINHASH *mh, unsigned int **ids)
+{
+	const LSH_BAND *band;
+	unsigned long long *found, key;
+	unsigned int i, j, entry, count, capacity, unique;
+
+	if(ids != NULL) *ids = NULL;
+	if(lsh == NULL || mh == NULL || ids == NULL || mh->size / lsh->rows < lsh->band_count) return -1;
+
+	found = NULL;
+	count = capacity = 0;
+	for(i = 0; i < lsh->band_count; ++i)
+	{
+		band = &lsh->bands[i];
+		key = band_key(mh->values, i, lsh->rows);
+		for(entry = band->heads[(unsigned int)key & band->mask]; entry != NO_ENTRY; entry = band->next[entry])
+		{
+			if(band->keys[entry] == key && !push_ull(&found, &count, &capacity, band->ids[entry])) {
+				free(found);
+				return -1;
+			}
+		}
+	}
+	if(count == 0) return 0;
+
+	qsort(found, count, sizeof(unsigned long long), compare_ull);
+
+	*ids = (unsigned int*)malloc(count * sizeof(unsigned int));
+	if(*ids == NULL) {
+		free(found);
+		return -1;
+	}
+
+	unique = 0;
+	for(j = 0; j < count; ++j)
+		if(j == 0 || found[j] != found[j - 1]) (*ids)[unique++] = (unsigned int)found[j];
+
+	free(found);
+	return (int)unique;
+}
+
+/* finds every pair of sketches sharing a band */
+int lsh_candidate_pairs(const LSH_INDEX *lsh, LSH_PAIR **pairs)
+{
+	KEYED_ID *entries;
+	unsigned long long *found;
+	unsigned int i, j, k, first, last, count, capacity, unique, lo, hi;
+
+	if(pairs != NULL) *pairs = NULL;
+	if(lsh == NULL || pairs == NULL) return -1;
+	if(lsh->count < 2) return 0;
+
+	entries = (KEYED_ID*)malloc(lsh->count * sizeof(KEYED_ID));
+	if(entries == NULL) return -1;
+
+	/* sort each band by key; every two entries in a run of equal keys form a pair */
+	found = NULL;
+	count = capacity = 0;
+	for(i = 0; i < lsh->band_count; ++i)
+	{
+		for(j = 0; j < lsh->count; ++j)
+		{
+			entries[j].key = lsh->bands[i].keys[j];
+			entries[j].id = lsh->bands[i].ids[j];
+		}
+		qsort(entries, lsh->count, sizeof(KEYED_ID), compare_keyed);
+
+		for(first = 0; first < lsh->count; first = last)
+		{
+			for(last = first + 1; last < lsh->count && entries[last].key == entries[first].key; ++last);
+
+			for(j = first; j < last; ++j)
+			{
+				for(k = j + 1; k < last; ++k)
+				{
+					if(entries[j].id == entries[k].id) continue;
+
+					lo = (entries[j].id < entries[k].id ? entries[j].id : entries[k].id);
+					hi = (entries[j].id < entries[k].id ? entries[k].id : entries[j].id);
+					if(!push_ull(&found, &count, &capacity, ((unsigned long long)lo << 32) | hi)) {
+						free(found);
+						free(entries);
+						return -1;
+					}
+				}
+			}
+		}
+	}
+	free(entries);
+	if(count == 0) return 0;
+
+	qsort(found, count, sizeof(unsigned long long), compare_ull);
+
+	*pairs = (LSH_PAIR*)malloc(count * sizeof(LSH_PAIR));
+	if(*pairs == NULL) {
+		free(found);
+		return -1;
+	}
+
+	unique = 0;
+	for(j = 0; j < count; ++j)
+	{
+		if(j > 0 && found[j] == found[j - 1]) continue;
+
+		(*pairs)[unique].first = (unsigned int)(found[j] >> 32);
+		(*pairs)[unique].second = (unsigned int)found[j];
+		++unique;
+	}
+
+	free(found);
+	return (int)unique;
+}
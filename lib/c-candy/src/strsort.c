@@ -0,0 +1,261 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strsort.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <constants.h>
+#include <str.h>
+#include <list.h>
+#include <strsort.h>
+
+/* <------------------ private constant declarations -----------------> */
+#define KEY_BYTES					8
+#define INSERTION_SORT_THRESHOLD	16
+
+/* a string together with the next KEY_BYTES bytes of it, packed so that integer order is byte order */
+typedef struct {
+	unsigned long long key;
+	STRING *sobj;
+} SORT_ITEM;
+
+/* <------------------ private function declarations -----------------> */
+static unsigned char fold(unsigned char c, BOOL ignore_case);
+static unsigned long long make_key(const STRING *sobj, unsigned int depth, BOOL ignore_case);
+static int compare_from(const STRING *s1, const STRING *s2, unsigned int depth, BOOL ignore_case);
+static int compare_length(const void *p1, const void *p2);
+static void insertion_sort(SORT_ITEM *items, unsigned int n, unsigned int depth, BOOL ignore_case);
+static unsigned int next_key_level(SORT_ITEM *items, unsigned int n, unsigned int depth, BOOL ignore_case);
+static void multikey_quicksort(SORT_ITEM *items, unsigned int n, unsigned int depth, BOOL ignore_case);
+static BOOL sort_pointers(STRING **items, unsigned int count, BOOL reverse, BOOL ignore_case);
+
+/* <------------------ private function definitions ------------------> */
+
+/* maps ASCII lowercase to uppercase when ignoring case; bytes are compared unsigned */
+static unsigned char fold(unsigned char c, BOOL ignore_case)
+{
+	if(ignore_case && c >= 'a' && c <= 'z') return c - 32;
+	return c;
+}
+
+/* packs the bytes [depth, depth + KEY_BYTES) of a string big-endian, padding with zeroes */
+static unsigned long long make_key(const STRING *sobj, unsigned int depth, BOOL ignore_case)
+{
+	unsigned long long key;
+	unsigned int i, length;
+
+	length = (sobj == NULL ? 0 : sobj->length);
+
+	key = 0;
+	for(i = 0; i < KEY_BYTES; ++i)
+	{
+		key <<= 8;
+		if(depth + i < length) key |= fold((unsigned char)sobj->data[depth + i], ignore_case);
+	}
+	return key;
+}
+
+/* compares two strings from a given depth onwards, a proper prefix being the smaller */
+static int compare_from(const STRING *s1, const STRING *s2, unsigned int depth, BOOL ignore_case)
+{
+	unsigned int i, n1, n2;
+	unsigned char c1, c2;
+
+	n1 = (s1 == NULL ? 0 : s1->length);
+	n2 = (s2 == NULL ? 0 : s2->length);
+
+	for(i = depth; i < n1 && i < n2; ++i)
+	{
+		c1 = fold((unsigned char)s1->data[i], ignore_case);
+		c2 = fold((unsigned char)s2->data[i], ignore_case);
+		if(c1 != c2) return (c1 < c2 ? -1 : 1);
+	}
+
+	if(n1 == n2) return 0;
+	return (n1 < n2 ? -1 : 1);
+}
+
+/* orders sort items by the length of their strings */
+static int compare_length(const void *p1, const void *p2)
+{
+	const SORT_ITEM *a, *b;
+	unsigned int n1, n2;
+
+	a = (const SORT_ITEM*)p1;
+	b = (const SORT_ITEM*)p2;
+	n1 = (a->sobj == NULL ? 0 : a->sobj->length);
+	n2 = (b->sobj == NULL ? 0 : b->sobj->length);
+
+	if(n1 == n2) return 0;
+	return (n1 < n2 ? -1 : 1);
+}
+
+/* sorts a small range whose strings are known to agree on their first depth bytes */
+static void insertion_sort(SORT_ITEM *items, unsigned int n, unsigned int depth, BOOL ignore_case)
+{
+	SORT_ITEM temp;
+	unsigned int i, j;
+
+	for(i = 1; i < n; ++i)
+	{
+		temp = items[i];
+		for(j = i; j > 0; --j)
+		{
+			if(items[j - 1].key < temp.key) break;
+			if(items[j - 1].key == temp.key && compare_from(items[j - 1].sobj, temp.sobj, depth + KEY_BYTES, ignore_case) <= 0) break;
+			items[j] = items[j - 1];
+		}
+		items[j] = temp;
+	}
+}
+
+/*
+ * prepares a range whose strings all share the same key at the given depth for sorting at the next depth;
+ * returns the number of strings that are already in place at the front
+ */
+static unsigned int next_key_level(SORT_ITEM *items, unsigned int n, unsigned int depth, BOOL ignore_case)
+{
+	SORT_ITEM temp;
+	unsigned int i, finished, next_depth;
+
+	/*
+	 * strings that end within the key are equal up to their length, and precede the others; they are
+	 * moved to the front and ordered by length
+	 */
+	next_depth = depth + KEY_BYTES;
+	finished = 0;
+	for(i = 0; i < n; ++i)
+	{
+		if(items[i].sobj == NULL || items[i].sobj->length <= next_depth) {
+			temp = items[finished];
+			items[finished++] = items[i];
+			items[i] = temp;
+		}
+	}
+
+	if(finished > 1) qsort(items, finished, sizeof(SORT_ITEM), compare_length);
+
+	/* the rest are distinguished by their next KEY_BYTES bytes */
+	for(i = finished; i < n; ++i) items[i].key = make_key(items[i].sobj, next_depth, ignore_case);
+	return finished;
+}
+
+/* three-way radix quicksort on the cached keys; all strings in the range agree on their first depth bytes */
+static void multikey_quicksort(SORT_ITEM *items, unsigned int n, unsigned int depth, BOOL ignore_case)
+{
+	SORT_ITEM temp;
+	unsigned long long a, b, c, pivot;
+	unsigned int lt, gt, i, finished;
+
+	while(n > INSERTION_SORT_THRESHOLD)
+	{
+		/* median of three */
+		a = items[0].key;
+		b = items[n / 2].key;
+		c = items[n - 1].key;
+		if(a < b) pivot = (b < c ? b : (a < c ? c : a));
+		else pivot = (a < c ? a : (b < c ? c : b));
+
+		/* [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot */
+		lt = 0;
+		gt = n;
+		i = 0;
+		while(i < gt)
+		{
+			if(items[i].key < pivot) {
+				temp = items[lt]; items[lt] = items[i]; items[i] = temp;
+				++lt;
+				++i;
+			} else if(items[i].key > pivot) {
+				--gt;
+				temp = items[gt]; items[gt] = items[i]; items[i] = temp;
+			} else {
+				++i;
+			}
+		}
+
+		/*
+		 * recurse into the two smaller ranges and loop on the largest one, so every recursive call gets at most
+		 * half of the items and the stack depth stays logarithmic however long the shared prefixes are
+		 */
+		if(gt - lt >= lt && gt - lt >= n - gt) {
+			multikey_quicksort(items, lt, depth, ignore_case);
+			multikey_quicksort(items + gt, n - gt, depth, ignore_case);
+
+			finished = next_key_level(items + lt, gt - lt, depth, ignore_case);
+			items += lt + finished;
+			n = gt - lt - finished;
+			depth += KEY_BYTES;
+		} else if(lt >= n - gt) {
+			finished = next_key_level(items + lt, gt - lt, depth, ignore_case);
+			multikey_quicksort(items + lt + finished, gt - lt - finished, depth + KEY_BYTES, ignore_case);
+			multikey_quicksort(items + gt, n - gt, depth, ignore_case);
+			n = lt;
+		} else {
+			multikey_quicksort(items, lt, depth, ignore_case);
+			finished = next_key_level(items + lt, gt - lt, depth, ignore_case);
+			multikey_quicksort(items + lt + finished, gt - lt - finished, depth + KEY_BYTES, ignore_case);
+			items += gt;
+			n -= gt;
+		}
+	}
+
+	insertion_sort(items, n, depth, ignore_case);
+}
+
+/* sorts an array of string pointers through a temporary array of keyed items */
+static BOOL sort_pointers(STRING **items, unsigned int count, BOOL reverse, BOOL ignore_case)
+{
+	SORT_ITEM *keyed;
+	unsigned int i;
+
+	if(items == NULL) return FALSE;
+	if(count < 2) return TRUE;
+
+	keyed = (SORT_ITEM*)malloc(count * sizeof(SORT_ITEM));
+	if(keyed == NULL) return FALSE;
+
+	for(i = 0; i < count; ++i)
+	{
+		keyed[i].sobj = items[i];
+		keyed[i].key = make_key(items[i], 0, ignore_case);
+	}
+
+	multikey_quicksort(keyed, count, 0, ignore_case);
+
+	for(i = 0; i < count; ++i) items[reverse ? count - 1 - i : i] = keyed[i].sobj;
+
+	free(keyed);
+	return TRUE;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* sorts an array of strings in-place */
+BOOL str_sort(STRING **items, unsigned int count, BOOL reverse, BOOL ignore_case)
+{
+	return sort_pointers(items, count, reverse, ignore_case);
+}
+
+/* sorts a list of strings in-place */
+BOOL str_sort_list(LIST *list, BOOL reverse, BOOL ignore_case)
+{
+	if(list == NULL || list->type != TYPE_OBJECT) return FALSE;
+	return sort_pointers((STRING**)list->data, list->length, reverse, ignore_case);
+}
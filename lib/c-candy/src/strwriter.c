@@ -0,0 +1,185 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * c-candy/src/strwriter.c
+ *
+ * (C) Copyright 2021 Akash Nag
+ *
+ * This program is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; version 2.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program; if not, write to the Free Software Foundation, Inc., 51 Franklin Street,
+ * Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/uio.h>
+#include <constants.h>
+#include <str.h>
+#include <strwriter.h>
+
+/* <------------------ private function declarations -----------------> */
+static BOOL queue(STR_WRITER *sw, const char *data, size_t length);
+
+/* <------------------ private function definitions ------------------> */
+
+/* adds a range of characters to the pending iovec array, copying it if it is small */
+static BOOL queue(STR_WRITER *sw, const char *data, size_t length)
+{
+	struct iovec *last;
+
+	if(length == 0) return TRUE;
+	if(sw->iov_count == STRW_MAX_IOV && !strw_flush(sw)) return FALSE;
+
+	if(length < sw->copy_threshold) {
+		if(sw->used + length > sw->capacity && !strw_flush(sw)) return FALSE;
+
+		memcpy(sw->buffer + sw->used, data, length);
+		data = sw->buffer + sw->used;
+		sw->used += length;
+	}
+
+	/* ranges that continue the previous one (consecutive copies, or adjacent slices of one buffer) share its entry */
+	last = (sw->iov_count > 0 ? &sw->iov[sw->iov_count - 1] : NULL);
+	if(last != NULL && (const char*)last->iov_base + last->iov_len == data) {
+		last->iov_len += length;
+		return TRUE;
+	}
+
+	sw->iov[sw->iov_count].iov_base = (void*)data;
+	sw->iov[sw->iov_count].iov_len = length;
+	++sw->iov_count;
+	return TRUE;
+}
+
+/* <------------------ public function definitions ------------------> */
+
+/* flushes the writer and frees memory allocated for it */
+void strw_dump(STR_WRITER *sw)
+{
+	if(sw == NULL) return;
+
+	strw_flush(sw);
+	free(sw->iov);
+	free(sw->buffer);
+	free(sw);
+}
+
+/* creates a writer over an open file descriptor */
+STR_WRITER* str_writer(int fd, size_t buffer_size)
+{
+	STR_WRITER *sw;
+
+	if(fd < 0) return NULL;
+
+	sw = (STR_WRITER*)malloc(sizeof(STR_WRITER));
+	if(sw == NULL) return NULL;
+
+	sw->iov = (struct iovec*)malloc(STRW_MAX_IOV * sizeof(struct iovec));
+	sw->buffer = (buffer_size > 0 ? (char*)malloc(buffer_size) : NULL);
+	if(sw->iov == NULL || (buffer_size > 0 && sw->buffer == NULL)) {
+		free(sw->iov);
+		free(sw->buffer);
+		free(sw);
+		return NULL;
+	}
+
+	sw->fd = fd;
+	sw->iov_count = 0;
+	sw->capacity = buffer_size;
+	sw->used = 0;
+	sw->copy_threshold = (buffer_size < STRW_COPY_THRESHOLD ? buffer_size : STRW_COPY_THRESHOLD);
+	sw->bytes_written = 0;
+	sw->syscalls = 0;
+	sw->error = FALSE;
+	return sw;
+}
+
+/* queues a string for writing */
+BOOL strw_write(STR_WRITER *sw, const STRING *sobj)
+{
+	if(sw == NULL || sobj == NULL) return FALSE;
+	return queue(sw, sobj->data, sobj->length);
+}
+
+/* queues a string view for writing */
+BOOL strw_write_view(STR_WRITER *sw, STRING_VIEW view)
+{
+	if(sw == NULL || (view.data == NULL && view.length > 0)) return FALSE;
+	return queue(sw, view.data, view.length);
+}
+
+/* queues a range of characters for writing */
+BOOL strw_write_chars(STR_WRITER *sw, const char *data, size_t length)
+{
+	if(sw == NULL || (data == NULL && length > 0)) return FALSE;
+	return queue(sw, data, length);
+}
+
+/* queues several strings for writing */
+BOOL strw_write_all(STR_WRITER *sw, const STRING **items, unsigned int count, const STRING *terminator)
+{
+	unsigned int i;
+
+	if(sw == NULL || (items == NULL && count > 0)) return FALSE;
+
+	for(i = 0; i < count; ++i)
+	{
+		if(items[i] == NULL) continue;
+
+		if(!queue(sw, items[i]->data, items[i]->length)) return FALSE;
+		if(terminator != NULL && !queue(sw, terminator->data, terminator->length)) return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* writes out everything queued */
+BOOL strw_flush(STR_WRITER *sw)
+{
+	struct iovec *iov;
+	unsigned int count;
+	ssize_t n;
+
+	if(sw == NULL) return FALSE;
+
+	iov = sw->iov;
+	count = sw->iov_count;
+	while(count > 0)
+	{
+		n = writev(sw->fd, iov, count);
+		++sw->syscalls;
+		if(n < 0) {
+			if(errno == EINTR) continue;
+
+			sw->error = TRUE;
+			break;
+		}
+		sw->bytes_written += n;
+
+		/* skip what was written; a partially written entry is resumed from where it stopped */
+		while(count > 0 && (size_t)n >= iov->iov_len)
+		{
+			n -= iov->iov_len;
+			++iov;
+			--count;
+		}
+		if(count > 0) {
+			iov->iov_base = (char*)iov->iov_base + n;
+			iov->iov_len -= n;
+		}
+	}
+
+	sw->iov_count = 0;
+	sw->used = 0;
+	return (count == 0 ? TRUE : FALSE);
+}
@@ -95,9 +95,9 @@ int tuple_length(const TUPLE *tuple)
 /* returns the data type of the item at the specified index */
 ITEM_TYPE tuple_type_at(const TUPLE *tuple, int index)
 {
-	if(tuple == NULL) return NULL;
+	if(tuple == NULL) return -1;
 	if(index < 0) index += tuple->length;
-	if(index < 0 || index >= tuple->length) return NULL;
+	if(index < 0 || index >= tuple->length) return -1;
 
 	return tuple->types[index];
 }